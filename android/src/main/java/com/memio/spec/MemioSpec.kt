@@ -9,5 +9,7 @@ object MemioSpec {
     const val MAGIC_OFFSET: Int = 0
     const val VERSION_OFFSET: Int = 8
     const val LENGTH_OFFSET: Int = 16
+    const val ACK_OFFSET: Int = 32
+    const val SEQ_OFFSET: Int = 40
     const val ENDIANNESS: String = "little"
 }
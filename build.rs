@@ -8,6 +8,12 @@ fn main() {
         "has_shared_buffer",
         "memio_upload",
         "memio_read",
+        "memio_stream",
+        "memio_rpc_open",
+        "memio_rpc_batch",
+        "memio_read_many",
+        "memio_info_many",
+        "memio_broadcast_open",
     ])
     .android_path("android")
     .build();
@@ -1,6 +1,6 @@
 //! Benchmark for serialization.
 
-use criterion::{Criterion, criterion_group, criterion_main};
+use criterion::{BenchmarkId, Criterion, Throughput, black_box, criterion_group, criterion_main};
 use memio_core::MemioState;
 use rkyv::{Archive, Deserialize, Serialize};
 
@@ -27,5 +27,38 @@ fn benchmark_serialization(c: &mut Criterion) {
     });
 }
 
-criterion_group!(benches, benchmark_serialization);
+/// A 10^6-element state: the 8 MB region write of each publish. The state
+/// is archived once up front, so only the copy into the payload is timed.
+///
+/// With `--features parallel` the copy runs on 1/4/8/16 threads; without it
+/// this is the single-threaded baseline.
+fn benchmark_large_state(c: &mut Criterion) {
+    let data = TestData {
+        id: 1,
+        name: "large".to_string(),
+        values: (0..1_000_000).map(|i| i as f64).collect(),
+    };
+    let archive = MemioState::new(data).to_bytes().unwrap();
+    // Touch every page so the first iterations don't pay for page faults
+    let mut payload = vec![1u8; archive.len()];
+
+    let mut group = c.benchmark_group("write large state");
+    group.throughput(Throughput::Bytes(archive.len() as u64));
+
+    #[cfg(feature = "parallel")]
+    for threads in [1, 4, 8, 16] {
+        memio_core::parallel::set_threads(threads);
+        group.bench_with_input(BenchmarkId::new("threads", threads), &threads, |b, _| {
+            b.iter(|| memio_core::parallel::copy(&mut payload, black_box(&archive)));
+        });
+    }
+    #[cfg(not(feature = "parallel"))]
+    group.bench_with_input(BenchmarkId::new("threads", 1), &1, |b, _| {
+        b.iter(|| payload.copy_from_slice(black_box(&archive)));
+    });
+
+    group.finish();
+}
+
+criterion_group!(benches, benchmark_serialization, benchmark_large_state);
 criterion_main!(benches);
@@ -45,6 +45,9 @@ fn main() {
     let magic_offset = spec["offsets"]["magic"].as_u64().unwrap_or(0);
     let version_offset = spec["offsets"]["version"].as_u64().unwrap_or(8);
     let length_offset = spec["offsets"]["length"].as_u64().unwrap_or(16);
+    let history_offset = spec["offsets"]["history"].as_u64().unwrap_or(24);
+    let ack_offset = spec["offsets"]["ack"].as_u64().unwrap_or(32);
+    let seq_offset = spec["offsets"]["seq"].as_u64().unwrap_or(40);
     let endianness = spec["endianness"].as_str().unwrap_or("little");
 
     // Generate Rust code
@@ -67,6 +70,15 @@ pub const SHARED_STATE_VERSION_OFFSET: usize = {version_offset};
 /// Byte offset of the length field within the header
 pub const SHARED_STATE_LENGTH_OFFSET: usize = {length_offset};
 
+/// Byte offset of the history area offset (0 when history mode is off)
+pub const SHARED_STATE_HISTORY_OFFSET: usize = {history_offset};
+
+/// Byte offset of the reader ack word (highest version a reader consumed)
+pub const SHARED_STATE_ACK_OFFSET: usize = {ack_offset};
+
+/// Byte offset of the writer sequence word (odd while a write is in progress)
+pub const SHARED_STATE_SEQ_OFFSET: usize = {seq_offset};
+
 /// Endianness of multi-byte fields
 pub const SHARED_STATE_ENDIANNESS: &str = "{endianness}";
 "#
@@ -0,0 +1,173 @@
+//! Byte-level delta encoding between consecutive versions.
+//!
+//! A delta describes the next version as a list of copy operations against
+//! the previous one: skip `n` unchanged bytes, then replace `m` bytes with
+//! literals. Runs are LEB128 varints, so a version that changed a few
+//! fields of a large buffer encodes to a handful of bytes.
+//!
+//! Format: `varint(new_len)` followed by `(varint(skip), varint(len), bytes)`
+//! triples until the end of the buffer.
+
+use crate::{MemioError, MemioResult};
+
+/// Unchanged runs shorter than this are folded into the surrounding literal,
+/// since a new op costs at least two varint bytes.
+const MIN_SKIP: usize = 8;
+
+/// Encodes `next` as a delta against `prev`, appending to `out`.
+///
+/// Returns the number of bytes appended.
+pub fn encode(prev: &[u8], next: &[u8], out: &mut Vec<u8>) -> usize {
+    let start = out.len();
+    write_varint(out, next.len() as u64);
+
+    let common = prev.len().min(next.len());
+    let mut pos = 0;
+    while pos < next.len() {
+        // Unchanged run.
+        let skip_start = pos;
+        while pos < common && prev[pos] == next[pos] {
+            pos += 1;
+        }
+        if pos == next.len() {
+            break;
+        }
+
+        // Changed run, extended across short unchanged gaps.
+        let lit_start = pos;
+        let mut lit_end = pos;
+        while lit_end < next.len() {
+            if lit_end >= common || prev[lit_end] != next[lit_end] {
+                lit_end += 1;
+                continue;
+            }
+            let gap = prev[lit_end..common]
+                .iter()
+                .zip(&next[lit_end..common])
+                .take(MIN_SKIP)
+                .take_while(|(a, b)| a == b)
+                .count();
+            if gap >= MIN_SKIP || lit_end + gap == next.len() {
+                break;
+            }
+            lit_end += gap;
+        }
+
+        write_varint(out, (lit_start - skip_start) as u64);
+        write_varint(out, (lit_end - lit_start) as u64);
+        out.extend_from_slice(&next[lit_start..lit_end]);
+        pos = lit_end;
+    }
+
+    out.len() - start
+}
+
+/// Rebuilds the next version from `prev` and a delta produced by [`encode`].
+///
+/// Bytes past the end of `prev` are always literals, so a delta whose
+/// length exceeds `prev.len() + delta.len()` is rejected before anything is
+/// allocated for it.
+pub fn decode(prev: &[u8], delta: &[u8], out: &mut Vec<u8>) -> MemioResult<()> {
+    let out_of_range = || MemioError::Deserialization("Delta op out of range.".to_string());
+    let mut cursor = 0;
+    let new_len = usize::try_from(read_varint(delta, &mut cursor)?)
+        .ok()
+        .filter(|&len| len <= prev.len().saturating_add(delta.len()))
+        .ok_or_else(out_of_range)?;
+
+    out.clear();
+    out.reserve(new_len);
+    let keep = prev.len().min(new_len);
+    out.extend_from_slice(&prev[..keep]);
+    out.resize(new_len, 0);
+
+    let mut pos = 0usize;
+    while cursor < delta.len() {
+        let skip = read_varint(delta, &mut cursor)? as usize;
+        let len = read_varint(delta, &mut cursor)? as usize;
+        let end = pos
+            .checked_add(skip)
+            .and_then(|p| p.checked_add(len))
+            .filter(|&end| end <= new_len);
+        let lit_end = cursor.checked_add(len).filter(|&end| end <= delta.len());
+        let (Some(end), Some(lit_end)) = (end, lit_end) else {
+            return Err(out_of_range());
+        };
+        out[end - len..end].copy_from_slice(&delta[cursor..lit_end]);
+        cursor = lit_end;
+        pos = end;
+    }
+    Ok(())
+}
+
+fn write_varint(out: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        out.push((value as u8) | 0x80);
+        value >>= 7;
+    }
+    out.push(value as u8);
+}
+
+fn read_varint(buf: &[u8], cursor: &mut usize) -> MemioResult<u64> {
+    let mut value = 0u64;
+    let mut shift = 0;
+    loop {
+        let byte = *buf
+            .get(*cursor)
+            .ok_or_else(|| MemioError::Deserialization("Truncated delta.".to_string()))?;
+        *cursor += 1;
+        value |= ((byte & 0x7f) as u64) << shift;
+        if byte & 0x80 == 0 {
+            return Ok(value);
+        }
+        shift += 7;
+        if shift >= 64 {
+            return Err(MemioError::Deserialization(
+                "Delta varint overflow.".to_string(),
+            ));
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn roundtrip(prev: &[u8], next: &[u8]) -> usize {
+        let mut delta = Vec::new();
+        let n = encode(prev, next, &mut delta);
+        let mut out = Vec::new();
+        decode(prev, &delta, &mut out).unwrap();
+        assert_eq!(out, next);
+        n
+    }
+
+    #[test]
+    fn test_small_change_is_small() {
+        let prev = vec![7u8; 64 * 1024];
+        let mut next = prev.clone();
+        next[1000] = 1;
+        next[40_000..40_004].copy_from_slice(&[1, 2, 3, 4]);
+        assert!(roundtrip(&prev, &next) < 32);
+    }
+
+    #[test]
+    fn test_length_changes() {
+        roundtrip(b"hello world", b"hello");
+        roundtrip(b"hello", b"hello world, longer");
+        roundtrip(b"", b"fresh");
+        roundtrip(b"same", b"same");
+    }
+
+    #[test]
+    fn test_rejects_corrupt_delta() {
+        let mut out = Vec::new();
+        assert!(decode(b"abc", &[3, 5, 1, 0], &mut out).is_err());
+        assert!(decode(b"abc", &[0x80], &mut out).is_err());
+        // Lengths no delta of this size can produce, and ops whose end overflows
+        assert!(decode(b"abc", &[0xff, 0xff, 0xff, 0xff, 0x0f], &mut out).is_err());
+        let mut huge = vec![3, 1];
+        write_varint(&mut huge, u64::MAX);
+        assert!(decode(b"abc", &huge, &mut out).is_err());
+    }
+}
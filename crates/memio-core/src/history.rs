@@ -0,0 +1,494 @@
+//! Version history ring stored next to a region payload.
+//!
+//! A region in history mode keeps the last N published versions in fixed
+//! slots after the payload, so readers that fall behind (slow WebViews, a
+//! recorder process) can still fetch version V while it is resident.
+//!
+//! Slots hold either a keyframe (raw bytes) or a [`delta`](crate::delta)
+//! against the previous slot. A keyframe is forced every
+//! `keyframe_interval` entries so a reader never needs more than that many
+//! slots to rebuild a version.
+//!
+//! Layout of the history area (offset stored at
+//! `SHARED_STATE_HISTORY_OFFSET` in the region header):
+//!
+//! ```text
+//! [index: 64 bytes][entries: slots * 64 bytes][slot data: slots * slot_capacity]
+//! ```
+//!
+//! Each entry carries a seqlock counter that is odd while the writer is
+//! filling its slot, so cross-process readers can detect torn reads.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use crate::delta;
+use crate::{MemioError, MemioResult};
+
+/// Size of the history index block.
+pub const HISTORY_INDEX_SIZE: usize = 64;
+/// Size of one history entry.
+pub const HISTORY_ENTRY_SIZE: usize = 64;
+
+const INDEX_SLOTS_OFFSET: usize = 0;
+const INDEX_SLOT_CAPACITY_OFFSET: usize = 8;
+const INDEX_HEAD_OFFSET: usize = 16;
+const INDEX_KEYFRAME_INTERVAL_OFFSET: usize = 24;
+
+const ENTRY_SEQ_OFFSET: usize = 0;
+const ENTRY_VERSION_OFFSET: usize = 8;
+const ENTRY_BASE_VERSION_OFFSET: usize = 16;
+const ENTRY_LENGTH_OFFSET: usize = 24;
+const ENTRY_ENCODED_LENGTH_OFFSET: usize = 32;
+const ENTRY_KIND_OFFSET: usize = 40;
+const ENTRY_ORDINAL_OFFSET: usize = 48;
+
+const KIND_EMPTY: u64 = 0;
+const KIND_KEYFRAME: u64 = 1;
+const KIND_DELTA: u64 = 2;
+
+/// History mode settings for a region.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct HistoryConfig {
+    /// Number of versions kept resident.
+    pub slots: usize,
+    /// A raw keyframe is stored at least every this many versions.
+    pub keyframe_interval: usize,
+}
+
+impl HistoryConfig {
+    /// Keeps `slots` versions, with a keyframe every `slots / 2` entries.
+    ///
+    /// A delta is only readable while its keyframe is still resident, so
+    /// this interval keeps at least the newest half of the ring decodable.
+    pub fn new(slots: usize) -> Self {
+        Self {
+            slots,
+            keyframe_interval: (slots / 2).max(1),
+        }
+    }
+
+    /// Sets the keyframe interval (clamped to `1..=slots`).
+    pub fn with_keyframe_interval(mut self, interval: usize) -> Self {
+        self.keyframe_interval = interval;
+        self
+    }
+
+    fn interval(&self) -> usize {
+        self.keyframe_interval.clamp(1, self.slots.max(1))
+    }
+
+    /// Returns the bytes needed for the history area of a region whose
+    /// slots hold up to `slot_capacity` bytes each.
+    pub fn area_size(&self, slot_capacity: usize) -> usize {
+        HISTORY_INDEX_SIZE + self.slots * (HISTORY_ENTRY_SIZE + slot_capacity)
+    }
+}
+
+/// Metadata of one resident version.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct HistoryEntry {
+    /// Version number published by the writer.
+    pub version: u64,
+    /// Version this entry is a delta against (ignored for keyframes).
+    pub base_version: u64,
+    /// Decoded payload length.
+    pub length: usize,
+    /// Bytes stored in the slot.
+    pub encoded_length: usize,
+    /// True if the slot holds raw bytes.
+    pub keyframe: bool,
+    /// Position in the stream of all versions pushed to this ring.
+    pub ordinal: u64,
+}
+
+/// Read access to a history area (any mapping of the region file).
+#[derive(Debug, Clone, Copy)]
+pub struct HistoryRing<'a> {
+    buf: &'a [u8],
+}
+
+/// Write access to a history area. Only the region owner should push.
+#[derive(Debug)]
+pub struct HistoryRingMut<'a> {
+    buf: &'a mut [u8],
+}
+
+/// Initializes an empty history area in `buf`.
+pub fn init_history(
+    buf: &mut [u8],
+    config: &HistoryConfig,
+    slot_capacity: usize,
+) -> MemioResult<()> {
+    if config.slots == 0 {
+        return Err(MemioError::InvalidCapacity);
+    }
+    if buf.len() < config.area_size(slot_capacity) {
+        return Err(MemioError::Internal("History area too small.".to_string()));
+    }
+    buf[..HISTORY_INDEX_SIZE + config.slots * HISTORY_ENTRY_SIZE].fill(0);
+    put(buf, INDEX_SLOTS_OFFSET, config.slots as u64);
+    put(buf, INDEX_SLOT_CAPACITY_OFFSET, slot_capacity as u64);
+    put(
+        buf,
+        INDEX_KEYFRAME_INTERVAL_OFFSET,
+        config.interval() as u64,
+    );
+    put(buf, INDEX_HEAD_OFFSET, 0);
+    Ok(())
+}
+
+impl<'a> HistoryRing<'a> {
+    /// Wraps an initialized history area.
+    pub fn new(buf: &'a [u8]) -> MemioResult<Self> {
+        if buf.len() < HISTORY_INDEX_SIZE {
+            return Err(MemioError::InvalidHeader);
+        }
+        let ring = Self { buf };
+        let slots = ring.slots();
+        if slots == 0 || buf.len() < ring.data_offset() + slots * ring.slot_capacity() {
+            return Err(MemioError::InvalidHeader);
+        }
+        Ok(ring)
+    }
+
+    /// Number of slots in the ring.
+    pub fn slots(&self) -> usize {
+        get(self.buf, INDEX_SLOTS_OFFSET) as usize
+    }
+
+    /// Maximum encoded bytes per slot.
+    pub fn slot_capacity(&self) -> usize {
+        get(self.buf, INDEX_SLOT_CAPACITY_OFFSET) as usize
+    }
+
+    /// Total number of versions ever pushed.
+    pub fn head(&self) -> u64 {
+        atomic(self.buf, INDEX_HEAD_OFFSET).load(Ordering::Acquire)
+    }
+
+    fn data_offset(&self) -> usize {
+        HISTORY_INDEX_SIZE + self.slots() * HISTORY_ENTRY_SIZE
+    }
+
+    fn entry_offset(&self, slot: usize) -> usize {
+        HISTORY_INDEX_SIZE + slot * HISTORY_ENTRY_SIZE
+    }
+
+    /// Reads one slot, copying its bytes into `out` if requested.
+    ///
+    /// Returns `None` for empty slots or if the writer was mid-update.
+    fn load(&self, slot: usize, out: Option<&mut Vec<u8>>) -> Option<HistoryEntry> {
+        let e = self.entry_offset(slot);
+        let seq = atomic(self.buf, e + ENTRY_SEQ_OFFSET).load(Ordering::Acquire);
+        if seq & 1 == 1 {
+            return None;
+        }
+
+        let kind = get(self.buf, e + ENTRY_KIND_OFFSET);
+        let entry = HistoryEntry {
+            version: get(self.buf, e + ENTRY_VERSION_OFFSET),
+            base_version: get(self.buf, e + ENTRY_BASE_VERSION_OFFSET),
+            length: get(self.buf, e + ENTRY_LENGTH_OFFSET) as usize,
+            encoded_length: get(self.buf, e + ENTRY_ENCODED_LENGTH_OFFSET) as usize,
+            keyframe: kind == KIND_KEYFRAME,
+            ordinal: get(self.buf, e + ENTRY_ORDINAL_OFFSET),
+        };
+        if kind == KIND_EMPTY || entry.encoded_length > self.slot_capacity() {
+            return None;
+        }
+
+        if let Some(out) = out {
+            let start = self.data_offset() + slot * self.slot_capacity();
+            out.clear();
+            out.extend_from_slice(&self.buf[start..start + entry.encoded_length]);
+        }
+
+        std::sync::atomic::fence(Ordering::Acquire);
+        let after = atomic(self.buf, e + ENTRY_SEQ_OFFSET).load(Ordering::Relaxed);
+        (after == seq).then_some(entry)
+    }
+
+    /// Lists resident entries, oldest first.
+    pub fn entries(&self) -> Vec<HistoryEntry> {
+        let mut entries: Vec<HistoryEntry> = (0..self.slots())
+            .filter_map(|s| self.load(s, None))
+            .collect();
+        entries.sort_by_key(|e| e.ordinal);
+        entries
+    }
+
+    /// Lists versions that can still be rebuilt with [`read`](Self::read),
+    /// oldest first.
+    pub fn versions(&self) -> Vec<u64> {
+        (0..self.slots())
+            .filter_map(|s| self.load(s, None).map(|e| (s, e)))
+            .filter(|(s, _)| self.chain(*s).is_some())
+            .map(|(_, e)| (e.ordinal, e.version))
+            .collect::<std::collections::BTreeMap<u64, u64>>()
+            .into_iter()
+            .map(|(_, version)| version)
+            .collect()
+    }
+
+    /// Returns the slots needed to rebuild the version in `slot`, newest
+    /// first and ending with a keyframe, or `None` if the chain is broken.
+    fn chain(&self, slot: usize) -> Option<Vec<usize>> {
+        let slots = self.slots() as u64;
+        let mut chain = vec![slot];
+        let mut entry = self.load(slot, None)?;
+        while !entry.keyframe {
+            if entry.ordinal == 0 || chain.len() as u64 >= slots {
+                return None;
+            }
+            let prev_slot = ((entry.ordinal - 1) % slots) as usize;
+            let prev = self.load(prev_slot, None)?;
+            if prev.ordinal != entry.ordinal - 1 || prev.version != entry.base_version {
+                return None;
+            }
+            chain.push(prev_slot);
+            entry = prev;
+        }
+        Some(chain)
+    }
+
+    fn find(&self, version: u64) -> Option<usize> {
+        (0..self.slots())
+            .filter_map(|s| self.load(s, None).map(|e| (s, e)))
+            .filter(|(_, e)| e.version == version)
+            .max_by_key(|(_, e)| e.ordinal)
+            .map(|(s, _)| s)
+    }
+
+    /// Returns the stored (possibly delta-encoded) bytes of `version`.
+    ///
+    /// Recorders use this to capture every version without decoding.
+    pub fn read_encoded(&self, version: u64) -> Option<(HistoryEntry, Vec<u8>)> {
+        let slot = self.find(version)?;
+        let mut bytes = Vec::new();
+        let entry = self.load(slot, Some(&mut bytes))?;
+        (entry.version == version).then_some((entry, bytes))
+    }
+
+    /// Rebuilds the payload of `version` if it is still resident.
+    pub fn read(&self, version: u64) -> MemioResult<Vec<u8>> {
+        let not_found = || MemioError::NotFound(format!("version {}", version));
+        let slot = self.find(version).ok_or_else(not_found)?;
+        let mut chain = self.chain(slot).ok_or_else(not_found)?;
+
+        // Replay deltas forward from the keyframe, re-checking each slot so
+        // a concurrent overwrite surfaces as NotFound instead of garbage.
+        let mut current = Vec::new();
+        let mut next = Vec::new();
+        let mut encoded = Vec::new();
+        let mut expected = None;
+        while let Some(s) = chain.pop() {
+            let entry = self.load(s, Some(&mut encoded)).ok_or_else(not_found)?;
+            if expected.is_some_and(|base| base != entry.base_version) {
+                return Err(not_found());
+            }
+            if entry.keyframe {
+                std::mem::swap(&mut current, &mut encoded);
+            } else {
+                delta::decode(&current, &encoded, &mut next)?;
+                std::mem::swap(&mut current, &mut next);
+            }
+            expected = Some(entry.version);
+        }
+        Ok(current)
+    }
+}
+
+impl<'a> HistoryRingMut<'a> {
+    /// Wraps an initialized history area for writing.
+    pub fn new(buf: &'a mut [u8]) -> MemioResult<Self> {
+        HistoryRing::new(buf)?;
+        Ok(Self { buf })
+    }
+
+    /// Returns a read view of the same ring.
+    pub fn as_ring(&self) -> HistoryRing<'_> {
+        HistoryRing { buf: self.buf }
+    }
+
+    /// Appends `version`, delta-encoded against `prev` when worthwhile.
+    ///
+    /// `prev` must be the payload of `base_version` (normally the version
+    /// being replaced). `scratch` is reused between calls to avoid
+    /// allocating per push.
+    pub fn push(
+        &mut self,
+        version: u64,
+        base_version: u64,
+        prev: &[u8],
+        next: &[u8],
+        scratch: &mut Vec<u8>,
+    ) -> MemioResult<HistoryEntry> {
+        let ring = self.as_ring();
+        let slots = ring.slots();
+        let slot_capacity = ring.slot_capacity();
+        if next.len() > slot_capacity {
+            return Err(MemioError::DataTooLarge {
+                data_len: next.len(),
+                capacity: slot_capacity,
+            });
+        }
+
+        let ordinal = ring.head();
+        let interval = get(self.buf, INDEX_KEYFRAME_INTERVAL_OFFSET).max(1);
+        let prev_resident = ordinal > 0
+            && ring
+                .load(((ordinal - 1) % slots as u64) as usize, None)
+                .is_some_and(|p| p.version == base_version);
+
+        let mut keyframe = ordinal % interval == 0 || !prev_resident;
+        if !keyframe {
+            scratch.clear();
+            delta::encode(prev, next, scratch);
+            keyframe = scratch.len() >= next.len();
+        }
+        let stored: &[u8] = if keyframe { next } else { scratch };
+
+        let slot = (ordinal % slots as u64) as usize;
+        let e = ring.entry_offset(slot);
+        let data = ring.data_offset() + slot * slot_capacity;
+
+        let seq = atomic(self.buf, e + ENTRY_SEQ_OFFSET);
+        let start = seq.load(Ordering::Relaxed);
+        seq.store(start | 1, Ordering::Relaxed);
+        std::sync::atomic::fence(Ordering::Release);
+
+        self.buf[data..data + stored.len()].copy_from_slice(stored);
+        put(self.buf, e + ENTRY_VERSION_OFFSET, version);
+        put(self.buf, e + ENTRY_BASE_VERSION_OFFSET, base_version);
+        put(self.buf, e + ENTRY_LENGTH_OFFSET, next.len() as u64);
+        put(
+            self.buf,
+            e + ENTRY_ENCODED_LENGTH_OFFSET,
+            stored.len() as u64,
+        );
+        let kind = if keyframe { KIND_KEYFRAME } else { KIND_DELTA };
+        put(self.buf, e + ENTRY_KIND_OFFSET, kind);
+        put(self.buf, e + ENTRY_ORDINAL_OFFSET, ordinal);
+
+        atomic(self.buf, e + ENTRY_SEQ_OFFSET).store((start | 1) + 1, Ordering::Release);
+        atomic(self.buf, INDEX_HEAD_OFFSET).store(ordinal + 1, Ordering::Release);
+
+        Ok(HistoryEntry {
+            version,
+            base_version,
+            length: next.len(),
+            encoded_length: stored.len(),
+            keyframe,
+            ordinal,
+        })
+    }
+}
+
+fn get(buf: &[u8], offset: usize) -> u64 {
+    crate::read_u64_le(buf, offset)
+}
+
+fn put(buf: &mut [u8], offset: usize, value: u64) {
+    crate::write_u64_le(buf, offset, value);
+}
+
+fn atomic(buf: &[u8], offset: usize) -> &AtomicU64 {
+    assert!(offset + 8 <= buf.len());
+    let ptr = buf[offset..].as_ptr() as *mut u64;
+    assert_eq!(
+        ptr as usize % 8,
+        0,
+        "history counters must be 8-byte aligned"
+    );
+    // SAFETY: in bounds and aligned (checked above); the area lives in a
+    // shared mapping where these words are only accessed atomically.
+    unsafe { AtomicU64::from_ptr(ptr) }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Heap buffer with the 8-byte alignment a mapping would give us.
+    fn area(config: &HistoryConfig, cap: usize) -> Vec<u64> {
+        vec![0u64; config.area_size(cap).div_ceil(8)]
+    }
+
+    fn bytes(v: &mut [u64]) -> &mut [u8] {
+        unsafe { std::slice::from_raw_parts_mut(v.as_mut_ptr() as *mut u8, v.len() * 8) }
+    }
+
+    #[test]
+    fn test_history_keeps_last_n_versions() {
+        let config = HistoryConfig::new(4);
+        let mut storage = area(&config, 1024);
+        let buf = bytes(&mut storage);
+        init_history(buf, &config, 1024).unwrap();
+
+        let mut ring = HistoryRingMut::new(buf).unwrap();
+        let mut scratch = Vec::new();
+        let mut prev = Vec::new();
+        for version in 1..=6u64 {
+            let mut next = vec![0u8; 512];
+            next[version as usize] = version as u8;
+            ring.push(version, version - 1, &prev, &next, &mut scratch)
+                .unwrap();
+            prev = next;
+        }
+
+        let view = ring.as_ring();
+        assert_eq!(view.versions(), vec![3, 4, 5, 6]);
+        assert!(view.read(2).is_err());
+        for version in 3..=6u64 {
+            let data = view.read(version).unwrap();
+            assert_eq!(data.len(), 512);
+            assert_eq!(data[version as usize], version as u8);
+        }
+    }
+
+    #[test]
+    fn test_deltas_are_used_between_keyframes() {
+        let config = HistoryConfig::new(8).with_keyframe_interval(4);
+        assert_eq!(HistoryConfig::new(8).keyframe_interval, 4);
+        let mut storage = area(&config, 4096);
+        let buf = bytes(&mut storage);
+        init_history(buf, &config, 4096).unwrap();
+
+        let mut ring = HistoryRingMut::new(buf).unwrap();
+        let mut scratch = Vec::new();
+        let mut prev = Vec::new();
+        let mut entries = Vec::new();
+        for version in 1..=5u64 {
+            let mut next = vec![9u8; 4096];
+            next[100] = version as u8;
+            entries.push(
+                ring.push(version, version - 1, &prev, &next, &mut scratch)
+                    .unwrap(),
+            );
+            prev = next;
+        }
+
+        let kinds: Vec<bool> = entries.iter().map(|e| e.keyframe).collect();
+        assert_eq!(kinds, vec![true, false, false, false, true]);
+        assert!(entries[1].encoded_length < 16);
+        assert_eq!(ring.as_ring().read(4).unwrap()[100], 4);
+    }
+
+    #[test]
+    fn test_foreign_write_breaks_delta_chain() {
+        let config = HistoryConfig::new(4);
+        let mut storage = area(&config, 64);
+        let buf = bytes(&mut storage);
+        init_history(buf, &config, 64).unwrap();
+
+        let mut ring = HistoryRingMut::new(buf).unwrap();
+        let mut scratch = Vec::new();
+        ring.push(1, 0, &[], &[1u8; 64], &mut scratch).unwrap();
+        // Version 2 was written outside the ring; 3 must not delta against 1.
+        let entry = ring
+            .push(3, 2, &[2u8; 64], &[3u8; 64], &mut scratch)
+            .unwrap();
+        assert!(entry.keyframe);
+        assert_eq!(ring.as_ring().read(3).unwrap(), vec![3u8; 64]);
+    }
+}
@@ -1,18 +1,30 @@
 //! Types and traits for state management and memio region.
 
 use std::fmt::Debug;
+use std::io::IoSlice;
 use std::path::PathBuf;
 
 pub mod arena;
+pub mod delta;
 pub mod error;
+pub mod history;
+#[cfg(feature = "parallel")]
+pub mod parallel;
+pub mod rpc;
 pub mod schema;
+pub mod sharded;
+pub mod shared_broadcast_spec;
+pub mod shared_doorbell_spec;
 pub mod shared_header;
+pub mod shared_heap_spec;
+pub mod shared_rpc_spec;
 pub mod shared_state;
 mod shared_state_spec;
 pub mod state;
 
 pub use arena::Arena;
 pub use error::{MemioError, MemioResult};
+pub use history::{HistoryConfig, HistoryEntry, HistoryRing, HistoryRingMut};
 
 /// Alias for MemioError.
 pub type SharedMemoryError = MemioError;
@@ -39,6 +51,38 @@ pub trait SharedMemoryRegion: Send + Sync + Debug {
     /// Writes data with version number.
     fn write(&mut self, version: u64, data: &[u8]) -> Result<SharedStateInfo, MemioError>;
 
+    /// Writes the concatenation of `bufs` as one payload with version number.
+    ///
+    /// For payloads assembled from separately owned pieces (a header plus
+    /// several arrays). The default gathers them into one buffer and calls
+    /// `write`; regions that map their payload copy each piece in place.
+    fn write_vectored(
+        &mut self,
+        version: u64,
+        bufs: &[IoSlice<'_>],
+    ) -> Result<SharedStateInfo, MemioError> {
+        self.write(version, &gather(bufs))
+    }
+
+    /// Lends up to `max_len` bytes of payload to `fill`, which writes the
+    /// new payload and returns its length, then publishes it as `version`.
+    ///
+    /// For producers that generate data (decoders, filters) instead of
+    /// holding it. The default fills a temporary buffer and calls `write`;
+    /// regions that map their payload lend the mapping itself, marked as
+    /// being written (see `begin_write_ptr`) until `fill` returns. A length
+    /// above `max_len` is clamped to it.
+    fn write_with(
+        &mut self,
+        version: u64,
+        max_len: usize,
+        fill: &mut dyn FnMut(&mut [u8]) -> usize,
+    ) -> Result<SharedStateInfo, MemioError> {
+        let mut data = vec![0u8; max_len];
+        let length = fill_len(fill(&mut data), max_len);
+        self.write(version, &data[..length])
+    }
+
     /// Reads data bytes.
     fn read(&self) -> Result<Vec<u8>, MemioError>;
 
@@ -51,6 +95,66 @@ pub trait SharedMemoryRegion: Send + Sync + Debug {
     /// # Safety
     /// Implementations must return a valid mutable pointer for the region's lifetime.
     unsafe fn data_ptr_mut(&mut self) -> *mut u8;
+
+    /// Returns the highest version a reader acknowledged as consumed, or
+    /// `None` if this region does not track readers.
+    fn reader_ack(&self) -> Option<u64> {
+        None
+    }
+
+    /// Records that a reader consumed `version`.
+    fn ack(&mut self, _version: u64) {}
+
+    /// Overwrites `bytes` at `offset` of the current payload and publishes
+    /// the result as `version`, keeping the payload length.
+    ///
+    /// The default reads the payload back and rewrites all of it; regions
+    /// that map their payload patch it in place.
+    fn patch(
+        &mut self,
+        version: u64,
+        offset: usize,
+        bytes: &[u8],
+    ) -> Result<SharedStateInfo, MemioError> {
+        let mut data = self.read()?;
+        let end = patch_end(offset, bytes.len(), data.len())?;
+        data[offset..end].copy_from_slice(bytes);
+        self.write(version, &data)
+    }
+}
+
+/// Returns the end of a `len`-byte patch at `offset`, or an error if it does
+/// not fit in a payload of `length` bytes.
+pub fn patch_end(offset: usize, len: usize, length: usize) -> Result<usize, MemioError> {
+    offset
+        .checked_add(len)
+        .filter(|&end| end <= length)
+        .ok_or(MemioError::DataTooLarge {
+            data_len: offset.saturating_add(len),
+            capacity: length,
+        })
+}
+
+/// Clamps the length a `write_with` closure reported to the `max_len` bytes
+/// it was lent: it cannot have written past them.
+pub fn fill_len(length: usize, max_len: usize) -> usize {
+    if length > max_len {
+        tracing::warn!(
+            "write_with closure reported {} bytes of {} lent; clamping",
+            length,
+            max_len
+        );
+    }
+    length.min(max_len)
+}
+
+/// Concatenates `bufs` into one buffer.
+pub fn gather(bufs: &[IoSlice<'_>]) -> Vec<u8> {
+    let mut data = Vec::with_capacity(bufs.iter().map(|b| b.len()).sum());
+    for buf in bufs {
+        data.extend_from_slice(buf);
+    }
+    data
 }
 
 /// Interface for creating memio regions.
@@ -76,13 +180,19 @@ pub trait SharedMemoryFactory: Send + Sync {
 pub type BoxedRegion = Box<dyn SharedMemoryRegion>;
 pub type BoxedFactory = Box<dyn SharedMemoryFactory<Region = BoxedRegion>>;
 
-pub use schema::{MemioField, MemioFieldType, MemioScalarType, MemioSchema, schema_json};
+pub use schema::{
+    MemioField, MemioFieldKey, MemioFieldType, MemioFieldValue, MemioScalarType, MemioScalarValue,
+    MemioSchema, schema_json,
+};
+pub use sharded::{ShardFn, ShardedMemioState};
 pub use shared_state::{SHARED_STATE_HEADER_SIZE, SHARED_STATE_MAGIC};
-pub use state::{MemioState, NoOpRegion};
+pub use state::{MemioDirtyTracking, MemioState, NoOpRegion, PublishPolicy};
 
 pub use shared_header::{
-    SHARED_STATE_ENDIANNESS, SHARED_STATE_LENGTH_OFFSET, SHARED_STATE_MAGIC_OFFSET,
-    SHARED_STATE_VERSION_OFFSET, read_header, read_header_ptr, read_length, read_u64_le,
+    SHARED_STATE_ACK_OFFSET, SHARED_STATE_ENDIANNESS, SHARED_STATE_HISTORY_OFFSET,
+    SHARED_STATE_LENGTH_OFFSET, SHARED_STATE_MAGIC_OFFSET, SHARED_STATE_SEQ_OFFSET,
+    SHARED_STATE_VERSION_OFFSET, ack_version_ptr, begin_write_ptr, end_write_ptr, read_ack_ptr,
+    read_header, read_header_ptr, read_history_offset, read_length, read_seq_ptr, read_u64_le,
     read_u64_ptr, read_version, validate_magic, validate_magic_result, write_header,
     write_header_ptr, write_header_unchecked, write_u64_le, write_u64_ptr,
 };
@@ -0,0 +1,250 @@
+//! Chunked multi-threaded copies for large payloads (`parallel` feature).
+//!
+//! Publishing a state that holds 10^6-element vectors is dominated by bulk
+//! copies, above all the archive into the mapped region. From
+//! `PARALLEL_MIN_BYTES` on, a copy is split into one chunk per thread and
+//! handed to a process-wide pool of copy workers; smaller copies stay on the
+//! calling thread, where handing off would cost more than it saves.
+//!
+//! The workers are spawned on first use (up to `threads() - 1`) and then
+//! park on a condvar between copies, so a publish pays a queue push and a
+//! wakeup per chunk, not a thread spawn. The calling thread copies the first
+//! chunk and then drains queued chunks itself until all are done, so a copy
+//! completes even if no worker could be spawned.
+
+use std::collections::VecDeque;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, Condvar, Mutex, MutexGuard, OnceLock};
+
+/// Copies shorter than this run on the calling thread.
+pub const PARALLEL_MIN_BYTES: usize = 1024 * 1024;
+
+/// Smallest chunk handed to a thread.
+const MIN_CHUNK: usize = 256 * 1024;
+
+/// Thread count for parallel copies; 0 means `available_parallelism`.
+static THREADS: AtomicUsize = AtomicUsize::new(0);
+
+/// Sets the number of threads used per copy (0 restores the default,
+/// the number of available cores). Workers already spawned are kept.
+pub fn set_threads(threads: usize) {
+    THREADS.store(threads, Ordering::Relaxed);
+}
+
+/// Returns the number of threads used per copy.
+pub fn threads() -> usize {
+    match THREADS.load(Ordering::Relaxed) {
+        0 => std::thread::available_parallelism().map_or(1, |n| n.get()),
+        n => n,
+    }
+}
+
+/// Number of chunks to split a `len`-byte copy into.
+fn chunks_for(len: usize) -> usize {
+    if len < PARALLEL_MIN_BYTES {
+        return 1;
+    }
+    threads().min(len / MIN_CHUNK).max(1)
+}
+
+/// Copies `src` into `dst`, in parallel for large copies.
+///
+/// # Panics
+/// If the slices differ in length, like `copy_from_slice`.
+pub fn copy(dst: &mut [u8], src: &[u8]) {
+    assert_eq!(dst.len(), src.len(), "parallel::copy length mismatch");
+    let chunks = chunks_for(src.len());
+    if chunks == 1 {
+        dst.copy_from_slice(src);
+        return;
+    }
+
+    let chunk = src.len().div_ceil(chunks);
+    let mut parts = dst.chunks_mut(chunk).zip(src.chunks(chunk));
+    // The calling thread takes the first chunk
+    let Some((first_dst, first_src)) = parts.next() else {
+        return;
+    };
+    let done = Arc::new(Latch::new(chunks - 1));
+    let jobs = parts
+        .map(|(d, s)| Job {
+            dst: d.as_mut_ptr(),
+            src: s.as_ptr(),
+            len: s.len(),
+            done: done.clone(),
+        })
+        .collect();
+
+    let pool = pool();
+    pool.submit(jobs, chunks - 1);
+    first_dst.copy_from_slice(first_src);
+    while let Some(job) = pool.try_pop() {
+        job.run();
+    }
+    // The chunks borrow `dst` and `src`: they must all be copied before the
+    // borrows end
+    done.wait();
+}
+
+/// One chunk of a copy, queued for a worker.
+struct Job {
+    dst: *mut u8,
+    src: *const u8,
+    len: usize,
+    done: Arc<Latch>,
+}
+
+// SAFETY: the pointers come from disjoint chunks of slices the submitting
+// `copy` keeps borrowed until the job's latch reaches zero
+unsafe impl Send for Job {}
+
+impl Job {
+    fn run(self) {
+        // SAFETY: see `impl Send for Job`; the chunks have equal lengths
+        unsafe { std::ptr::copy_nonoverlapping(self.src, self.dst, self.len) };
+        self.done.count_down();
+    }
+}
+
+/// Counts the chunks of one copy still outstanding.
+struct Latch {
+    pending: Mutex<usize>,
+    zero: Condvar,
+}
+
+impl Latch {
+    fn new(pending: usize) -> Self {
+        Self {
+            pending: Mutex::new(pending),
+            zero: Condvar::new(),
+        }
+    }
+
+    fn count_down(&self) {
+        let mut pending = lock(&self.pending);
+        *pending -= 1;
+        if *pending == 0 {
+            self.zero.notify_all();
+        }
+    }
+
+    fn wait(&self) {
+        let mut pending = lock(&self.pending);
+        while *pending > 0 {
+            pending = self.zero.wait(pending).unwrap_or_else(|e| e.into_inner());
+        }
+    }
+}
+
+/// The process-wide copy workers and their queue.
+struct Pool {
+    queue: Mutex<Queue>,
+    ready: Condvar,
+}
+
+struct Queue {
+    jobs: VecDeque<Job>,
+    workers: usize,
+}
+
+fn pool() -> &'static Pool {
+    static POOL: OnceLock<Pool> = OnceLock::new();
+    POOL.get_or_init(|| Pool {
+        queue: Mutex::new(Queue {
+            jobs: VecDeque::new(),
+            workers: 0,
+        }),
+        ready: Condvar::new(),
+    })
+}
+
+impl Pool {
+    /// Queues `jobs`, growing the pool to `wanted` workers first.
+    fn submit(&'static self, jobs: Vec<Job>, wanted: usize) {
+        let mut queue = lock(&self.queue);
+        while queue.workers < wanted {
+            let spawned = std::thread::Builder::new()
+                .name("memio-copy".into())
+                .spawn(move || self.work());
+            if spawned.is_err() {
+                // The calling thread drains whatever the workers don't take
+                break;
+            }
+            queue.workers += 1;
+        }
+        queue.jobs.extend(jobs);
+        drop(queue);
+        self.ready.notify_all();
+    }
+
+    fn try_pop(&self) -> Option<Job> {
+        lock(&self.queue).jobs.pop_front()
+    }
+
+    fn work(&self) {
+        loop {
+            let job = {
+                let mut queue = lock(&self.queue);
+                loop {
+                    if let Some(job) = queue.jobs.pop_front() {
+                        break job;
+                    }
+                    queue = self.ready.wait(queue).unwrap_or_else(|e| e.into_inner());
+                }
+            };
+            job.run();
+        }
+    }
+}
+
+/// Locks `mutex`; plain copies cannot panic while holding it, so a poisoned
+/// lock still guards consistent data.
+fn lock<T>(mutex: &Mutex<T>) -> MutexGuard<'_, T> {
+    mutex.lock().unwrap_or_else(|e| e.into_inner())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_large_copies_match() {
+        set_threads(4);
+        let src: Vec<u8> = (0..3 * PARALLEL_MIN_BYTES + 17).map(|i| i as u8).collect();
+        let mut dst = vec![0u8; src.len()];
+        copy(&mut dst, &src);
+        assert_eq!(dst, src);
+
+        let small = [1u8, 2, 3];
+        let mut out = [0u8; 3];
+        copy(&mut out, &small);
+        assert_eq!(out, small);
+        set_threads(0);
+        assert!(threads() >= 1);
+    }
+
+    #[test]
+    fn test_pool_is_reused_across_copies() {
+        set_threads(4);
+        let src: Vec<u8> = (0..2 * PARALLEL_MIN_BYTES).map(|i| (i * 7) as u8).collect();
+        let handles: Vec<_> = (0..4)
+            .map(|_| {
+                let src = src.clone();
+                std::thread::spawn(move || {
+                    for _ in 0..8 {
+                        let mut dst = vec![0u8; src.len()];
+                        copy(&mut dst, &src);
+                        assert_eq!(dst, src);
+                    }
+                })
+            })
+            .collect();
+        for handle in handles {
+            handle.join().unwrap();
+        }
+        // Concurrent copies share the workers instead of spawning per copy
+        // (the other test may briefly restore the default thread count)
+        let most = threads().max(4) - 1;
+        assert!(lock(&pool().queue).workers <= most);
+    }
+}
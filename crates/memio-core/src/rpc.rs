@@ -0,0 +1,157 @@
+//! Binary RPC framing.
+//!
+//! Requests and responses travel as length-prefixed frames, back to back, so
+//! one ring write or IPC message can carry a whole batch:
+//!
+//! ```text
+//! [length u32][correlation u32][method u32][flags u32][payload: length bytes]
+//! ```
+//!
+//! All fields are little-endian. A response echoes the request's correlation
+//! id and method and sets `RPC_FLAG_RESPONSE`; failed calls also set
+//! `RPC_FLAG_ERROR` and carry a UTF-8 message as payload.
+
+pub use crate::shared_rpc_spec::{
+    RPC_FLAG_ERROR, RPC_FLAG_RESPONSE, RPC_FRAME_CORRELATION_OFFSET, RPC_FRAME_FLAGS_OFFSET,
+    RPC_FRAME_HEADER_SIZE, RPC_FRAME_LENGTH_OFFSET, RPC_FRAME_METHOD_OFFSET,
+};
+
+/// Fixed 16-byte header in front of every frame.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct RpcFrameHeader {
+    /// Payload length in bytes (header excluded)
+    pub length: u32,
+    /// Caller-chosen id echoed in the response
+    pub correlation: u32,
+    /// Handler id
+    pub method: u32,
+    /// `RPC_FLAG_*` bits
+    pub flags: u32,
+}
+
+impl RpcFrameHeader {
+    /// Parses a header from the start of `buf`.
+    pub fn decode(buf: &[u8]) -> Option<Self> {
+        if buf.len() < RPC_FRAME_HEADER_SIZE {
+            return None;
+        }
+        Some(Self {
+            length: read_u32_le(buf, RPC_FRAME_LENGTH_OFFSET),
+            correlation: read_u32_le(buf, RPC_FRAME_CORRELATION_OFFSET),
+            method: read_u32_le(buf, RPC_FRAME_METHOD_OFFSET),
+            flags: read_u32_le(buf, RPC_FRAME_FLAGS_OFFSET),
+        })
+    }
+
+    /// Writes the header into the first 16 bytes of `out`.
+    pub fn encode(&self, out: &mut [u8]) {
+        out[RPC_FRAME_LENGTH_OFFSET..RPC_FRAME_LENGTH_OFFSET + 4]
+            .copy_from_slice(&self.length.to_le_bytes());
+        out[RPC_FRAME_CORRELATION_OFFSET..RPC_FRAME_CORRELATION_OFFSET + 4]
+            .copy_from_slice(&self.correlation.to_le_bytes());
+        out[RPC_FRAME_METHOD_OFFSET..RPC_FRAME_METHOD_OFFSET + 4]
+            .copy_from_slice(&self.method.to_le_bytes());
+        out[RPC_FRAME_FLAGS_OFFSET..RPC_FRAME_FLAGS_OFFSET + 4]
+            .copy_from_slice(&self.flags.to_le_bytes());
+    }
+
+    /// Total frame size, header included.
+    pub fn frame_len(&self) -> usize {
+        RPC_FRAME_HEADER_SIZE + self.length as usize
+    }
+
+    pub fn is_response(&self) -> bool {
+        self.flags & RPC_FLAG_RESPONSE != 0
+    }
+
+    pub fn is_error(&self) -> bool {
+        self.flags & RPC_FLAG_ERROR != 0
+    }
+}
+
+/// Appends one frame to `out`; `header.length` is taken from `payload`.
+pub fn push_frame(out: &mut Vec<u8>, correlation: u32, method: u32, flags: u32, payload: &[u8]) {
+    let start = out.len();
+    out.resize(start + RPC_FRAME_HEADER_SIZE, 0);
+    RpcFrameHeader {
+        length: payload.len() as u32,
+        correlation,
+        method,
+        flags,
+    }
+    .encode(&mut out[start..]);
+    out.extend_from_slice(payload);
+}
+
+/// Iterates over the complete frames at the start of a byte buffer.
+///
+/// Stops at the first incomplete frame; `consumed()` then tells how many
+/// bytes were whole frames, so a stream reader can keep the remainder.
+pub struct RpcFrames<'a> {
+    buf: &'a [u8],
+    offset: usize,
+}
+
+impl<'a> RpcFrames<'a> {
+    pub fn new(buf: &'a [u8]) -> Self {
+        Self { buf, offset: 0 }
+    }
+
+    /// Bytes covered by the frames yielded so far.
+    pub fn consumed(&self) -> usize {
+        self.offset
+    }
+}
+
+impl<'a> Iterator for RpcFrames<'a> {
+    type Item = (RpcFrameHeader, &'a [u8]);
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let rest = &self.buf[self.offset..];
+        let header = RpcFrameHeader::decode(rest)?;
+        if rest.len() < header.frame_len() {
+            return None;
+        }
+        let payload = &rest[RPC_FRAME_HEADER_SIZE..header.frame_len()];
+        self.offset += header.frame_len();
+        Some((header, payload))
+    }
+}
+
+fn read_u32_le(buf: &[u8], offset: usize) -> u32 {
+    u32::from_le_bytes(buf[offset..offset + 4].try_into().unwrap())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_frames_round_trip() {
+        let mut buf = Vec::new();
+        push_frame(&mut buf, 7, 3, 0, b"hello");
+        push_frame(&mut buf, 8, 4, RPC_FLAG_RESPONSE, b"");
+
+        let frames: Vec<_> = RpcFrames::new(&buf).collect();
+        assert_eq!(frames.len(), 2);
+        assert_eq!(frames[0].0.correlation, 7);
+        assert_eq!(frames[0].0.method, 3);
+        assert_eq!(frames[0].1, b"hello");
+        assert!(frames[1].0.is_response());
+        assert!(frames[1].1.is_empty());
+    }
+
+    #[test]
+    fn test_incomplete_frame_is_left_over() {
+        let mut buf = Vec::new();
+        push_frame(&mut buf, 1, 1, 0, b"abc");
+        let whole = buf.len();
+        push_frame(&mut buf, 2, 1, 0, b"defgh");
+        buf.truncate(buf.len() - 2);
+
+        let mut frames = RpcFrames::new(&buf);
+        assert_eq!(frames.next().map(|f| f.1), Some(&b"abc"[..]));
+        assert!(frames.next().is_none());
+        assert_eq!(frames.consumed(), whole);
+    }
+}
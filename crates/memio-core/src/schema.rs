@@ -1,6 +1,6 @@
 //! Schema metadata for struct field access.
 
-#[derive(Debug, Clone, Copy)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub enum MemioScalarType {
     U8,
     U16,
@@ -31,7 +31,7 @@ impl MemioScalarType {
     }
 }
 
-#[derive(Debug, Clone, Copy)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub enum MemioFieldType {
     Scalar(MemioScalarType),
     Array { elem: MemioScalarType, len: usize },
@@ -48,6 +48,100 @@ pub trait MemioSchema {
     fn schema() -> &'static [MemioField];
 }
 
+/// Values that `MemioState::set_field` writes in place: the scalar types
+/// and fixed arrays of them, in their archived (little-endian) form.
+pub trait MemioFieldValue: Copy {
+    /// Schema type of a field holding this value.
+    const TYPE: MemioFieldType;
+
+    /// Calls `f` with the archived bytes of the value.
+    fn with_archived<R>(&self, f: impl FnOnce(&[u8]) -> R) -> R;
+}
+
+/// Scalar [`MemioFieldValue`]s, usable as array elements.
+pub trait MemioScalarValue: MemioFieldValue {
+    const SCALAR: MemioScalarType;
+}
+
+macro_rules! scalar_field_value {
+    ($($ty:ty => $scalar:ident),* $(,)?) => {$(
+        impl MemioFieldValue for $ty {
+            const TYPE: MemioFieldType = MemioFieldType::Scalar(MemioScalarType::$scalar);
+
+            fn with_archived<R>(&self, f: impl FnOnce(&[u8]) -> R) -> R {
+                f(&self.to_le_bytes())
+            }
+        }
+
+        impl MemioScalarValue for $ty {
+            const SCALAR: MemioScalarType = MemioScalarType::$scalar;
+        }
+    )*};
+}
+
+scalar_field_value! {
+    u8 => U8, u16 => U16, u32 => U32, u64 => U64,
+    i8 => I8, i16 => I16, i32 => I32, i64 => I64,
+    f32 => F32, f64 => F64,
+}
+
+impl<V: MemioScalarValue, const N: usize> MemioFieldValue for [V; N] {
+    const TYPE: MemioFieldType = MemioFieldType::Array {
+        elem: V::SCALAR,
+        len: N,
+    };
+
+    #[cfg(target_endian = "little")]
+    fn with_archived<R>(&self, f: impl FnOnce(&[u8]) -> R) -> R {
+        // SAFETY: plain numeric elements, already little-endian in memory
+        f(unsafe {
+            std::slice::from_raw_parts(self.as_ptr() as *const u8, std::mem::size_of_val(self))
+        })
+    }
+
+    #[cfg(target_endian = "big")]
+    fn with_archived<R>(&self, f: impl FnOnce(&[u8]) -> R) -> R {
+        let mut bytes = Vec::with_capacity(std::mem::size_of_val(self));
+        for elem in self {
+            elem.with_archived(|b| bytes.extend_from_slice(b));
+        }
+        f(&bytes)
+    }
+}
+
+/// Typed handle to one field of `T`.
+///
+/// `#[derive(MemioModel)]` generates one per field as `T::<field>_field()`.
+pub struct MemioFieldKey<T, V> {
+    index: usize,
+    set: fn(&mut T, V),
+}
+
+impl<T, V> Clone for MemioFieldKey<T, V> {
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+
+impl<T, V> Copy for MemioFieldKey<T, V> {}
+
+impl<T: MemioSchema, V: MemioFieldValue> MemioFieldKey<T, V> {
+    /// Creates a handle to `T::schema()[index]`, assigned through `set`.
+    pub const fn new(index: usize, set: fn(&mut T, V)) -> Self {
+        Self { index, set }
+    }
+
+    /// Returns the schema entry of the field.
+    pub fn field(&self) -> &'static MemioField {
+        &T::schema()[self.index]
+    }
+
+    /// Assigns `value` to the field of `target`.
+    pub fn set(&self, target: &mut T, value: V) {
+        (self.set)(target, value)
+    }
+}
+
 /// Generates JSON representation of schema fields.
 pub fn schema_json<T: MemioSchema>() -> String {
     let fields = T::schema();
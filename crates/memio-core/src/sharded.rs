@@ -0,0 +1,250 @@
+//! State partitioned into independently versioned shards.
+//!
+//! A single `MemioState` is one archive under one version: changing one
+//! entity of a large world re-serializes and re-publishes all of it, and
+//! every reader copies all of it again. `ShardedMemioState` splits the state
+//! into N `MemioState`s, each with its own lock, version and region. A
+//! user-provided shard function maps a key (entity id, chunk coordinate...)
+//! to its shard, so a write only archives and publishes that shard, writers
+//! on different shards never contend, and readers refresh only the shards
+//! whose version moved.
+//!
+//! Shards can live in separate regions or, on Linux, as objects of one
+//! `SharedHeap` (`memio_platform::HeapObjectRegion`), which gives one mapping
+//! with a directory of per-shard versions.
+
+use rkyv::{Archive, Serialize};
+
+use crate::SharedMemoryRegion;
+use crate::error::{MemioError, MemioResult};
+use crate::state::{MemioState, NoOpRegion};
+
+/// Maps a key to its shard index (taken modulo the shard count).
+pub type ShardFn<K> = Box<dyn Fn(&K) -> usize + Send + Sync>;
+
+/// A state split into shards that are serialized and published independently.
+pub struct ShardedMemioState<K: ?Sized, T, R: SharedMemoryRegion = NoOpRegion> {
+    shards: Vec<MemioState<T, R>>,
+    shard_fn: ShardFn<K>,
+}
+
+impl<K, T> ShardedMemioState<K, T, NoOpRegion>
+where
+    K: ?Sized,
+    T: Archive
+        + for<'a> Serialize<
+            rkyv::api::high::HighSerializer<
+                rkyv::util::AlignedVec,
+                rkyv::ser::allocator::ArenaHandle<'a>,
+                rkyv::rancor::Error,
+            >,
+        >,
+{
+    /// Creates shards without memio regions, one per value.
+    pub fn new<F>(values: Vec<T>, shard_fn: F) -> MemioResult<Self>
+    where
+        F: Fn(&K) -> usize + Send + Sync + 'static,
+    {
+        Self::from_shards(values.into_iter().map(MemioState::new).collect(), shard_fn)
+    }
+}
+
+impl<K, T, R> ShardedMemioState<K, T, R>
+where
+    K: ?Sized,
+    R: SharedMemoryRegion,
+    T: Archive
+        + for<'a> Serialize<
+            rkyv::api::high::HighSerializer<
+                rkyv::util::AlignedVec,
+                rkyv::ser::allocator::ArenaHandle<'a>,
+                rkyv::rancor::Error,
+            >,
+        >,
+{
+    /// Creates shards bound to memio regions, one `(value, region)` pair per shard.
+    pub fn with_regions<F>(shards: Vec<(T, R)>, shard_fn: F) -> MemioResult<Self>
+    where
+        F: Fn(&K) -> usize + Send + Sync + 'static,
+    {
+        Self::from_shards(
+            shards
+                .into_iter()
+                .map(|(value, region)| MemioState::new_with_region(value, region))
+                .collect(),
+            shard_fn,
+        )
+    }
+
+    /// Wraps already configured states (publish policy, dedupe...) as shards.
+    pub fn from_shards<F>(shards: Vec<MemioState<T, R>>, shard_fn: F) -> MemioResult<Self>
+    where
+        F: Fn(&K) -> usize + Send + Sync + 'static,
+    {
+        if shards.is_empty() {
+            return Err(MemioError::Internal(
+                "sharded state needs at least one shard".to_string(),
+            ));
+        }
+        Ok(Self {
+            shards,
+            shard_fn: Box::new(shard_fn),
+        })
+    }
+
+    /// Returns the number of shards.
+    pub fn len(&self) -> usize {
+        self.shards.len()
+    }
+
+    /// Always false: a sharded state has at least one shard.
+    pub fn is_empty(&self) -> bool {
+        self.shards.is_empty()
+    }
+
+    /// Returns the shard index holding `key`.
+    pub fn shard_of(&self, key: &K) -> usize {
+        (self.shard_fn)(key) % self.shards.len()
+    }
+
+    /// Returns shard `index`.
+    pub fn shard(&self, index: usize) -> Option<&MemioState<T, R>> {
+        self.shards.get(index)
+    }
+
+    /// Returns all shards.
+    pub fn shards(&self) -> &[MemioState<T, R>] {
+        &self.shards
+    }
+
+    /// Reads the shard holding `key`.
+    pub fn read<F, R2>(&self, key: &K, f: F) -> MemioResult<R2>
+    where
+        F: FnOnce(&T) -> R2,
+    {
+        self.shards[self.shard_of(key)].read(f)
+    }
+
+    /// Writes the shard holding `key`; only that shard is serialized,
+    /// versioned and published.
+    pub fn write<F, R2>(&self, key: &K, f: F) -> MemioResult<R2>
+    where
+        F: FnOnce(&mut T) -> R2,
+    {
+        self.shards[self.shard_of(key)].write(f)
+    }
+
+    /// Returns the version of every shard, indexed by shard.
+    pub fn versions(&self) -> Vec<u64> {
+        self.shards.iter().map(MemioState::version).collect()
+    }
+
+    /// Returns the shards whose version differs from `versions` (as returned
+    /// by an earlier `versions()`); shards missing from it count as changed.
+    pub fn changed_since(&self, versions: &[u64]) -> Vec<usize> {
+        self.shards
+            .iter()
+            .enumerate()
+            .filter(|(i, shard)| versions.get(*i) != Some(&shard.version()))
+            .map(|(i, _)| i)
+            .collect()
+    }
+
+    /// Runs `publish_pending` on every shard. Returns the shards published.
+    pub fn publish_pending(&self) -> MemioResult<Vec<usize>> {
+        let mut published = Vec::new();
+        for (i, shard) in self.shards.iter().enumerate() {
+            if shard.publish_pending()?.is_some() {
+                published.push(i);
+            }
+        }
+        Ok(published)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::state::PublishPolicy;
+    use crate::state::tests::MockRegion;
+
+    /// One-byte shards, one per region, keyed by shard index.
+    fn sharded(regions: &[MockRegion]) -> ShardedMemioState<u32, Vec<u8>, MockRegion> {
+        let shards = regions.iter().map(|region| (vec![0u8], region.clone()));
+        ShardedMemioState::with_regions(shards.collect(), |k: &u32| *k as usize).unwrap()
+    }
+
+    #[test]
+    fn test_keys_route_to_their_shard() {
+        let state = ShardedMemioState::new(vec![vec![0u8]; 4], |k: &u32| *k as usize).unwrap();
+        assert_eq!(state.len(), 4);
+        assert_eq!(state.shard_of(&5), 1);
+        assert_eq!(state.shard_of(&8), 0);
+
+        state.write(&5, |v| v[0] = 7).unwrap();
+        assert_eq!(state.read(&1, |v| v[0]).unwrap(), 7);
+        assert_eq!(state.read(&4, |v| v[0]).unwrap(), 0);
+    }
+
+    #[test]
+    fn test_write_publishes_only_its_shard() {
+        let regions: Vec<_> = (0..3).map(|_| MockRegion::default()).collect();
+        let state = sharded(&regions);
+
+        state.write(&4, |v| v[0] = 9).unwrap();
+        assert_eq!(regions[1].writes(), vec![1]);
+        assert_eq!(
+            regions[1].payload(),
+            state.shard(1).unwrap().to_bytes().unwrap()
+        );
+        assert!(regions[0].writes().is_empty());
+        assert!(regions[2].writes().is_empty());
+    }
+
+    #[test]
+    fn test_versions_and_changed_since() {
+        let regions: Vec<_> = (0..3).map(|_| MockRegion::default()).collect();
+        let state = sharded(&regions);
+        let before = state.versions();
+        assert_eq!(before, vec![0, 0, 0]);
+
+        state.write(&2, |v| v[0] += 1).unwrap();
+        state.write(&5, |v| v[0] += 1).unwrap();
+        assert_eq!(state.versions(), vec![0, 0, 2]);
+        assert_eq!(state.changed_since(&before), vec![2]);
+        assert!(state.changed_since(&state.versions()).is_empty());
+        // Shards missing from `versions` count as changed
+        assert_eq!(state.changed_since(&[0]), vec![1, 2]);
+    }
+
+    #[test]
+    fn test_publish_pending_reports_published_shards() {
+        let regions: Vec<_> = (0..2).map(|_| MockRegion::acked()).collect();
+        let shards = regions
+            .iter()
+            .map(|region| {
+                MemioState::new_with_region(vec![0u8], region.clone())
+                    .with_publish_policy(PublishPolicy::OnDemand)
+            })
+            .collect();
+        let state = ShardedMemioState::from_shards(shards, |k: &u32| *k as usize).unwrap();
+
+        state.write(&0, |v| v[0] += 1).unwrap();
+        state.write(&0, |v| v[0] += 1).unwrap();
+        state.write(&1, |v| v[0] += 1).unwrap();
+        // Shard 0 waits for its reader to ack version 1
+        assert_eq!(regions[0].writes(), vec![1]);
+        assert!(state.publish_pending().unwrap().is_empty());
+
+        regions[0].set_ack(1);
+        assert_eq!(state.publish_pending().unwrap(), vec![0]);
+        assert_eq!(regions[0].writes(), vec![1, 2]);
+        assert_eq!(regions[1].writes(), vec![1]);
+    }
+
+    #[test]
+    fn test_needs_a_shard() {
+        let empty = ShardedMemioState::<u32, Vec<u8>>::new(Vec::new(), |_: &u32| 0);
+        assert!(matches!(empty, Err(MemioError::Internal(_))));
+    }
+}
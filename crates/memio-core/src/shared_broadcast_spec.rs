@@ -0,0 +1,14 @@
+// Generated from shared/shared_broadcast_spec.json. Do not edit by hand.
+pub const BROADCAST_MAGIC: u64 = 0x545552424F424353;
+pub const BROADCAST_HEADER_SIZE: usize = 64;
+pub const BROADCAST_MAGIC_OFFSET: usize = 0;
+pub const BROADCAST_CAPACITY_OFFSET: usize = 8;
+pub const BROADCAST_HEAD_OFFSET: usize = 16;
+pub const BROADCAST_TAIL_OFFSET: usize = 24;
+pub const BROADCAST_SLOTS_OFFSET: usize = 32;
+pub const BROADCAST_DATA_OFFSET: usize = 40;
+pub const BROADCAST_SLOT_SIZE: usize = 32;
+pub const BROADCAST_SLOT_OWNER_OFFSET: usize = 0;
+pub const BROADCAST_SLOT_CURSOR_OFFSET: usize = 8;
+pub const BROADCAST_SLOT_HEARTBEAT_OFFSET: usize = 16;
+pub const BROADCAST_RECORD_HEADER_SIZE: usize = 4;
@@ -0,0 +1,6 @@
+// Generated from shared/shared_doorbell_spec.json. Do not edit by hand.
+pub const SHARED_DOORBELL_MAGIC: u64 = 0x545552424F44424C;
+pub const SHARED_DOORBELL_SIZE: usize = 64;
+pub const SHARED_DOORBELL_MAGIC_OFFSET: usize = 0;
+pub const SHARED_DOORBELL_SEQUENCE_OFFSET: usize = 8;
+pub const SHARED_DOORBELL_WAITERS_OFFSET: usize = 12;
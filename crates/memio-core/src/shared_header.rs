@@ -1,10 +1,13 @@
 //! Header read/write functions for memio regions.
 
 pub use crate::shared_state_spec::{
-    SHARED_STATE_ENDIANNESS, SHARED_STATE_HEADER_SIZE, SHARED_STATE_LENGTH_OFFSET,
-    SHARED_STATE_MAGIC, SHARED_STATE_MAGIC_OFFSET, SHARED_STATE_VERSION_OFFSET,
+    SHARED_STATE_ACK_OFFSET, SHARED_STATE_ENDIANNESS, SHARED_STATE_HEADER_SIZE,
+    SHARED_STATE_HISTORY_OFFSET, SHARED_STATE_LENGTH_OFFSET, SHARED_STATE_MAGIC,
+    SHARED_STATE_MAGIC_OFFSET, SHARED_STATE_SEQ_OFFSET, SHARED_STATE_VERSION_OFFSET,
 };
 
+use std::sync::atomic::{AtomicU64, Ordering, fence};
+
 use crate::{MemioError, MemioResult};
 
 /// Returns true if buffer starts with valid magic bytes.
@@ -87,6 +90,14 @@ pub fn read_length(buf: &[u8]) -> Option<usize> {
     Some(read_u64_le(buf, SHARED_STATE_LENGTH_OFFSET) as usize)
 }
 
+/// Reads the history area offset from header (0 when history mode is off).
+pub fn read_history_offset(buf: &[u8]) -> Option<usize> {
+    if buf.len() < SHARED_STATE_HEADER_SIZE {
+        return None;
+    }
+    Some(read_u64_le(buf, SHARED_STATE_HISTORY_OFFSET) as usize)
+}
+
 /// Reads header from raw pointer. Pointer must be valid for SHARED_STATE_HEADER_SIZE bytes.
 /// # Safety
 /// Caller must ensure `ptr` is valid for at least `capacity` bytes.
@@ -123,6 +134,60 @@ pub unsafe fn write_header_ptr(ptr: *mut u8, version: u64, length: usize) {
     }
 }
 
+/// Reads the reader ack word: the highest version a reader reported as
+/// consumed (0 if none yet).
+/// # Safety
+/// Caller must ensure `ptr` is an 8-byte aligned header valid for
+/// `SHARED_STATE_HEADER_SIZE` bytes.
+pub unsafe fn read_ack_ptr(ptr: *const u8) -> u64 {
+    unsafe { AtomicU64::from_ptr(ptr.add(SHARED_STATE_ACK_OFFSET) as *mut u64) }
+        .load(Ordering::Acquire)
+}
+
+/// Raises the reader ack word to `version`. Never lowers it, so readers of
+/// different versions can ack concurrently.
+/// # Safety
+/// Caller must ensure `ptr` is an 8-byte aligned, writable header valid for
+/// `SHARED_STATE_HEADER_SIZE` bytes.
+pub unsafe fn ack_version_ptr(ptr: *mut u8, version: u64) {
+    unsafe { AtomicU64::from_ptr(ptr.add(SHARED_STATE_ACK_OFFSET) as *mut u64) }
+        .fetch_max(version, Ordering::AcqRel);
+}
+
+/// Marks the payload as being written: makes the sequence word odd.
+///
+/// Readers in other processes load the word before and after copying the
+/// payload and retry when it was odd or changed, so an in-place write is
+/// never taken for a consistent version. Pair with `end_write_ptr` once the
+/// header is updated. An odd word left by a crashed writer stays odd.
+/// # Safety
+/// Caller must ensure `ptr` is an 8-byte aligned, writable header valid for
+/// `SHARED_STATE_HEADER_SIZE` bytes, and be the only writer.
+pub unsafe fn begin_write_ptr(ptr: *mut u8) {
+    let seq = unsafe { AtomicU64::from_ptr(ptr.add(SHARED_STATE_SEQ_OFFSET) as *mut u64) };
+    seq.store(seq.load(Ordering::Relaxed) | 1, Ordering::Relaxed);
+    // Payload stores must not become visible before the odd word
+    fence(Ordering::Release);
+}
+
+/// Ends a write started with `begin_write_ptr`: makes the sequence word
+/// even again, publishing the payload and header written in between.
+/// # Safety
+/// Same as `begin_write_ptr`.
+pub unsafe fn end_write_ptr(ptr: *mut u8) {
+    let seq = unsafe { AtomicU64::from_ptr(ptr.add(SHARED_STATE_SEQ_OFFSET) as *mut u64) };
+    seq.store((seq.load(Ordering::Relaxed) | 1) + 1, Ordering::Release);
+}
+
+/// Reads the writer sequence word (odd while a write is in progress).
+/// # Safety
+/// Caller must ensure `ptr` is an 8-byte aligned header valid for
+/// `SHARED_STATE_HEADER_SIZE` bytes.
+pub unsafe fn read_seq_ptr(ptr: *const u8) -> u64 {
+    unsafe { AtomicU64::from_ptr(ptr.add(SHARED_STATE_SEQ_OFFSET) as *mut u64) }
+        .load(Ordering::Acquire)
+}
+
 /// Writes u64 in little-endian at offset.
 #[inline]
 pub fn write_u64_le(buf: &mut [u8], offset: usize, value: u64) {
@@ -188,4 +253,35 @@ mod tests {
         write_header_unchecked(&mut buf, 123, 0);
         assert_eq!(read_version(&buf), Some(123));
     }
+
+    #[test]
+    fn test_ack_only_moves_forward() {
+        let mut buf = vec![0u64; SHARED_STATE_HEADER_SIZE / 8];
+        let ptr = buf.as_mut_ptr() as *mut u8;
+        unsafe {
+            assert_eq!(read_ack_ptr(ptr), 0);
+            ack_version_ptr(ptr, 7);
+            ack_version_ptr(ptr, 5);
+            assert_eq!(read_ack_ptr(ptr), 7);
+        }
+    }
+
+    #[test]
+    fn test_seq_odd_while_writing() {
+        let mut buf = vec![0u64; SHARED_STATE_HEADER_SIZE / 8];
+        let ptr = buf.as_mut_ptr() as *mut u8;
+        unsafe {
+            assert_eq!(read_seq_ptr(ptr), 0);
+            begin_write_ptr(ptr);
+            assert_eq!(read_seq_ptr(ptr), 1);
+            // Re-entering a write keeps the word odd
+            begin_write_ptr(ptr);
+            assert_eq!(read_seq_ptr(ptr), 1);
+            end_write_ptr(ptr);
+            assert_eq!(read_seq_ptr(ptr), 2);
+            begin_write_ptr(ptr);
+            end_write_ptr(ptr);
+            assert_eq!(read_seq_ptr(ptr), 4);
+        }
+    }
 }
@@ -0,0 +1,22 @@
+// Generated from shared/shared_heap_spec.json. Do not edit by hand.
+pub const SHARED_HEAP_MAGIC: u64 = 0x545552424F484550;
+pub const SHARED_HEAP_HEADER_SIZE: usize = 64;
+pub const SHARED_HEAP_CAPACITY_OFFSET: usize = 8;
+pub const SHARED_HEAP_GENERATION_OFFSET: usize = 16;
+pub const SHARED_HEAP_BUMP_OFFSET: usize = 24;
+pub const SHARED_HEAP_DIR_OFFSET_OFFSET: usize = 32;
+pub const SHARED_HEAP_DIR_SLOTS_OFFSET: usize = 40;
+pub const SHARED_HEAP_FREE_OFFSET_OFFSET: usize = 48;
+pub const SHARED_HEAP_ARENA_OFFSET_OFFSET: usize = 56;
+pub const SHARED_HEAP_ENTRY_SIZE: usize = 128;
+pub const SHARED_HEAP_ENTRY_STATE_OFFSET: usize = 0;
+pub const SHARED_HEAP_ENTRY_NAME_LEN_OFFSET: usize = 4;
+pub const SHARED_HEAP_ENTRY_OFFSET_OFFSET: usize = 8;
+pub const SHARED_HEAP_ENTRY_LENGTH_OFFSET: usize = 16;
+pub const SHARED_HEAP_ENTRY_CAPACITY_OFFSET: usize = 24;
+pub const SHARED_HEAP_ENTRY_VERSION_OFFSET: usize = 32;
+pub const SHARED_HEAP_ENTRY_SEQ_OFFSET: usize = 40;
+pub const SHARED_HEAP_ENTRY_NAME_OFFSET: usize = 64;
+pub const SHARED_HEAP_NAME_MAX: usize = 64;
+pub const SHARED_HEAP_MIN_BLOCK: usize = 64;
+pub const SHARED_HEAP_SIZE_CLASSES: usize = 32;
@@ -0,0 +1,14 @@
+// Generated from shared/shared_rpc_spec.json. Do not edit by hand.
+pub const SHARED_RING_MAGIC: u64 = 0x545552424F52494E;
+pub const SHARED_RING_HEADER_SIZE: usize = 64;
+pub const SHARED_RING_MAGIC_OFFSET: usize = 0;
+pub const SHARED_RING_CAPACITY_OFFSET: usize = 8;
+pub const SHARED_RING_HEAD_OFFSET: usize = 16;
+pub const SHARED_RING_TAIL_OFFSET: usize = 24;
+pub const RPC_FRAME_HEADER_SIZE: usize = 16;
+pub const RPC_FRAME_LENGTH_OFFSET: usize = 0;
+pub const RPC_FRAME_CORRELATION_OFFSET: usize = 4;
+pub const RPC_FRAME_METHOD_OFFSET: usize = 8;
+pub const RPC_FRAME_FLAGS_OFFSET: usize = 12;
+pub const RPC_FLAG_RESPONSE: u32 = 1;
+pub const RPC_FLAG_ERROR: u32 = 2;
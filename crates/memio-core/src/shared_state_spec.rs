@@ -4,4 +4,7 @@ pub const SHARED_STATE_HEADER_SIZE: usize = 64;
 pub const SHARED_STATE_MAGIC_OFFSET: usize = 0;
 pub const SHARED_STATE_VERSION_OFFSET: usize = 8;
 pub const SHARED_STATE_LENGTH_OFFSET: usize = 16;
+pub const SHARED_STATE_HISTORY_OFFSET: usize = 24;
+pub const SHARED_STATE_ACK_OFFSET: usize = 32;
+pub const SHARED_STATE_SEQ_OFFSET: usize = 40;
 pub const SHARED_STATE_ENDIANNESS: &str = "little";
@@ -2,18 +2,59 @@
 
 use rkyv::{Archive, Serialize};
 use std::sync::RwLock;
-use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
 
 use crate::SharedMemoryRegion;
 use crate::error::{MemioError, MemioResult};
-use crate::schema::{MemioSchema, schema_json};
+use crate::schema::{MemioFieldKey, MemioFieldValue, MemioSchema, schema_json};
+
+/// Buffer an archive is serialized into. The latest one is cached as is and
+/// written to the region from there, so publishing copies it only once.
+type ArchiveBytes = rkyv::util::AlignedVec;
+
+/// When `MemioState::write` publishes to the memio region.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum PublishPolicy {
+    /// Serialize and publish on every write.
+    #[default]
+    Eager,
+    /// Publish only once readers consumed the previous publish (the header
+    /// ack word caught up). Writes in between just mark the state dirty;
+    /// `publish_pending` publishes the latest state once a reader catches
+    /// up. Regions that do not track readers publish eagerly.
+    OnDemand,
+}
+
+/// Models that record whether a write actually changed them.
+///
+/// Setters flip a flag when the new value differs; `MemioState::write_tracked`
+/// takes it after the closure and skips the version bump, serialization and
+/// publish when nothing changed. Cheaper than content hashing, but only as
+/// accurate as the setters.
+pub trait MemioDirtyTracking {
+    /// Returns true if the model changed since the last call, and clears the flag.
+    fn take_dirty(&mut self) -> bool;
+}
 
 /// State container with optional memio region binding.
 pub struct MemioState<T, R: SharedMemoryRegion = NoOpRegion> {
     inner: RwLock<T>,
     version: AtomicU64,
-    cache: RwLock<Option<(u64, Vec<u8>)>>,
+    cache: RwLock<Option<(u64, ArchiveBytes)>>,
     shared_region: RwLock<Option<R>>,
+    policy: PublishPolicy,
+    /// Last version written to the region
+    published: AtomicU64,
+    /// A write was deferred by `PublishPolicy::OnDemand`
+    pending: AtomicBool,
+    /// Skip writes whose serialized bytes hash like the current version
+    #[cfg_attr(not(feature = "dedupe"), allow(dead_code))]
+    dedupe: bool,
+    /// xxh3 of the current version's bytes (dedupe mode)
+    #[cfg_attr(not(feature = "dedupe"), allow(dead_code))]
+    content_hash: RwLock<Option<u64>>,
+    /// Length of the last archive, used to pre-size the next one
+    size_hint: AtomicUsize,
 }
 
 /// Placeholder region when memio region is not used.
@@ -37,6 +78,15 @@ impl SharedMemoryRegion for NoOpRegion {
         Ok(Vec::new())
     }
 
+    fn patch(
+        &mut self,
+        _version: u64,
+        _offset: usize,
+        _bytes: &[u8],
+    ) -> Result<crate::SharedStateInfo, MemioError> {
+        Ok(crate::SharedStateInfo::default())
+    }
+
     unsafe fn data_ptr(&self) -> *const u8 {
         std::ptr::null()
     }
@@ -63,6 +113,12 @@ where
             version: AtomicU64::new(0),
             cache: RwLock::new(None),
             shared_region: RwLock::new(None),
+            policy: PublishPolicy::Eager,
+            published: AtomicU64::new(0),
+            pending: AtomicBool::new(false),
+            dedupe: false,
+            content_hash: RwLock::new(None),
+            size_hint: AtomicUsize::new(0),
         }
     }
 
@@ -73,6 +129,12 @@ where
             version: self.version,
             cache: self.cache,
             shared_region: RwLock::new(Some(region)),
+            policy: self.policy,
+            published: self.published,
+            pending: self.pending,
+            dedupe: self.dedupe,
+            content_hash: self.content_hash,
+            size_hint: self.size_hint,
         }
     }
 }
@@ -95,13 +157,42 @@ where
             version: AtomicU64::new(0),
             cache: RwLock::new(None),
             shared_region: RwLock::new(Some(region)),
+            policy: PublishPolicy::Eager,
+            published: AtomicU64::new(0),
+            pending: AtomicBool::new(false),
+            dedupe: false,
+            content_hash: RwLock::new(None),
+            size_hint: AtomicUsize::new(0),
         }
     }
 
+    /// Sets when writes are published (default `PublishPolicy::Eager`).
+    pub fn with_publish_policy(mut self, policy: PublishPolicy) -> Self {
+        self.policy = policy;
+        self
+    }
+
+    /// Keeps the current version when a write serializes to identical bytes.
+    ///
+    /// Every `write` then serializes and hashes the state (xxh3, SIMD where
+    /// the target has it) before deciding; a no-op write ("set selection to
+    /// the same selection") no longer bumps the version, publishes or wakes
+    /// readers. Prefer `write_tracked` when the model tracks changes itself.
+    #[cfg(feature = "dedupe")]
+    pub fn with_dedupe(mut self, enabled: bool) -> Self {
+        self.dedupe = enabled;
+        self
+    }
+
+    /// Returns the publish policy.
+    pub fn publish_policy(&self) -> PublishPolicy {
+        self.policy
+    }
+
     /// Serializes state to bytes.
     pub fn to_bytes(&self) -> MemioResult<Vec<u8>> {
         let guard = self.inner.read()?;
-        serialize_value(&*guard)
+        Ok(serialize_value(&*guard, &self.size_hint)?.to_vec())
     }
 
     /// Serializes state and caches result. Returns (version, bytes).
@@ -112,15 +203,16 @@ where
             && let Some((cached_version, cached_bytes)) = cache_guard.as_ref()
             && *cached_version == current_version
         {
-            return Ok((current_version, cached_bytes.clone()));
+            return Ok((current_version, cached_bytes.to_vec()));
         }
 
-        let bytes = self.to_bytes()?;
+        let bytes = serialize_value(&*self.inner.read()?, &self.size_hint)?;
+        let out = bytes.to_vec();
         if let Ok(mut cache_guard) = self.cache.write() {
-            *cache_guard = Some((current_version, bytes.clone()));
+            *cache_guard = Some((current_version, bytes));
         }
 
-        Ok((current_version, bytes))
+        Ok((current_version, out))
     }
 
     /// Serializes into arena. Returns (pointer, length).
@@ -156,24 +248,208 @@ where
     {
         let mut guard = self.inner.write()?;
         let result = f(&mut *guard);
+        self.commit(&guard)?;
+        Ok(result)
+    }
+
+    /// Like `write`, but keeps the current version when the model reports
+    /// no change (see `MemioDirtyTracking`).
+    pub fn write_tracked<F, R2>(&self, f: F) -> MemioResult<R2>
+    where
+        F: FnOnce(&mut T) -> R2,
+        T: MemioDirtyTracking,
+    {
+        let mut guard = self.inner.write()?;
+        let result = f(&mut *guard);
+        if guard.take_dirty() {
+            self.commit(&guard)?;
+        }
+        Ok(result)
+    }
+
+    /// Sets one field and publishes only its archived bytes.
+    ///
+    /// `MemioModel`s hold scalars and fixed arrays only, so their archived
+    /// layout is fixed. When the region holds the current version, the value
+    /// is written at the field's schema offset (`SharedMemoryRegion::patch`)
+    /// and the version bumped: O(field size) instead of serializing and
+    /// copying the whole struct. Otherwise (no region, or a publish deferred
+    /// by `PublishPolicy::OnDemand`) this behaves like `write`.
+    ///
+    /// # Example
+    /// ```ignore
+    /// state.set_field(Player::score_field(), 42)?;
+    /// ```
+    pub fn set_field<V>(&self, field: MemioFieldKey<T, V>, value: V) -> MemioResult<()>
+    where
+        T: MemioSchema,
+        V: MemioFieldValue,
+    {
+        let schema = field.field();
+        if schema.ty != V::TYPE {
+            return Err(MemioError::Internal(format!(
+                "Field `{}` is {:?}, not {:?}",
+                schema.name,
+                schema.ty,
+                V::TYPE
+            )));
+        }
+
+        let mut guard = self.inner.write()?;
+        field.set(&mut guard, value);
+        {
+            let mut shared_guard = self.shared_region.write()?;
+            if let Some(region) = shared_guard.as_mut()
+                && self.published.load(Ordering::Acquire) == self.version()
+                && self.is_demanded(region)
+            {
+                // The archived root sits at the end of the payload
+                let root = region
+                    .info()?
+                    .length
+                    .checked_sub(std::mem::size_of::<rkyv::Archived<T>>())
+                    .ok_or(MemioError::InvalidHeader)?;
+                let offset = root + schema.offset;
+                let version = self.version.fetch_add(1, Ordering::SeqCst) + 1;
+                value.with_archived(|bytes| -> MemioResult<()> {
+                    region.patch(version, offset, bytes)?;
+                    // Keep the cached bytes in step rather than re-serializing
+                    if let Ok(mut cache_guard) = self.cache.write() {
+                        *cache_guard = match cache_guard.take() {
+                            Some((cached, mut data))
+                                if cached + 1 == version && offset + bytes.len() <= data.len() =>
+                            {
+                                data[offset..offset + bytes.len()].copy_from_slice(bytes);
+                                Some((version, data))
+                            }
+                            _ => None,
+                        };
+                    }
+                    Ok(())
+                })?;
+                self.published.store(version, Ordering::Release);
+                *self.content_hash.write()? = None;
+                return Ok(());
+            }
+        }
+        self.commit(&guard)
+    }
+
+    /// Bumps the version for a changed `value` and publishes it (or defers
+    /// the publish) according to the policy. Called with the state locked.
+    fn commit(&self, value: &T) -> MemioResult<()> {
+        let bytes = if self.dedupe {
+            Some(match self.dedupe_bytes(value)? {
+                Some(bytes) => bytes,
+                None => return Ok(()),
+            })
+        } else {
+            None
+        };
         let version = self.version.fetch_add(1, Ordering::SeqCst) + 1;
 
-        let shared_enabled = self.shared_region.read()?.is_some();
+        let (shared_enabled, demanded) = {
+            let shared_guard = self.shared_region.read()?;
+            let demanded = shared_guard.as_ref().is_some_and(|r| self.is_demanded(r));
+            (shared_guard.is_some(), demanded)
+        };
 
-        if shared_enabled {
-            let bytes = serialize_value(&*guard)?;
+        if shared_enabled && demanded {
+            let bytes = match bytes {
+                Some(bytes) => bytes,
+                None => serialize_value(value, &self.size_hint)?,
+            };
+            self.publish(version, bytes)?;
+        } else {
+            // Deferred (or no region): keep the bytes if we already have them
+            self.pending.store(shared_enabled, Ordering::Release);
             if let Ok(mut cache_guard) = self.cache.write() {
-                *cache_guard = Some((version, bytes.clone()));
+                *cache_guard = bytes.map(|bytes| (version, bytes));
             }
-            let mut shared_guard = self.shared_region.write()?;
-            if let Some(region) = shared_guard.as_mut() {
-                region.write(version, &bytes)?;
+        }
+        Ok(())
+    }
+
+    /// Serializes `value` for dedupe mode; `None` if it hashes like the
+    /// current version.
+    #[cfg(feature = "dedupe")]
+    fn dedupe_bytes(&self, value: &T) -> MemioResult<Option<ArchiveBytes>> {
+        let bytes = serialize_value(value, &self.size_hint)?;
+        let hash = xxhash_rust::xxh3::xxh3_64(&bytes);
+        let mut current = self.content_hash.write()?;
+        if *current == Some(hash) {
+            return Ok(None);
+        }
+        *current = Some(hash);
+        Ok(Some(bytes))
+    }
+
+    #[cfg(not(feature = "dedupe"))]
+    fn dedupe_bytes(&self, value: &T) -> MemioResult<Option<ArchiveBytes>> {
+        serialize_value(value, &self.size_hint).map(Some)
+    }
+
+    /// Publishes the latest state if a write was deferred and a reader has
+    /// since consumed the previous publish.
+    ///
+    /// For `PublishPolicy::OnDemand`: call it from a timer or tick loop so
+    /// readers get the final state after writes stop. Costs one atomic load
+    /// when there is nothing to do. Returns the published version, if any.
+    pub fn publish_pending(&self) -> MemioResult<Option<u64>> {
+        if !self.pending.load(Ordering::Acquire) {
+            return Ok(None);
+        }
+        {
+            let shared_guard = self.shared_region.read()?;
+            if !shared_guard.as_ref().is_some_and(|r| self.is_demanded(r)) {
+                return Ok(None);
             }
-        } else if let Ok(mut cache_guard) = self.cache.write() {
-            *cache_guard = None;
         }
 
-        Ok(result)
+        let guard = self.inner.read()?;
+        if !self.pending.load(Ordering::Acquire) {
+            return Ok(None); // Published by a concurrent write
+        }
+        let version = self.version();
+        // `publish` puts the bytes back into the cache
+        let cached = self.cache.write()?.take();
+        let bytes = match cached {
+            Some((cached_version, bytes)) if cached_version == version => bytes,
+            _ => serialize_value(&*guard, &self.size_hint)?,
+        };
+        self.publish(version, bytes)?;
+        Ok(Some(version))
+    }
+
+    /// Returns true if a write is waiting for a reader (see `publish_pending`).
+    pub fn is_publish_pending(&self) -> bool {
+        self.pending.load(Ordering::Acquire)
+    }
+
+    /// True if `region` should be written now under the publish policy.
+    fn is_demanded(&self, region: &R) -> bool {
+        match self.policy {
+            PublishPolicy::Eager => true,
+            PublishPolicy::OnDemand => region
+                .reader_ack()
+                .is_none_or(|ack| ack >= self.published.load(Ordering::Acquire)),
+        }
+    }
+
+    /// Writes the serialized state to the region as `version`, then keeps
+    /// the bytes as the cached archive.
+    fn publish(&self, version: u64, bytes: ArchiveBytes) -> MemioResult<()> {
+        let written = match self.shared_region.write()?.as_mut() {
+            Some(region) => region.write(version, &bytes).map(|_| {
+                self.published.store(version, Ordering::Release);
+                self.pending.store(false, Ordering::Release);
+            }),
+            None => Ok(()),
+        };
+        if let Ok(mut cache_guard) = self.cache.write() {
+            *cache_guard = Some((version, bytes));
+        }
+        written
     }
 
     /// Returns current version number.
@@ -217,11 +493,18 @@ where
             version: AtomicU64::new(0),
             cache: RwLock::new(None),
             shared_region: RwLock::new(None),
+            policy: PublishPolicy::Eager,
+            published: AtomicU64::new(0),
+            pending: AtomicBool::new(false),
+            dedupe: false,
+            content_hash: RwLock::new(None),
+            size_hint: AtomicUsize::new(0),
         }
     }
 }
 
-fn serialize_value<T>(value: &T) -> MemioResult<Vec<u8>>
+/// Archives `value` into a buffer pre-sized from the previous archive.
+fn serialize_value<T>(value: &T, size_hint: &AtomicUsize) -> MemioResult<ArchiveBytes>
 where
     T: Archive
         + for<'a> Serialize<
@@ -232,7 +515,260 @@ where
             >,
         >,
 {
-    let bytes = rkyv::to_bytes::<rkyv::rancor::Error>(value)
+    let buffer = ArchiveBytes::with_capacity(size_hint.load(Ordering::Relaxed));
+    let bytes = rkyv::api::high::to_bytes_in::<_, rkyv::rancor::Error>(value, buffer)
         .map_err(|e| MemioError::Serialization(e.to_string()))?;
-    Ok(bytes.to_vec())
+    size_hint.store(bytes.len(), Ordering::Relaxed);
+    Ok(bytes)
+}
+
+#[cfg(test)]
+pub(crate) mod tests {
+    use super::*;
+    use crate::SharedStateInfo;
+    use crate::schema::{MemioField, MemioFieldType, MemioScalarType};
+    use std::sync::{Arc, Mutex};
+
+    /// In-memory region recording every version written to it.
+    #[derive(Debug, Default, Clone)]
+    pub(crate) struct MockRegion {
+        payload: Arc<Mutex<(u64, Vec<u8>)>>,
+        writes: Arc<Mutex<Vec<u64>>>,
+        ack: Arc<Mutex<Option<u64>>>,
+    }
+
+    impl MockRegion {
+        /// A region whose readers ack, as on Linux.
+        pub(crate) fn acked() -> Self {
+            let region = Self::default();
+            region.set_ack(0);
+            region
+        }
+
+        pub(crate) fn set_ack(&self, version: u64) {
+            *self.ack.lock().unwrap() = Some(version);
+        }
+
+        pub(crate) fn writes(&self) -> Vec<u64> {
+            self.writes.lock().unwrap().clone()
+        }
+
+        pub(crate) fn payload(&self) -> Vec<u8> {
+            self.payload.lock().unwrap().1.clone()
+        }
+    }
+
+    impl SharedMemoryRegion for MockRegion {
+        fn capacity(&self) -> usize {
+            1 << 16
+        }
+
+        fn info(&self) -> Result<SharedStateInfo, MemioError> {
+            let payload = self.payload.lock().unwrap();
+            Ok(SharedStateInfo {
+                version: payload.0,
+                length: payload.1.len(),
+                capacity: 1 << 16,
+                ..Default::default()
+            })
+        }
+
+        fn write(&mut self, version: u64, data: &[u8]) -> Result<SharedStateInfo, MemioError> {
+            self.writes.lock().unwrap().push(version);
+            *self.payload.lock().unwrap() = (version, data.to_vec());
+            self.info()
+        }
+
+        fn read(&self) -> Result<Vec<u8>, MemioError> {
+            Ok(self.payload())
+        }
+
+        unsafe fn data_ptr(&self) -> *const u8 {
+            std::ptr::null()
+        }
+
+        unsafe fn data_ptr_mut(&mut self) -> *mut u8 {
+            std::ptr::null_mut()
+        }
+
+        fn reader_ack(&self) -> Option<u64> {
+            *self.ack.lock().unwrap()
+        }
+    }
+
+    #[derive(Archive, Serialize, Debug, Default)]
+    struct Sample {
+        flag: u8,
+        count: u32,
+        ratio: f64,
+        pos: [u16; 3],
+        delta: i64,
+    }
+
+    // What `#[derive(MemioModel)]` generates
+    impl MemioSchema for Sample {
+        fn schema() -> &'static [MemioField] {
+            static FIELDS: &[MemioField] = &[
+                MemioField {
+                    name: "flag",
+                    offset: std::mem::offset_of!(rkyv::Archived<Sample>, flag),
+                    ty: MemioFieldType::Scalar(MemioScalarType::U8),
+                },
+                MemioField {
+                    name: "count",
+                    offset: std::mem::offset_of!(rkyv::Archived<Sample>, count),
+                    ty: MemioFieldType::Scalar(MemioScalarType::U32),
+                },
+                MemioField {
+                    name: "ratio",
+                    offset: std::mem::offset_of!(rkyv::Archived<Sample>, ratio),
+                    ty: MemioFieldType::Scalar(MemioScalarType::F64),
+                },
+                MemioField {
+                    name: "pos",
+                    offset: std::mem::offset_of!(rkyv::Archived<Sample>, pos),
+                    ty: MemioFieldType::Array {
+                        elem: MemioScalarType::U16,
+                        len: 3,
+                    },
+                },
+                MemioField {
+                    name: "delta",
+                    offset: std::mem::offset_of!(rkyv::Archived<Sample>, delta),
+                    ty: MemioFieldType::Scalar(MemioScalarType::I64),
+                },
+            ];
+            FIELDS
+        }
+    }
+
+    #[test]
+    fn test_on_demand_publishes_once_acked() {
+        let region = MockRegion::acked();
+        let state = MemioState::new_with_region(0u64, region.clone())
+            .with_publish_policy(PublishPolicy::OnDemand);
+        for _ in 0..5 {
+            state.write(|v| *v += 1).unwrap();
+        }
+        // Only the first write publishes until a reader acks it
+        assert_eq!(region.writes(), vec![1]);
+        assert_eq!(state.version(), 5);
+        assert!(state.is_publish_pending());
+        assert_eq!(state.publish_pending().unwrap(), None);
+
+        region.set_ack(1);
+        assert_eq!(state.publish_pending().unwrap(), Some(5));
+        assert_eq!(region.writes(), vec![1, 5]);
+        assert_eq!(region.payload(), state.to_bytes().unwrap());
+        assert!(!state.is_publish_pending());
+        assert_eq!(state.publish_pending().unwrap(), None);
+
+        // Not acked yet: deferred again
+        state.write(|v| *v += 1).unwrap();
+        assert_eq!(region.writes(), vec![1, 5]);
+        assert!(state.is_publish_pending());
+    }
+
+    #[test]
+    fn test_on_demand_is_eager_without_reader_acks() {
+        let region = MockRegion::default();
+        let state = MemioState::new_with_region(0u64, region.clone())
+            .with_publish_policy(PublishPolicy::OnDemand);
+        state.write(|v| *v += 1).unwrap();
+        state.write(|v| *v += 1).unwrap();
+        assert_eq!(region.writes(), vec![1, 2]);
+        assert!(!state.is_publish_pending());
+    }
+
+    #[test]
+    fn test_publish_pending_without_region() {
+        let state = MemioState::new(0u64);
+        state.write(|v| *v += 1).unwrap();
+        assert!(!state.is_publish_pending());
+        assert_eq!(state.publish_pending().unwrap(), None);
+        assert_eq!(state.version(), 1);
+    }
+
+    #[cfg(feature = "dedupe")]
+    #[test]
+    fn test_dedupe_skips_identical_writes() {
+        let region = MockRegion::default();
+        let state = MemioState::new_with_region(0u64, region.clone()).with_dedupe(true);
+        state.write(|v| *v = 1).unwrap();
+        state.write(|v| *v = 1).unwrap();
+        state.write(|v| *v = 2).unwrap();
+        state.write(|v| *v = 2).unwrap();
+        assert_eq!(state.version(), 2);
+        assert_eq!(region.writes(), vec![1, 2]);
+    }
+
+    #[test]
+    fn test_set_field_patches_archived_offsets() {
+        let region = MockRegion::default();
+        let state = MemioState::new_with_region(Sample::default(), region.clone());
+        state.write(|s| s.count = 1).unwrap();
+
+        state
+            .set_field(MemioFieldKey::new(0, |s: &mut Sample, v| s.flag = v), 7u8)
+            .unwrap();
+        state
+            .set_field(
+                MemioFieldKey::new(1, |s: &mut Sample, v| s.count = v),
+                40_000u32,
+            )
+            .unwrap();
+        state
+            .set_field(
+                MemioFieldKey::new(2, |s: &mut Sample, v| s.ratio = v),
+                2.5f64,
+            )
+            .unwrap();
+        state
+            .set_field(
+                MemioFieldKey::new(3, |s: &mut Sample, v| s.pos = v),
+                [1u16, 2, 3],
+            )
+            .unwrap();
+        state
+            .set_field(
+                MemioFieldKey::new(4, |s: &mut Sample, v| s.delta = v),
+                -9i64,
+            )
+            .unwrap();
+
+        // Each field was patched in place, not re-serialized: the region
+        // matches a fresh archive of the state byte for byte
+        assert_eq!(region.writes(), vec![1, 2, 3, 4, 5, 6]);
+        assert_eq!(state.version(), 6);
+        let archived = state.to_bytes().unwrap();
+        assert_eq!(
+            archived.len(),
+            std::mem::size_of::<rkyv::Archived<Sample>>()
+        );
+        assert_eq!(region.payload(), archived);
+        assert_eq!(state.to_bytes_cached().unwrap(), (6, archived));
+
+        // Type mismatch with the schema
+        let wrong = MemioFieldKey::<Sample, u32>::new(0, |_, _| ());
+        assert!(state.set_field(wrong, 1).is_err());
+        assert_eq!(state.version(), 6);
+    }
+
+    #[test]
+    fn test_set_field_deferred_by_on_demand_writes() {
+        let region = MockRegion::acked();
+        let state = MemioState::new_with_region(Sample::default(), region.clone())
+            .with_publish_policy(PublishPolicy::OnDemand);
+        state.write(|s| s.count = 1).unwrap();
+        state
+            .set_field(MemioFieldKey::new(1, |s: &mut Sample, v| s.count = v), 2u32)
+            .unwrap();
+        // Not acked: falls back to a deferred full write
+        assert_eq!(region.writes(), vec![1]);
+        assert!(state.is_publish_pending());
+
+        region.set_ack(1);
+        assert_eq!(state.publish_pending().unwrap(), Some(2));
+        assert_eq!(region.payload(), state.to_bytes().unwrap());
+    }
 }
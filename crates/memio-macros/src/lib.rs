@@ -4,7 +4,7 @@
 //! implements all necessary traits for serialization.
 
 use proc_macro::TokenStream;
-use quote::quote;
+use quote::{format_ident, quote};
 use syn::{Data, DeriveInput, Expr, Fields, Lit, Type, parse_macro_input};
 
 /// Derives all necessary traits for serialization with Rkyv.
@@ -15,6 +15,9 @@ use syn::{Data, DeriveInput, Expr, Fields, Lit, Type, parse_macro_input};
 /// - `rkyv::Deserialize`
 /// - `bytecheck::CheckBytes`
 ///
+/// It also implements `MemioSchema` and generates a `<field>_field()`
+/// accessor per field for `MemioState::set_field`.
+///
 /// # Example
 /// ```ignore
 /// use memio_core::MemioModel;
@@ -34,6 +37,7 @@ pub fn derive_memio_model(input: TokenStream) -> TokenStream {
     let (impl_generics, ty_generics, where_clause) = generics.split_for_impl();
 
     let mut fields_tokens = Vec::new();
+    let mut accessor_tokens = Vec::new();
     let mut errors = Vec::new();
 
     if let Data::Struct(data) = &input.data
@@ -49,6 +53,10 @@ pub fn derive_memio_model(input: TokenStream) -> TokenStream {
                     continue;
                 }
             };
+            let index = fields_tokens.len();
+            let accessor = format_ident!("{}_field", field_ident);
+            let value_ty = &field.ty;
+            let doc = format!("Handle to `{}` for `MemioState::set_field`.", field_name);
             fields_tokens.push(quote! {
                 ::memio_core::MemioField {
                     name: #field_name,
@@ -56,6 +64,12 @@ pub fn derive_memio_model(input: TokenStream) -> TokenStream {
                     ty: #field_ty,
                 }
             });
+            accessor_tokens.push(quote! {
+                #[doc = #doc]
+                pub fn #accessor() -> ::memio_core::MemioFieldKey<Self, #value_ty> {
+                    ::memio_core::MemioFieldKey::new(#index, |model, value| model.#field_ident = value)
+                }
+            });
         }
     }
 
@@ -75,6 +89,11 @@ pub fn derive_memio_model(input: TokenStream) -> TokenStream {
                 FIELDS
             }
         }
+
+        #[allow(dead_code)]
+        impl #impl_generics #name #ty_generics #where_clause {
+            #(#accessor_tokens)*
+        }
     };
 
     TokenStream::from(expanded)
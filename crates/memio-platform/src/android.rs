@@ -137,6 +137,9 @@ impl SharedMemoryRegion for AndroidSharedMemoryRegion {
     unsafe fn data_ptr_mut(&mut self) -> *mut u8 {
         unsafe { self.ptr.add(HEADER_SIZE) }
     }
+
+    // No `reader_ack`: the Android WebView reader never acks, so the trait
+    // default (`None`) keeps `PublishPolicy::OnDemand` publishing eagerly.
 }
 
 #[cfg(target_os = "android")]
@@ -329,6 +332,15 @@ pub fn read_from_shared(name: &str) -> Result<(u64, Vec<u8>), SharedMemoryError>
     Ok((info.version, data))
 }
 
+/// Reads header info of a named memio region without copying the data.
+pub fn read_shared_info(name: &str) -> Result<SharedStateInfo, SharedMemoryError> {
+    let registry = REGISTRY.lock().unwrap();
+    let region = registry
+        .get(name)
+        .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+    region.info()
+}
+
 /// Gets the file descriptor for a named memio region.
 pub fn get_shared_fd(name: &str) -> Result<RawFd, SharedMemoryError> {
     let registry = REGISTRY.lock().unwrap();
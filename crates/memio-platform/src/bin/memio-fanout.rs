@@ -0,0 +1,322 @@
+//! `memio-fanout` - measure write→visible latency as reader processes grow.
+//!
+//! ```text
+//! memio-fanout [--readers 1,2,4,8,16] [--mode both|doorbell|poll]
+//!              [--writes 500] [--size 65536] [--interval-ms 2] [--poll-ms 100]
+//! ```
+//!
+//! Stands in for a multi-window layout: one backend publishes into a
+//! `MemioManager` buffer while N child processes (one per web process)
+//! watch it. Each reader either sleeps on the shared doorbell or polls the
+//! header on a timer like the WebKit extension used to, then copies the
+//! payload once - what a web process does per version. The writer stamps
+//! `CLOCK_MONOTONIC` into the first 8 payload bytes, so latency is measured
+//! across processes.
+//!
+//! Prints one row per (mode, readers): latency percentiles over every
+//! version every reader saw, how many versions each reader saw, and the
+//! writer's mean publish cost (header + payload + doorbell ring).
+
+use std::collections::HashMap;
+use std::process::ExitCode;
+
+use memio_core::MemioError;
+
+fn main() -> ExitCode {
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    let (reader, rest) = match args.first().map(String::as_str) {
+        Some("reader") => (true, &args[1..]),
+        _ => (false, &args[..]),
+    };
+    let options = match parse_options(rest) {
+        Ok(options) => options,
+        Err(e) => {
+            eprintln!("memio-fanout: {}\n\n{}", e, USAGE);
+            return ExitCode::from(2);
+        }
+    };
+
+    let result = if reader {
+        run_reader(&options)
+    } else {
+        run_bench(&options)
+    };
+    match result {
+        Ok(()) => ExitCode::SUCCESS,
+        Err(e) => {
+            eprintln!("memio-fanout: {}", e);
+            ExitCode::FAILURE
+        }
+    }
+}
+
+const USAGE: &str = "usage:
+  memio-fanout [--readers 1,2,4,8,16] [--mode both|doorbell|poll] [--writes N] [--size BYTES] [--interval-ms N] [--poll-ms N]";
+
+fn parse_options(args: &[String]) -> Result<HashMap<String, String>, String> {
+    let mut options = HashMap::new();
+    let mut iter = args.iter();
+    while let Some(flag) = iter.next() {
+        let key = flag
+            .strip_prefix("--")
+            .ok_or_else(|| format!("unexpected argument '{}'", flag))?;
+        let value = iter
+            .next()
+            .ok_or_else(|| format!("missing value for --{}", key))?;
+        options.insert(key.to_string(), value.clone());
+    }
+    Ok(options)
+}
+
+fn number<T: std::str::FromStr>(
+    options: &HashMap<String, String>,
+    key: &str,
+    default: T,
+) -> Result<T, MemioError> {
+    match options.get(key) {
+        Some(v) => v
+            .parse()
+            .map_err(|_| MemioError::Internal(format!("invalid value for --{}: {}", key, v))),
+        None => Ok(default),
+    }
+}
+
+#[cfg(target_os = "linux")]
+use linux::{run_bench, run_reader};
+
+#[cfg(not(target_os = "linux"))]
+fn run_bench(_options: &HashMap<String, String>) -> Result<(), MemioError> {
+    // The doorbell is a Linux futex; other platforms have nothing to compare.
+    Err(MemioError::PlatformNotSupported)
+}
+
+#[cfg(not(target_os = "linux"))]
+fn run_reader(_options: &HashMap<String, String>) -> Result<(), MemioError> {
+    Err(MemioError::PlatformNotSupported)
+}
+
+#[cfg(target_os = "linux")]
+mod linux {
+    use std::collections::HashMap;
+    use std::io::{BufRead, BufReader};
+    use std::process::{Child, ChildStdout, Command, Stdio};
+    use std::time::{Duration, Instant};
+
+    use memio_core::{MemioError, SHARED_STATE_HEADER_SIZE, read_header};
+    use memio_platform::{Doorbell, MemioManager};
+
+    use super::number;
+
+    const BUFFER: &str = "fanout";
+
+    /// Nanoseconds on the system-wide monotonic clock, comparable across
+    /// processes (unlike `Instant`).
+    fn monotonic_ns() -> u64 {
+        let mut ts = libc::timespec {
+            tv_sec: 0,
+            tv_nsec: 0,
+        };
+        // SAFETY: `ts` is a valid out-pointer.
+        unsafe {
+            libc::clock_gettime(libc::CLOCK_MONOTONIC, &mut ts);
+        }
+        ts.tv_sec as u64 * 1_000_000_000 + ts.tv_nsec as u64
+    }
+
+    pub fn run_bench(options: &HashMap<String, String>) -> Result<(), MemioError> {
+        let counts: Vec<usize> = options
+            .get("readers")
+            .map(String::as_str)
+            .unwrap_or("1,2,4,8,16")
+            .split(',')
+            .map(|n| {
+                n.trim()
+                    .parse()
+                    .map_err(|_| MemioError::Internal(format!("invalid reader count: {}", n)))
+            })
+            .collect::<Result<_, _>>()?;
+        let modes: &[&str] = match options.get("mode").map(String::as_str) {
+            None | Some("both") => &["poll", "doorbell"],
+            Some("doorbell") => &["doorbell"],
+            Some("poll") => &["poll"],
+            Some(other) => {
+                return Err(MemioError::Internal(format!("unknown --mode {}", other)));
+            }
+        };
+        let writes = number(options, "writes", 500u64)?;
+        let size = number(options, "size", 64 * 1024usize)?.max(8);
+        let interval = Duration::from_millis(number(options, "interval-ms", 2u64)?);
+        let poll_ms = number(options, "poll-ms", 100u64)?;
+
+        println!(
+            "{:<9} {:>7} {:>10} {:>10} {:>10} {:>12} {:>12}",
+            "mode", "readers", "p50 us", "p99 us", "max us", "seen/reader", "publish us"
+        );
+        for mode in modes {
+            for &readers in &counts {
+                let row = run_round(mode, readers, writes, size, interval, poll_ms)?;
+                println!(
+                    "{:<9} {:>7} {:>10.1} {:>10.1} {:>10.1} {:>12.1} {:>12.2}",
+                    mode,
+                    readers,
+                    row.p50_us,
+                    row.p99_us,
+                    row.max_us,
+                    row.seen_per_reader,
+                    row.publish_us
+                );
+            }
+        }
+        Ok(())
+    }
+
+    struct Row {
+        p50_us: f64,
+        p99_us: f64,
+        max_us: f64,
+        seen_per_reader: f64,
+        publish_us: f64,
+    }
+
+    fn run_round(
+        mode: &str,
+        readers: usize,
+        writes: u64,
+        size: usize,
+        interval: Duration,
+        poll_ms: u64,
+    ) -> Result<Row, MemioError> {
+        // A fresh manager per round: new buffer, new doorbell, no stale waiters
+        let manager = MemioManager::new()?;
+        manager.create_buffer(BUFFER, size)?;
+        let buffer = manager
+            .info(BUFFER)?
+            .path
+            .ok_or_else(|| MemioError::Internal("buffer has no path".into()))?;
+        let doorbell = manager
+            .doorbell()
+            .ok_or_else(|| MemioError::Internal("doorbell unavailable".into()))?;
+
+        let exe = std::env::current_exe()?;
+        let mut children: Vec<(Child, BufReader<ChildStdout>)> = Vec::with_capacity(readers);
+        for _ in 0..readers {
+            let mut child = Command::new(&exe)
+                .arg("reader")
+                .args(["--buffer", &buffer.to_string_lossy()])
+                .args(["--doorbell", &doorbell.path().to_string_lossy()])
+                .args(["--mode", mode])
+                .args(["--writes", &writes.to_string()])
+                .args(["--poll-ms", &poll_ms.to_string()])
+                .stdout(Stdio::piped())
+                .spawn()?;
+            let stdout = child
+                .stdout
+                .take()
+                .ok_or_else(|| MemioError::Internal("reader has no stdout".into()))?;
+            children.push((child, BufReader::new(stdout)));
+        }
+
+        // Every reader prints "ready" once it is attached
+        for (_, out) in &mut children {
+            let mut line = String::new();
+            out.read_line(&mut line)?;
+            if line.trim() != "ready" {
+                return Err(MemioError::Internal(format!(
+                    "reader failed: {}",
+                    line.trim()
+                )));
+            }
+        }
+
+        let mut payload = vec![0u8; size];
+        let mut publish = Duration::ZERO;
+        for version in 1..=writes {
+            payload[..8].copy_from_slice(&monotonic_ns().to_le_bytes());
+            let start = Instant::now();
+            manager.write(BUFFER, version, &payload)?;
+            publish += start.elapsed();
+            std::thread::sleep(interval);
+        }
+
+        let mut latencies = Vec::new();
+        for (mut child, out) in children {
+            for line in out.lines() {
+                if let Ok(ns) = line?.trim().parse::<u64>() {
+                    latencies.push(ns);
+                }
+            }
+            child.wait()?;
+        }
+
+        latencies.sort_unstable();
+        let percentile = |p: f64| -> f64 {
+            if latencies.is_empty() {
+                return 0.0;
+            }
+            let index = ((latencies.len() - 1) as f64 * p).round() as usize;
+            latencies[index] as f64 / 1000.0
+        };
+        Ok(Row {
+            p50_us: percentile(0.50),
+            p99_us: percentile(0.99),
+            max_us: percentile(1.0),
+            seen_per_reader: latencies.len() as f64 / readers as f64,
+            publish_us: publish.as_secs_f64() * 1e6 / writes.max(1) as f64,
+        })
+    }
+
+    /// One simulated web process: wait, check the header, copy once per
+    /// new version, print the latency of each version seen.
+    pub fn run_reader(options: &HashMap<String, String>) -> Result<(), MemioError> {
+        let buffer = options
+            .get("buffer")
+            .ok_or_else(|| MemioError::Internal("--buffer is required".into()))?;
+        let doorbell_path = options
+            .get("doorbell")
+            .ok_or_else(|| MemioError::Internal("--doorbell is required".into()))?;
+        let doorbell_mode = options.get("mode").map(String::as_str) == Some("doorbell");
+        let writes = number(options, "writes", 500u64)?;
+        let poll = Duration::from_millis(number(options, "poll-ms", 100u64)?);
+
+        let file = std::fs::File::open(buffer)?;
+        let map = unsafe { memmap2::Mmap::map(&file).map_err(|_| MemioError::MmapFailed)? };
+        let capacity = map.len() - SHARED_STATE_HEADER_SIZE;
+        let doorbell = Doorbell::open(doorbell_path)?;
+        let mut copy = vec![0u8; capacity];
+        let mut out = String::new();
+
+        println!("ready");
+        let mut seen_sequence = doorbell.sequence();
+        let mut last_version = 0;
+        // Give up if the writer goes quiet, e.g. it crashed
+        let mut idle = Instant::now();
+        while last_version < writes && idle.elapsed() < Duration::from_secs(10) {
+            if doorbell_mode {
+                seen_sequence = doorbell.wait(seen_sequence, Some(Duration::from_secs(1)));
+            } else {
+                std::thread::sleep(poll);
+            }
+
+            let Some((version, length)) = read_header(&map, capacity) else {
+                continue;
+            };
+            if version == last_version {
+                continue;
+            }
+            copy[..length]
+                .copy_from_slice(&map[SHARED_STATE_HEADER_SIZE..SHARED_STATE_HEADER_SIZE + length]);
+            let visible = monotonic_ns();
+            if read_header(&map, capacity).map(|h| h.0) != Some(version) || length < 8 {
+                continue; // Torn: pick it up on the next round
+            }
+
+            let written = u64::from_le_bytes(copy[..8].try_into().unwrap_or_default());
+            out.push_str(&visible.saturating_sub(written).to_string());
+            out.push('\n');
+            last_version = version;
+            idle = Instant::now();
+        }
+        print!("{}", out);
+        Ok(())
+    }
+}
@@ -0,0 +1,206 @@
+//! `memio-rec` - record and replay memio buffer version streams.
+//!
+//! ```text
+//! memio-rec record --out session.memrec [--registry PATH] [--names a,b]
+//!                  [--interval-ms 1] [--duration-s 60] [--keyframe 64]
+//! memio-rec play   --in session.memrec [--speed 1.0] [--capacity BYTES] [--hold-s 0]
+//! memio-rec info   --in session.memrec
+//! ```
+//!
+//! `record` attaches to a running app through its registry manifest
+//! (`--registry` or `MEMIO_SHARED_REGISTRY`). `play` republishes into a
+//! fresh `MemioManager` and prints its manifest path so consumers can
+//! attach; `--speed 0` plays as fast as possible.
+
+use std::collections::{BTreeMap, HashMap};
+use std::process::ExitCode;
+use std::time::Duration;
+
+use memio_core::MemioError;
+use memio_platform::MemioManager;
+use memio_platform::recording::{Player, RecordingReader};
+
+fn main() -> ExitCode {
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    let Some(command) = args.first() else {
+        eprintln!("{}", USAGE);
+        return ExitCode::from(2);
+    };
+    let options = match parse_options(&args[1..]) {
+        Ok(options) => options,
+        Err(e) => {
+            eprintln!("memio-rec: {}\n\n{}", e, USAGE);
+            return ExitCode::from(2);
+        }
+    };
+
+    let result = match command.as_str() {
+        "record" => record(&options),
+        "play" => play(&options),
+        "info" => info(&options),
+        _ => {
+            eprintln!("{}", USAGE);
+            return ExitCode::from(2);
+        }
+    };
+
+    match result {
+        Ok(()) => ExitCode::SUCCESS,
+        Err(e) => {
+            eprintln!("memio-rec: {}", e);
+            ExitCode::FAILURE
+        }
+    }
+}
+
+const USAGE: &str = "usage:
+  memio-rec record --out FILE [--registry PATH] [--names a,b] [--interval-ms N] [--duration-s N] [--keyframe N]
+  memio-rec play   --in FILE [--speed X] [--capacity BYTES] [--hold-s N]
+  memio-rec info   --in FILE";
+
+fn parse_options(args: &[String]) -> Result<HashMap<String, String>, String> {
+    let mut options = HashMap::new();
+    let mut iter = args.iter();
+    while let Some(flag) = iter.next() {
+        let key = flag
+            .strip_prefix("--")
+            .ok_or_else(|| format!("unexpected argument '{}'", flag))?;
+        let value = iter
+            .next()
+            .ok_or_else(|| format!("missing value for --{}", key))?;
+        options.insert(key.to_string(), value.clone());
+    }
+    Ok(options)
+}
+
+fn required<'a>(options: &'a HashMap<String, String>, key: &str) -> Result<&'a str, MemioError> {
+    options
+        .get(key)
+        .map(String::as_str)
+        .ok_or_else(|| MemioError::Internal(format!("--{} is required", key)))
+}
+
+fn number<T: std::str::FromStr>(
+    options: &HashMap<String, String>,
+    key: &str,
+    default: T,
+) -> Result<T, MemioError> {
+    match options.get(key) {
+        Some(v) => v
+            .parse()
+            .map_err(|_| MemioError::Internal(format!("invalid value for --{}: {}", key, v))),
+        None => Ok(default),
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn record(options: &HashMap<String, String>) -> Result<(), MemioError> {
+    use memio_platform::recording::{DEFAULT_KEYFRAME_INTERVAL, Recorder, RegistrySource};
+    use std::time::Instant;
+
+    let out = required(options, "out")?;
+    let interval = Duration::from_millis(number(options, "interval-ms", 1u64)?);
+    let duration = options
+        .get("duration-s")
+        .map(|_| number(options, "duration-s", 0u64).map(Duration::from_secs))
+        .transpose()?;
+    let keyframe = number(options, "keyframe", DEFAULT_KEYFRAME_INTERVAL)?;
+
+    let mut source = match options.get("registry") {
+        Some(path) => RegistrySource::new(path),
+        None => RegistrySource::from_env()?,
+    };
+    let fixed_names: Option<Vec<String>> = options
+        .get("names")
+        .map(|n| n.split(',').map(|s| s.trim().to_string()).collect());
+
+    let mut recorder = Recorder::create(out)?.with_keyframe_interval(keyframe);
+    let start = Instant::now();
+    let mut last_report = Instant::now();
+    eprintln!("memio-rec: recording to {}", out);
+
+    while duration.is_none_or(|d| start.elapsed() < d) {
+        let names = match &fixed_names {
+            Some(names) => names.clone(),
+            None => source.names()?,
+        };
+        source.poll_into(&mut recorder, &names)?;
+
+        if last_report.elapsed() >= Duration::from_secs(1) {
+            recorder.flush()?;
+            eprintln!(
+                "memio-rec: {} records, {} bytes",
+                recorder.records(),
+                recorder.bytes_written()
+            );
+            last_report = Instant::now();
+        }
+        std::thread::sleep(interval);
+    }
+
+    recorder.flush()?;
+    eprintln!(
+        "memio-rec: done, {} records, {} bytes",
+        recorder.records(),
+        recorder.bytes_written()
+    );
+    Ok(())
+}
+
+#[cfg(not(target_os = "linux"))]
+fn record(_options: &HashMap<String, String>) -> Result<(), MemioError> {
+    // Other platforms have no cross-process registry manifest to attach to;
+    // use memio_platform::recording::Recorder in-process instead.
+    Err(MemioError::PlatformNotSupported)
+}
+
+fn play(options: &HashMap<String, String>) -> Result<(), MemioError> {
+    let input = required(options, "in")?;
+    let speed = number(options, "speed", 1.0f64)?;
+    let hold = Duration::from_secs(number(options, "hold-s", 0u64)?);
+
+    let player = Player::open(input)?.with_speed(speed);
+    let largest = player
+        .reader()
+        .frames()
+        .map(|f| f.data.len())
+        .max()
+        .unwrap_or(0);
+    let capacity = number(options, "capacity", largest)?;
+
+    let manager = MemioManager::new()?;
+    if let Some(path) = manager.get_registry_path() {
+        println!("MEMIO_SHARED_REGISTRY={}", path.display());
+    }
+
+    let stats = player.play_to_manager(&manager, capacity)?;
+    eprintln!(
+        "memio-rec: played {} frames ({} bytes) in {:?}, max lag {:?}",
+        stats.frames, stats.bytes, stats.elapsed, stats.max_lag
+    );
+    std::thread::sleep(hold);
+    Ok(())
+}
+
+fn info(options: &HashMap<String, String>) -> Result<(), MemioError> {
+    let input = required(options, "in")?;
+    let reader = RecordingReader::open(input)?;
+
+    let mut per_buffer: BTreeMap<String, (u64, u64, Duration)> = BTreeMap::new();
+    let mut last = Duration::ZERO;
+    for frame in reader.frames() {
+        let entry = per_buffer.entry(frame.name).or_default();
+        entry.0 += 1;
+        entry.1 += frame.data.len() as u64;
+        entry.2 = frame.timestamp;
+        last = last.max(frame.timestamp);
+    }
+
+    let file_len = std::fs::metadata(input)?.len();
+    println!("file: {} ({} bytes)", input, file_len);
+    println!("duration: {:?}", last);
+    for (name, (frames, bytes, _)) in &per_buffer {
+        println!("  {}: {} versions, {} decoded bytes", name, frames, bytes);
+    }
+    Ok(())
+}
@@ -0,0 +1,173 @@
+//! `memio-rpc-bench` - echo round trips per second over the shared RPC rings.
+//!
+//! ```text
+//! memio-rpc-bench [--calls 100000] [--batches 1,16,64,256] [--size 64]
+//! ```
+//!
+//! Plays the web process against an in-process `RpcChannel`: writes a batch
+//! of echo frames into the request ring, rings the doorbell, sleeps on the
+//! doorbell until every response arrived, repeats. Batch 1 is the cost of
+//! one call per round trip; larger batches show what coalescing saves.
+//! Prints calls/s and mean round-trip time per batch size.
+
+use std::collections::HashMap;
+use std::process::ExitCode;
+
+use memio_core::MemioError;
+
+fn main() -> ExitCode {
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    let options = match parse_options(&args) {
+        Ok(options) => options,
+        Err(e) => {
+            eprintln!("memio-rpc-bench: {}\n\n{}", e, USAGE);
+            return ExitCode::from(2);
+        }
+    };
+    match run_bench(&options) {
+        Ok(()) => ExitCode::SUCCESS,
+        Err(e) => {
+            eprintln!("memio-rpc-bench: {}", e);
+            ExitCode::FAILURE
+        }
+    }
+}
+
+const USAGE: &str = "usage:
+  memio-rpc-bench [--calls N] [--batches 1,16,64,256] [--size BYTES]";
+
+fn parse_options(args: &[String]) -> Result<HashMap<String, String>, String> {
+    let mut options = HashMap::new();
+    let mut iter = args.iter();
+    while let Some(flag) = iter.next() {
+        let key = flag
+            .strip_prefix("--")
+            .ok_or_else(|| format!("unexpected argument '{}'", flag))?;
+        let value = iter
+            .next()
+            .ok_or_else(|| format!("missing value for --{}", key))?;
+        options.insert(key.to_string(), value.clone());
+    }
+    Ok(options)
+}
+
+fn number<T: std::str::FromStr>(
+    options: &HashMap<String, String>,
+    key: &str,
+    default: T,
+) -> Result<T, MemioError> {
+    match options.get(key) {
+        Some(v) => v
+            .parse()
+            .map_err(|_| MemioError::Internal(format!("invalid value for --{}: {}", key, v))),
+        None => Ok(default),
+    }
+}
+
+#[cfg(target_os = "linux")]
+use linux::run_bench;
+
+#[cfg(not(target_os = "linux"))]
+fn run_bench(_options: &HashMap<String, String>) -> Result<(), MemioError> {
+    // RpcChannel (rings + doorbell) is Linux-only.
+    Err(MemioError::PlatformNotSupported)
+}
+
+#[cfg(target_os = "linux")]
+mod linux {
+    use std::collections::HashMap;
+    use std::sync::Arc;
+    use std::time::{Duration, Instant};
+
+    use memio_core::MemioError;
+    use memio_core::rpc::{RpcFrames, push_frame};
+    use memio_platform::{Doorbell, RPC_METHOD_ECHO, RpcChannel, RpcDispatcher, SharedRingBuffer};
+
+    use super::number;
+
+    /// Ring size per direction, as the plugin opens them.
+    const CAPACITY: usize = 1024 * 1024;
+
+    pub fn run_bench(options: &HashMap<String, String>) -> Result<(), MemioError> {
+        let calls: usize = number(options, "calls", 100_000)?;
+        let size: usize = number(options, "size", 64)?;
+        let batches = options
+            .get("batches")
+            .map(String::as_str)
+            .unwrap_or("1,16,64,256")
+            .split(',')
+            .map(|n| {
+                n.trim()
+                    .parse::<usize>()
+                    .ok()
+                    .filter(|&n| n > 0)
+                    .ok_or_else(|| MemioError::Internal(format!("invalid batch size: {}", n)))
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+
+        let doorbell = Arc::new(Doorbell::create()?);
+        let channel = RpcChannel::open(
+            Arc::new(RpcDispatcher::new()),
+            CAPACITY,
+            Some(doorbell.clone()),
+        )?;
+        let mut requests = SharedRingBuffer::open(channel.request_path())?;
+        let mut responses = SharedRingBuffer::open(channel.response_path())?;
+
+        println!("calls={} payload={}B ring={}B", calls, size, CAPACITY);
+        println!("{:>6} {:>12} {:>14}", "batch", "calls/s", "round-trip µs");
+
+        let payload = vec![0x5au8; size];
+        let mut frames = Vec::new();
+        let mut input = vec![0u8; CAPACITY];
+        for batch in batches {
+            let rounds = calls.div_ceil(batch);
+            let start = Instant::now();
+            for round in 0..rounds {
+                frames.clear();
+                for i in 0..batch {
+                    push_frame(
+                        &mut frames,
+                        (round * batch + i) as u32,
+                        RPC_METHOD_ECHO,
+                        0,
+                        &payload,
+                    );
+                }
+                if !requests.try_write_all(&[&frames])? {
+                    return Err(MemioError::Internal(format!(
+                        "batch of {} bytes does not fit the request ring",
+                        frames.len()
+                    )));
+                }
+                doorbell.ring();
+
+                let mut answered = 0;
+                let mut pending = 0;
+                while answered < batch {
+                    let seen = doorbell.sequence();
+                    let read = responses.read(&mut input[pending..])?;
+                    if read == 0 {
+                        doorbell.wait(seen, Some(Duration::from_millis(100)));
+                        continue;
+                    }
+                    pending += read;
+                    let mut parsed = RpcFrames::new(&input[..pending]);
+                    answered += parsed.by_ref().count();
+                    let consumed = parsed.consumed();
+                    input.copy_within(consumed..pending, 0);
+                    pending -= consumed;
+                }
+            }
+            let elapsed = start.elapsed().as_secs_f64();
+            let total = rounds * batch;
+            println!(
+                "{:>6} {:>12.0} {:>14.1}",
+                batch,
+                total as f64 / elapsed,
+                elapsed * 1e6 / rounds as f64
+            );
+        }
+        Ok(())
+    }
+}
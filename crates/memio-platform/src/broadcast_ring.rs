@@ -0,0 +1,606 @@
+//! Multi-consumer broadcast ring.
+//!
+//! One writer publishes length-prefixed records; every attached reader sees
+//! every record. `SharedRingBuffer` has a single tail, so it has exactly one
+//! consumer. Here each reader owns a slot in a fixed table after the header,
+//! holding its own cursor and a heartbeat:
+//!
+//! ```text
+//! [header: magic capacity head tail slots data][slot 0] .. [slot N-1][data ...]
+//! slot: [owner u64][cursor u64][heartbeat u64][reserved u64]
+//! ```
+//!
+//! - `head` is the write position. The writer moves `tail` to the slowest
+//!   live reader's cursor before each publish, so space is only reused once
+//!   every reader consumed it; when a reader lags, `publish` returns false
+//!   (backpressure) instead of overwriting.
+//! - Heartbeats are `CLOCK_MONOTONIC` milliseconds. Readers refresh theirs on
+//!   every `next`; a reader silent for longer than the writer's timeout is
+//!   evicted (its slot freed) so a crashed WebView cannot stall the stream.
+//! - Slots are released by zeroing the heartbeat before the owner, so the
+//!   writer ignores a slot with a zero heartbeat, and also a cursor more than
+//!   `capacity` behind `head` (a reader still attaching).
+//!
+//! The layout is shared with the WebKit extension
+//! (`shared/shared_broadcast_spec.json`).
+
+use std::fs::OpenOptions;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, OnceLock};
+use std::time::Duration;
+
+use memmap2::MmapMut;
+
+use memio_core::shared_broadcast_spec::*;
+use memio_core::{MemioError, MemioResult};
+
+use crate::doorbell::Doorbell;
+
+static BROADCAST_COUNTER: AtomicU64 = AtomicU64::new(0);
+static READER_COUNTER: AtomicU64 = AtomicU64::new(0);
+
+/// Default number of reader slots for a new broadcast ring.
+pub const DEFAULT_BROADCAST_SLOTS: usize = 16;
+
+/// Default time after which a silent reader is evicted.
+pub const DEFAULT_READER_TIMEOUT: Duration = Duration::from_secs(5);
+
+/// A reader slot as seen by the writer.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct BroadcastReaderInfo {
+    pub slot: usize,
+    pub owner: u64,
+    /// Bytes published but not yet consumed by this reader
+    pub lag: usize,
+    /// `CLOCK_MONOTONIC` milliseconds of the last heartbeat
+    pub heartbeat: u64,
+}
+
+/// Header and slot table access shared by the writer and readers.
+struct Mapping {
+    path: PathBuf,
+    mmap: MmapMut,
+    capacity: usize,
+    slots: usize,
+    data_offset: usize,
+}
+
+// SAFETY: shared words are only accessed through atomics; the data area is
+// written by the single writer in the ranges no live reader is reading.
+unsafe impl Send for Mapping {}
+unsafe impl Sync for Mapping {}
+
+impl Mapping {
+    fn open(path: PathBuf) -> MemioResult<Self> {
+        let file = OpenOptions::new().read(true).write(true).open(&path)?;
+        let size = file.metadata()?.len() as usize;
+        if size < BROADCAST_HEADER_SIZE {
+            return Err(MemioError::InvalidHeader);
+        }
+        let mmap = unsafe { MmapMut::map_mut(&file).map_err(|_| MemioError::MmapFailed)? };
+
+        let get = |offset: usize| {
+            u64::from_le_bytes(mmap[offset..offset + 8].try_into().unwrap()) as usize
+        };
+        let magic = get(BROADCAST_MAGIC_OFFSET) as u64;
+        let capacity = get(BROADCAST_CAPACITY_OFFSET);
+        let slots = get(BROADCAST_SLOTS_OFFSET);
+        let data_offset = get(BROADCAST_DATA_OFFSET);
+        if magic != BROADCAST_MAGIC
+            || data_offset != BROADCAST_HEADER_SIZE + slots * BROADCAST_SLOT_SIZE
+            || data_offset + capacity != size
+        {
+            return Err(MemioError::InvalidHeader);
+        }
+
+        Ok(Self {
+            path,
+            mmap,
+            capacity,
+            slots,
+            data_offset,
+        })
+    }
+
+    fn word(&self, offset: usize) -> &AtomicU64 {
+        unsafe { &*(self.mmap.as_ptr().add(offset) as *const AtomicU64) }
+    }
+
+    fn slot_word(&self, slot: usize, field: usize) -> &AtomicU64 {
+        self.word(BROADCAST_HEADER_SIZE + slot * BROADCAST_SLOT_SIZE + field)
+    }
+
+    fn head(&self) -> &AtomicU64 {
+        self.word(BROADCAST_HEAD_OFFSET)
+    }
+
+    fn tail(&self) -> &AtomicU64 {
+        self.word(BROADCAST_TAIL_OFFSET)
+    }
+
+    /// Copies `data` to stream position `pos`, wrapping at the end.
+    fn copy_in(&self, pos: u64, data: &[u8]) {
+        let at = (pos % self.capacity as u64) as usize;
+        let first = data.len().min(self.capacity - at);
+        unsafe {
+            let base = self.mmap.as_ptr().add(self.data_offset) as *mut u8;
+            std::ptr::copy_nonoverlapping(data.as_ptr(), base.add(at), first);
+            std::ptr::copy_nonoverlapping(data.as_ptr().add(first), base, data.len() - first);
+        }
+    }
+
+    /// Copies `out.len()` bytes from stream position `pos`, wrapping at the end.
+    fn copy_out(&self, pos: u64, out: &mut [u8]) {
+        let at = (pos % self.capacity as u64) as usize;
+        let first = out.len().min(self.capacity - at);
+        unsafe {
+            let base = self.mmap.as_ptr().add(self.data_offset);
+            std::ptr::copy_nonoverlapping(base.add(at), out.as_mut_ptr(), first);
+            std::ptr::copy_nonoverlapping(base, out.as_mut_ptr().add(first), out.len() - first);
+        }
+    }
+}
+
+/// Writer side of a broadcast ring.
+pub struct BroadcastRing {
+    map: Mapping,
+    timeout_ms: u64,
+    /// Serializes publishers; the ring itself has one producer
+    write_lock: Mutex<()>,
+    doorbell: OnceLock<Arc<Doorbell>>,
+}
+
+impl std::fmt::Debug for BroadcastRing {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("BroadcastRing")
+            .field("path", &self.map.path)
+            .field("capacity", &self.map.capacity)
+            .field("slots", &self.map.slots)
+            .finish()
+    }
+}
+
+impl BroadcastRing {
+    /// Creates a ring in `/dev/shm` with `capacity` data bytes and room for
+    /// `slots` concurrent readers.
+    pub fn create(capacity: usize, slots: usize) -> MemioResult<Self> {
+        Self::create_in("/dev/shm", capacity, slots)
+    }
+
+    /// Creates a ring under a custom base directory.
+    pub fn create_in(base: impl AsRef<Path>, capacity: usize, slots: usize) -> MemioResult<Self> {
+        if capacity <= BROADCAST_RECORD_HEADER_SIZE || slots == 0 {
+            return Err(MemioError::InvalidCapacity);
+        }
+
+        let pid = std::process::id();
+        let nonce = BROADCAST_COUNTER.fetch_add(1, Ordering::Relaxed);
+        let path = base
+            .as_ref()
+            .join(format!("memio_bcast_{}_{}.bin", pid, nonce));
+        let data_offset = BROADCAST_HEADER_SIZE + slots * BROADCAST_SLOT_SIZE;
+
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(&path)
+            .map_err(|e| MemioError::CreateFailed(e.to_string()))?;
+        file.set_len((data_offset + capacity) as u64)
+            .map_err(|e| MemioError::CreateFailed(e.to_string()))?;
+
+        let mut mmap = unsafe { MmapMut::map_mut(&file).map_err(|_| MemioError::MmapFailed)? };
+        let put = |buf: &mut [u8], offset: usize, value: u64| {
+            buf[offset..offset + 8].copy_from_slice(&value.to_le_bytes());
+        };
+        put(&mut mmap, BROADCAST_CAPACITY_OFFSET, capacity as u64);
+        put(&mut mmap, BROADCAST_SLOTS_OFFSET, slots as u64);
+        put(&mut mmap, BROADCAST_DATA_OFFSET, data_offset as u64);
+        // Magic last: readers reject the file until the header is complete
+        put(&mut mmap, BROADCAST_MAGIC_OFFSET, BROADCAST_MAGIC);
+
+        Ok(Self {
+            map: Mapping {
+                path,
+                mmap,
+                capacity,
+                slots,
+                data_offset,
+            },
+            timeout_ms: DEFAULT_READER_TIMEOUT.as_millis() as u64,
+            write_lock: Mutex::new(()),
+            doorbell: OnceLock::new(),
+        })
+    }
+
+    /// Sets how long a reader may go without a heartbeat before eviction.
+    pub fn with_reader_timeout(mut self, timeout: Duration) -> Self {
+        self.timeout_ms = timeout.as_millis() as u64;
+        self
+    }
+
+    /// Rings `doorbell` after every publish.
+    pub fn set_doorbell(&self, doorbell: Arc<Doorbell>) {
+        let _ = self.doorbell.set(doorbell);
+    }
+
+    /// Returns the path readers attach to.
+    pub fn path(&self) -> &Path {
+        &self.map.path
+    }
+
+    /// Returns the data capacity in bytes.
+    pub fn capacity(&self) -> usize {
+        self.map.capacity
+    }
+
+    /// Returns the size of the reader slot table.
+    pub fn slots(&self) -> usize {
+        self.map.slots
+    }
+
+    /// Appends one record for every attached reader.
+    ///
+    /// Returns false when the slowest live reader has not consumed enough
+    /// to make room; the caller decides whether to retry, drop or coalesce.
+    /// With no readers attached the record is accepted and discarded.
+    pub fn publish(&self, record: &[u8]) -> MemioResult<bool> {
+        let needed = BROADCAST_RECORD_HEADER_SIZE + record.len();
+        if needed > self.map.capacity || record.len() > u32::MAX as usize {
+            return Err(MemioError::DataTooLarge {
+                data_len: record.len(),
+                capacity: self.map.capacity - BROADCAST_RECORD_HEADER_SIZE,
+            });
+        }
+
+        let _guard = self.write_lock.lock()?;
+        let head = self.map.head().load(Ordering::Acquire);
+        let tail = self.collect(head);
+        if head.wrapping_sub(tail) as usize + needed > self.map.capacity {
+            return Ok(false);
+        }
+
+        self.map.copy_in(head, &(record.len() as u32).to_le_bytes());
+        self.map.copy_in(
+            head.wrapping_add(BROADCAST_RECORD_HEADER_SIZE as u64),
+            record,
+        );
+        self.map
+            .head()
+            .store(head.wrapping_add(needed as u64), Ordering::Release);
+        if let Some(doorbell) = self.doorbell.get() {
+            doorbell.ring();
+        }
+        Ok(true)
+    }
+
+    /// Lists the attached readers.
+    pub fn readers(&self) -> Vec<BroadcastReaderInfo> {
+        let head = self.map.head().load(Ordering::Acquire);
+        (0..self.map.slots)
+            .filter_map(|slot| {
+                let owner = self
+                    .map
+                    .slot_word(slot, BROADCAST_SLOT_OWNER_OFFSET)
+                    .load(Ordering::Acquire);
+                (owner != 0).then(|| BroadcastReaderInfo {
+                    slot,
+                    owner,
+                    lag: head.wrapping_sub(
+                        self.map
+                            .slot_word(slot, BROADCAST_SLOT_CURSOR_OFFSET)
+                            .load(Ordering::Acquire),
+                    ) as usize,
+                    heartbeat: self
+                        .map
+                        .slot_word(slot, BROADCAST_SLOT_HEARTBEAT_OFFSET)
+                        .load(Ordering::Acquire),
+                })
+            })
+            .collect()
+    }
+
+    /// Evicts stale readers and moves `tail` to the slowest live cursor.
+    fn collect(&self, head: u64) -> u64 {
+        let now = monotonic_ms();
+        let mut tail = head;
+        for slot in 0..self.map.slots {
+            let owner = self.map.slot_word(slot, BROADCAST_SLOT_OWNER_OFFSET);
+            let current = owner.load(Ordering::Acquire);
+            if current == 0 {
+                continue;
+            }
+            let heartbeat = self
+                .map
+                .slot_word(slot, BROADCAST_SLOT_HEARTBEAT_OFFSET)
+                .load(Ordering::Acquire);
+            if heartbeat == 0 {
+                continue; // Being released
+            }
+            if now.saturating_sub(heartbeat) > self.timeout_ms {
+                self.map
+                    .slot_word(slot, BROADCAST_SLOT_HEARTBEAT_OFFSET)
+                    .store(0, Ordering::Release);
+                if owner
+                    .compare_exchange(current, 0, Ordering::AcqRel, Ordering::Acquire)
+                    .is_ok()
+                {
+                    tracing::debug!("evicted broadcast reader {:#x} from slot {}", current, slot);
+                }
+                continue;
+            }
+            let cursor = self
+                .map
+                .slot_word(slot, BROADCAST_SLOT_CURSOR_OFFSET)
+                .load(Ordering::Acquire);
+            let lag = head.wrapping_sub(cursor);
+            if lag > head.wrapping_sub(tail) && lag <= self.map.capacity as u64 {
+                tail = cursor;
+            }
+        }
+        self.map.tail().store(tail, Ordering::Release);
+        tail
+    }
+}
+
+impl Drop for BroadcastRing {
+    fn drop(&mut self) {
+        let _ = std::fs::remove_file(&self.map.path);
+    }
+}
+
+/// Reader side of a broadcast ring: one claimed slot.
+pub struct BroadcastReader {
+    map: Mapping,
+    slot: usize,
+    owner: u64,
+}
+
+impl BroadcastReader {
+    /// Claims a free slot in the ring at `path`. The reader sees records
+    /// published from now on.
+    pub fn attach(path: impl AsRef<Path>) -> MemioResult<Self> {
+        let map = Mapping::open(path.as_ref().to_path_buf())?;
+        let owner = (u64::from(std::process::id()) << 32)
+            | ((READER_COUNTER.fetch_add(1, Ordering::Relaxed) << 1) & 0xFFFF_FFFF)
+            | 1;
+
+        for slot in 0..map.slots {
+            let claimed = map
+                .slot_word(slot, BROADCAST_SLOT_OWNER_OFFSET)
+                .compare_exchange(0, owner, Ordering::AcqRel, Ordering::Acquire)
+                .is_ok();
+            if claimed {
+                // Heartbeat first: until the cursor is set the writer sees the
+                // previous owner's cursor, which only holds records back
+                map.slot_word(slot, BROADCAST_SLOT_HEARTBEAT_OFFSET)
+                    .store(monotonic_ms(), Ordering::Release);
+                let head = map.head().load(Ordering::Acquire);
+                map.slot_word(slot, BROADCAST_SLOT_CURSOR_OFFSET)
+                    .store(head, Ordering::Release);
+                return Ok(Self { map, slot, owner });
+            }
+        }
+        Err(MemioError::Internal(format!(
+            "No free reader slot in broadcast ring {}",
+            map.path.display()
+        )))
+    }
+
+    /// Returns the claimed slot index.
+    pub fn slot(&self) -> usize {
+        self.slot
+    }
+
+    /// Returns the number of published bytes not yet read.
+    pub fn lag(&self) -> usize {
+        let head = self.map.head().load(Ordering::Acquire);
+        head.wrapping_sub(self.cursor().load(Ordering::Acquire)) as usize
+    }
+
+    /// Keeps the slot alive while the reader is idle.
+    pub fn heartbeat(&self) -> MemioResult<()> {
+        self.check_owner()?;
+        self.map
+            .slot_word(self.slot, BROADCAST_SLOT_HEARTBEAT_OFFSET)
+            .store(monotonic_ms(), Ordering::Release);
+        Ok(())
+    }
+
+    /// Reads the next record into `out` (replacing its contents).
+    ///
+    /// Returns false when no record is waiting. Fails if the writer evicted
+    /// this reader; attach again to resume from the current head.
+    pub fn next(&mut self, out: &mut Vec<u8>) -> MemioResult<bool> {
+        self.heartbeat()?;
+        let cursor = self.cursor().load(Ordering::Acquire);
+        let head = self.map.head().load(Ordering::Acquire);
+        let available = head.wrapping_sub(cursor) as usize;
+        if available < BROADCAST_RECORD_HEADER_SIZE {
+            return Ok(false);
+        }
+
+        let mut prefix = [0u8; BROADCAST_RECORD_HEADER_SIZE];
+        self.map.copy_out(cursor, &mut prefix);
+        let length = u32::from_le_bytes(prefix) as usize;
+        if BROADCAST_RECORD_HEADER_SIZE + length > available {
+            return Err(MemioError::InvalidHeader);
+        }
+        out.resize(length, 0);
+        self.map.copy_out(
+            cursor.wrapping_add(BROADCAST_RECORD_HEADER_SIZE as u64),
+            out,
+        );
+        // Still ours: the writer never reuses space behind a live cursor.
+        // If we are evicted and the slot re-claimed after this check, the new
+        // owner has reset the cursor, which the exchange must not clobber.
+        self.check_owner()?;
+        self.cursor()
+            .compare_exchange(
+                cursor,
+                cursor.wrapping_add((BROADCAST_RECORD_HEADER_SIZE + length) as u64),
+                Ordering::AcqRel,
+                Ordering::Acquire,
+            )
+            .map_err(|_| evicted())?;
+        Ok(true)
+    }
+
+    fn cursor(&self) -> &AtomicU64 {
+        self.map.slot_word(self.slot, BROADCAST_SLOT_CURSOR_OFFSET)
+    }
+
+    fn check_owner(&self) -> MemioResult<()> {
+        let owner = self
+            .map
+            .slot_word(self.slot, BROADCAST_SLOT_OWNER_OFFSET)
+            .load(Ordering::Acquire);
+        if owner != self.owner {
+            return Err(evicted());
+        }
+        Ok(())
+    }
+}
+
+impl Drop for BroadcastReader {
+    fn drop(&mut self) {
+        if self.check_owner().is_err() {
+            return; // Evicted; the slot may belong to someone else by now
+        }
+        self.map
+            .slot_word(self.slot, BROADCAST_SLOT_HEARTBEAT_OFFSET)
+            .store(0, Ordering::Release);
+        let _ = self
+            .map
+            .slot_word(self.slot, BROADCAST_SLOT_OWNER_OFFSET)
+            .compare_exchange(self.owner, 0, Ordering::AcqRel, Ordering::Acquire);
+    }
+}
+
+fn evicted() -> MemioError {
+    MemioError::Internal("Broadcast reader was evicted".to_string())
+}
+
+/// `CLOCK_MONOTONIC` in milliseconds, comparable across processes.
+fn monotonic_ms() -> u64 {
+    let mut ts = libc::timespec {
+        tv_sec: 0,
+        tv_nsec: 0,
+    };
+    unsafe {
+        libc::clock_gettime(libc::CLOCK_MONOTONIC, &mut ts);
+    }
+    // Never zero: a zero heartbeat marks a slot that is still attaching
+    (ts.tv_sec as u64 * 1000 + ts.tv_nsec as u64 / 1_000_000).max(1)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_every_reader_sees_every_record() {
+        let ring = BroadcastRing::create(64, 4).unwrap();
+        let mut a = BroadcastReader::attach(ring.path()).unwrap();
+        let mut b = BroadcastReader::attach(ring.path()).unwrap();
+        assert_ne!(a.slot(), b.slot());
+        assert_eq!(ring.readers().len(), 2);
+
+        assert!(ring.publish(b"first").unwrap());
+        assert!(ring.publish(b"second").unwrap());
+
+        let mut out = Vec::new();
+        for reader in [&mut a, &mut b] {
+            assert!(reader.next(&mut out).unwrap());
+            assert_eq!(out, b"first");
+            assert!(reader.next(&mut out).unwrap());
+            assert_eq!(out, b"second");
+            assert!(!reader.next(&mut out).unwrap());
+        }
+    }
+
+    #[test]
+    fn test_slowest_reader_applies_backpressure() {
+        let ring = BroadcastRing::create(32, 2).unwrap();
+        let mut fast = BroadcastReader::attach(ring.path()).unwrap();
+        let mut slow = BroadcastReader::attach(ring.path()).unwrap();
+
+        let mut out = Vec::new();
+        for i in 0..3u8 {
+            assert!(ring.publish(&[i; 6]).unwrap());
+            assert!(fast.next(&mut out).unwrap());
+        }
+        // 30 of 32 bytes are still unread by `slow`
+        assert!(!ring.publish(&[9; 6]).unwrap());
+
+        assert!(slow.next(&mut out).unwrap());
+        assert_eq!(out, [0; 6]);
+        // Wraps past the end of the data area
+        assert!(ring.publish(&[9; 6]).unwrap());
+        for expected in [1, 2, 9] {
+            assert!(slow.next(&mut out).unwrap());
+            assert_eq!(out, [expected; 6]);
+        }
+        assert!(fast.next(&mut out).unwrap());
+        assert_eq!(out, [9; 6]);
+    }
+
+    #[test]
+    fn test_stale_reader_is_evicted() {
+        let ring = BroadcastRing::create(16, 2)
+            .unwrap()
+            .with_reader_timeout(Duration::from_millis(20));
+        let mut stale = BroadcastReader::attach(ring.path()).unwrap();
+        assert!(ring.publish(&[1; 8]).unwrap());
+        assert!(!ring.publish(&[2; 8]).unwrap());
+
+        std::thread::sleep(Duration::from_millis(50));
+        assert!(ring.publish(&[2; 8]).unwrap());
+        assert!(ring.readers().is_empty());
+        assert!(stale.next(&mut Vec::new()).is_err());
+
+        // The slot is free again
+        drop(stale);
+        let mut fresh = BroadcastReader::attach(ring.path()).unwrap();
+        assert!(ring.publish(&[3; 8]).unwrap());
+        let mut out = Vec::new();
+        assert!(fresh.next(&mut out).unwrap());
+        assert_eq!(out, [3; 8]);
+    }
+
+    #[test]
+    fn test_evicted_reader_keeps_off_new_owner_cursor() {
+        let ring = BroadcastRing::create(64, 1)
+            .unwrap()
+            .with_reader_timeout(Duration::from_millis(20));
+        let mut stale = BroadcastReader::attach(ring.path()).unwrap();
+        assert!(ring.publish(&[1; 8]).unwrap());
+        std::thread::sleep(Duration::from_millis(50));
+        assert!(ring.publish(&[2; 8]).unwrap());
+
+        // Same slot, new owner, cursor reset to the head
+        let mut fresh = BroadcastReader::attach(ring.path()).unwrap();
+        assert_eq!(fresh.slot(), stale.slot());
+        assert!(stale.next(&mut Vec::new()).is_err());
+        assert_eq!(fresh.lag(), 0);
+
+        assert!(ring.publish(&[3; 8]).unwrap());
+        let mut out = Vec::new();
+        assert!(fresh.next(&mut out).unwrap());
+        assert_eq!(out, [3; 8]);
+        assert!(!fresh.next(&mut out).unwrap());
+        drop(stale);
+        assert_eq!(fresh.lag(), 0);
+    }
+
+    #[test]
+    fn test_slots_are_released_on_drop() {
+        let ring = BroadcastRing::create(16, 1).unwrap();
+        let reader = BroadcastReader::attach(ring.path()).unwrap();
+        assert!(BroadcastReader::attach(ring.path()).is_err());
+        drop(reader);
+        assert!(BroadcastReader::attach(ring.path()).is_ok());
+    }
+}
@@ -0,0 +1,267 @@
+//! Cross-process change doorbell.
+//!
+//! A tiny shared file that every reader process can sleep on. Writers bump a
+//! 32-bit sequence after each publish and wake all sleepers with a single
+//! `FUTEX_WAKE`; readers block in `FUTEX_WAIT` on the same word instead of
+//! polling every buffer on a timer. One write costs one syscall however many
+//! web processes watch it, and none while nobody is waiting.
+//!
+//! # Layout
+//!
+//! ```text
+//! [magic u64][sequence u32][waiters u32][reserved ...]   (64 bytes)
+//! ```
+//!
+//! The futex is process-shared (no `FUTEX_PRIVATE_FLAG`), so it works for
+//! any process that maps the file, e.g. the WebKit extension.
+
+use std::fs::OpenOptions;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+use std::time::Duration;
+
+use memmap2::MmapMut;
+
+use memio_core::shared_doorbell_spec::*;
+use memio_core::{MemioError, MemioResult};
+
+/// Environment variable carrying the doorbell path to web processes.
+pub const DOORBELL_ENV: &str = "MEMIO_SHARED_DOORBELL";
+
+static DOORBELL_COUNTER: AtomicU64 = AtomicU64::new(0);
+
+/// Process-shared futex word that signals "something was published".
+pub struct Doorbell {
+    path: PathBuf,
+    mmap: MmapMut,
+    owner: bool,
+}
+
+impl std::fmt::Debug for Doorbell {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("Doorbell")
+            .field("path", &self.path)
+            .field("sequence", &self.sequence())
+            .finish()
+    }
+}
+
+// SAFETY: the mapping is only accessed through atomics.
+unsafe impl Send for Doorbell {}
+unsafe impl Sync for Doorbell {}
+
+impl Doorbell {
+    /// Creates a new doorbell in `/dev/shm`.
+    pub fn create() -> MemioResult<Self> {
+        Self::create_in("/dev/shm")
+    }
+
+    /// Creates a new doorbell under a custom base directory.
+    pub fn create_in(base: impl AsRef<Path>) -> MemioResult<Self> {
+        let pid = std::process::id();
+        let nonce = DOORBELL_COUNTER.fetch_add(1, Ordering::Relaxed);
+        let path = base
+            .as_ref()
+            .join(format!("memio_doorbell_{}_{}_0.bin", pid, nonce));
+
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(&path)
+            .map_err(|e| MemioError::CreateFailed(e.to_string()))?;
+        file.set_len(SHARED_DOORBELL_SIZE as u64)
+            .map_err(|e| MemioError::CreateFailed(e.to_string()))?;
+
+        let mut mmap = unsafe { MmapMut::map_mut(&file).map_err(|_| MemioError::MmapFailed)? };
+        mmap[SHARED_DOORBELL_MAGIC_OFFSET..SHARED_DOORBELL_MAGIC_OFFSET + 8]
+            .copy_from_slice(&SHARED_DOORBELL_MAGIC.to_le_bytes());
+
+        Ok(Self {
+            path,
+            mmap,
+            owner: true,
+        })
+    }
+
+    /// Opens a doorbell created by another process.
+    pub fn open(path: impl AsRef<Path>) -> MemioResult<Self> {
+        let path = path.as_ref().to_path_buf();
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .open(&path)
+            .map_err(|e| MemioError::OpenFailed(e.to_string()))?;
+        let mmap = unsafe { MmapMut::map_mut(&file).map_err(|_| MemioError::MmapFailed)? };
+
+        if mmap.len() < SHARED_DOORBELL_SIZE
+            || mmap[SHARED_DOORBELL_MAGIC_OFFSET..SHARED_DOORBELL_MAGIC_OFFSET + 8]
+                != SHARED_DOORBELL_MAGIC.to_le_bytes()
+        {
+            return Err(MemioError::InvalidHeader);
+        }
+
+        Ok(Self {
+            path,
+            mmap,
+            owner: false,
+        })
+    }
+
+    /// Opens the doorbell advertised in `MEMIO_SHARED_DOORBELL`, if any.
+    pub fn from_env() -> Option<Self> {
+        let path = std::env::var_os(DOORBELL_ENV)?;
+        Self::open(path).ok()
+    }
+
+    /// Advertises this doorbell to child processes (web processes inherit it).
+    pub fn export_env(&self) {
+        // SAFETY: Setting environment variable
+        unsafe {
+            std::env::set_var(DOORBELL_ENV, &self.path);
+        }
+    }
+
+    /// Returns the path of the doorbell file.
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+
+    /// Returns the current sequence; it changes after every `ring`.
+    pub fn sequence(&self) -> u32 {
+        self.word(SHARED_DOORBELL_SEQUENCE_OFFSET)
+            .load(Ordering::SeqCst)
+    }
+
+    /// Returns the number of threads currently sleeping in `wait`.
+    pub fn waiters(&self) -> u32 {
+        self.word(SHARED_DOORBELL_WAITERS_OFFSET)
+            .load(Ordering::SeqCst)
+    }
+
+    /// Signals a publish and wakes every waiter. Returns the new sequence.
+    ///
+    /// Skips the syscall when nobody is waiting.
+    pub fn ring(&self) -> u32 {
+        let sequence = self.word(SHARED_DOORBELL_SEQUENCE_OFFSET);
+        let next = sequence.fetch_add(1, Ordering::SeqCst).wrapping_add(1);
+        if self.waiters() > 0 {
+            futex_wake(sequence);
+        }
+        next
+    }
+
+    /// Sleeps until the sequence differs from `seen` or `timeout` elapses.
+    ///
+    /// Returns the sequence observed on wake-up; equal to `seen` means the
+    /// wait timed out or was interrupted.
+    pub fn wait(&self, seen: u32, timeout: Option<Duration>) -> u32 {
+        let sequence = self.word(SHARED_DOORBELL_SEQUENCE_OFFSET);
+        let waiters = self.word(SHARED_DOORBELL_WAITERS_OFFSET);
+
+        // Registering before the kernel re-checks `seen` means a concurrent
+        // `ring` either sees us waiting or makes FUTEX_WAIT return at once.
+        waiters.fetch_add(1, Ordering::SeqCst);
+        if sequence.load(Ordering::SeqCst) == seen {
+            futex_wait(sequence, seen, timeout);
+        }
+        waiters.fetch_sub(1, Ordering::SeqCst);
+        sequence.load(Ordering::SeqCst)
+    }
+
+    fn word(&self, offset: usize) -> &AtomicU32 {
+        // SAFETY: offsets are 4-byte aligned and inside the 64-byte mapping.
+        unsafe { &*(self.mmap.as_ptr().add(offset) as *const AtomicU32) }
+    }
+}
+
+impl Drop for Doorbell {
+    fn drop(&mut self) {
+        if self.owner {
+            let _ = std::fs::remove_file(&self.path);
+        }
+    }
+}
+
+fn futex_wait(word: &AtomicU32, expected: u32, timeout: Option<Duration>) {
+    let timespec = timeout.map(|t| libc::timespec {
+        tv_sec: t.as_secs() as libc::time_t,
+        tv_nsec: t.subsec_nanos() as libc::c_long,
+    });
+    let timespec_ptr = timespec
+        .as_ref()
+        .map_or(std::ptr::null(), |t| t as *const libc::timespec);
+    // SAFETY: `word` points into a live shared mapping.
+    unsafe {
+        libc::syscall(
+            libc::SYS_futex,
+            word.as_ptr(),
+            libc::FUTEX_WAIT,
+            expected,
+            timespec_ptr,
+        );
+    }
+}
+
+fn futex_wake(word: &AtomicU32) {
+    // SAFETY: `word` points into a live shared mapping.
+    unsafe {
+        libc::syscall(libc::SYS_futex, word.as_ptr(), libc::FUTEX_WAKE, i32::MAX);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::Arc;
+    use std::time::Instant;
+
+    #[test]
+    fn test_ring_advances_sequence() {
+        let bell = Doorbell::create_in(std::env::temp_dir()).unwrap();
+        let start = bell.sequence();
+        assert_eq!(bell.ring(), start.wrapping_add(1));
+        assert_eq!(bell.sequence(), start.wrapping_add(1));
+    }
+
+    #[test]
+    fn test_wait_times_out_without_ring() {
+        let bell = Doorbell::create_in(std::env::temp_dir()).unwrap();
+        let seen = bell.sequence();
+        assert_eq!(bell.wait(seen, Some(Duration::from_millis(10))), seen);
+        assert_eq!(bell.waiters(), 0);
+    }
+
+    #[test]
+    fn test_ring_wakes_waiter_in_other_mapping() {
+        let bell = Arc::new(Doorbell::create_in(std::env::temp_dir()).unwrap());
+        let reader = Doorbell::open(bell.path()).unwrap();
+        let seen = reader.sequence();
+
+        let ringer = {
+            let bell = bell.clone();
+            std::thread::spawn(move || {
+                while bell.waiters() == 0 {
+                    std::thread::yield_now();
+                }
+                bell.ring();
+            })
+        };
+
+        let start = Instant::now();
+        let woke = reader.wait(seen, Some(Duration::from_secs(5)));
+        ringer.join().unwrap();
+        assert_ne!(woke, seen);
+        assert!(start.elapsed() < Duration::from_secs(5));
+    }
+
+    #[test]
+    fn test_open_rejects_foreign_file() {
+        let path =
+            std::env::temp_dir().join(format!("memio_not_a_doorbell_{}", std::process::id()));
+        std::fs::write(&path, [0u8; SHARED_DOORBELL_SIZE]).unwrap();
+        assert!(Doorbell::open(&path).is_err());
+        let _ = std::fs::remove_file(&path);
+    }
+}
@@ -32,13 +32,22 @@ pub mod windows;
 
 // Platform-specific utilities (Linux only for now)
 #[cfg(target_os = "linux")]
+pub mod broadcast_ring;
+#[cfg(target_os = "linux")]
+pub mod doorbell;
+#[cfg(target_os = "linux")]
 pub mod shared_file;
 #[cfg(target_os = "linux")]
+pub mod shared_heap;
+#[cfg(target_os = "linux")]
 pub mod shared_ring;
 
 // High-level helpers
 pub mod memio_shared;
+pub mod recording;
 pub mod registry;
+pub mod rpc;
+pub mod snapshot;
 
 /// Platform identifier for runtime detection.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
@@ -179,8 +188,14 @@ pub use windows::{
 
 // Linux-specific utilities
 #[cfg(target_os = "linux")]
+pub use broadcast_ring::{BroadcastReader, BroadcastReaderInfo, BroadcastRing};
+#[cfg(target_os = "linux")]
+pub use doorbell::Doorbell;
+#[cfg(target_os = "linux")]
 pub use shared_file::SharedFileCache;
 #[cfg(target_os = "linux")]
+pub use shared_heap::{HeapObjectInfo, HeapObjectRegion, SharedHeap};
+#[cfg(target_os = "linux")]
 pub use shared_ring::SharedRingBuffer;
 
 // High-level helpers
@@ -189,7 +204,12 @@ pub use memio_manager::{MemioManager, ReadResult, WriteResult, memio_manager};
 #[cfg(target_os = "linux")]
 pub use memio_shared::LinuxMemioShared;
 pub use memio_shared::MemioShared;
+pub use recording::{Player, RecordedFrame, Recorder, RecordingReader};
 pub use registry::SharedRegistry;
+#[cfg(target_os = "linux")]
+pub use rpc::RpcChannel;
+pub use rpc::{RPC_METHOD_ECHO, RpcCodec, RpcDispatcher};
+pub use snapshot::RegionSnapshot;
 
 // Re-export core contracts
 pub use memio_core::{
@@ -4,18 +4,25 @@
 
 use std::collections::HashMap;
 use std::fs::{self, OpenOptions};
+use std::io::IoSlice;
 use std::path::{Path, PathBuf};
-use std::sync::Mutex;
 use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, Weak};
 
-use memmap2::MmapMut;
+use memmap2::{Mmap, MmapMut};
 use once_cell::sync::Lazy;
 
+use memio_core::history::init_history;
 use memio_core::{
-    SHARED_STATE_HEADER_SIZE, SharedMemoryError, SharedMemoryFactory, SharedMemoryRegion,
-    SharedStateInfo, read_header, validate_magic, write_header_unchecked,
+    HistoryConfig, HistoryRing, HistoryRingMut, SHARED_STATE_HEADER_SIZE,
+    SHARED_STATE_HISTORY_OFFSET, SharedMemoryError, SharedMemoryFactory, SharedMemoryRegion,
+    SharedStateInfo, ack_version_ptr, begin_write_ptr, end_write_ptr, fill_len, gather, patch_end,
+    read_ack_ptr, read_header, read_history_offset, validate_magic, write_header_unchecked,
+    write_u64_le,
 };
 
+use crate::snapshot::{CowPages, RegionSnapshot};
+
 const HEADER_SIZE: usize = SHARED_STATE_HEADER_SIZE;
 
 /// Counter for generating unique file names
@@ -105,6 +112,14 @@ pub struct LinuxSharedMemoryRegion {
     path: PathBuf,
     mmap: MmapMut,
     capacity: usize,
+    /// Read-only mapping shared by all snapshots of this region.
+    snapshot_base: Option<Arc<Mmap>>,
+    /// Live snapshots that need pages preserved before each write.
+    snapshots: Vec<Weak<CowPages>>,
+    /// File offset of the version history area, if history mode is on.
+    history_offset: Option<usize>,
+    /// Reused buffer for delta-encoding history slots.
+    history_scratch: Vec<u8>,
 }
 
 impl LinuxSharedMemoryRegion {
@@ -117,6 +132,129 @@ impl LinuxSharedMemoryRegion {
     pub fn name(&self) -> &str {
         &self.name
     }
+
+    /// Takes a copy-on-write snapshot of the current version.
+    ///
+    /// The snapshot maps the region read-only and shares its pages until
+    /// this region overwrites them; `write` then copies just the affected
+    /// pages into the snapshot first. No payload bytes are copied here.
+    pub fn snapshot(&mut self) -> Result<RegionSnapshot, SharedMemoryError> {
+        let (version, length) =
+            read_header(&self.mmap, self.capacity).ok_or(SharedMemoryError::InvalidHeader)?;
+
+        let base = match &self.snapshot_base {
+            Some(base) => base.clone(),
+            None => {
+                let file = fs::File::open(&self.path)
+                    .map_err(|e| SharedMemoryError::OpenFailed(e.to_string()))?;
+                let map = unsafe { Mmap::map(&file).map_err(|_| SharedMemoryError::MmapFailed)? };
+                let base = Arc::new(map);
+                self.snapshot_base = Some(base.clone());
+                base
+            }
+        };
+
+        let pages = Arc::new(CowPages::new(base, HEADER_SIZE, length));
+        self.snapshots.retain(|s| s.strong_count() > 0);
+        self.snapshots.push(Arc::downgrade(&pages));
+
+        Ok(RegionSnapshot::from_cow(self.name.clone(), version, pages))
+    }
+
+    /// Returns the version history ring, if this region keeps one.
+    pub fn history(&self) -> Option<HistoryRing<'_>> {
+        let offset = self.history_offset?;
+        HistoryRing::new(&self.mmap[offset..]).ok()
+    }
+
+    /// Lists versions still resident in the history ring, oldest first.
+    pub fn history_versions(&self) -> Vec<u64> {
+        self.history().map(|h| h.versions()).unwrap_or_default()
+    }
+
+    /// Reads a specific version from the history ring.
+    ///
+    /// Returns `NotFound` if the region has no history or the version was
+    /// already evicted.
+    pub fn read_version(&self, version: u64) -> Result<Vec<u8>, SharedMemoryError> {
+        self.history()
+            .ok_or_else(|| SharedMemoryError::NotFound(format!("{} history", self.name)))?
+            .read(version)
+    }
+
+    /// Appends `data` as `version` to the history ring, delta-encoded
+    /// against the payload it is about to replace.
+    fn push_history(&mut self, version: u64, data: &[u8]) -> Result<(), SharedMemoryError> {
+        let Some(offset) = self.history_offset else {
+            return Ok(());
+        };
+        let (base_version, base_len) =
+            read_header(&self.mmap, self.capacity).ok_or(SharedMemoryError::InvalidHeader)?;
+
+        let (head, history) = self.mmap.split_at_mut(offset);
+        let prev = &head[HEADER_SIZE..HEADER_SIZE + base_len];
+        let mut ring = HistoryRingMut::new(history)?;
+        ring.push(version, base_version, prev, data, &mut self.history_scratch)?;
+        Ok(())
+    }
+
+    /// Copies pages that live snapshots still need before `data` overwrites
+    /// the payload at `at`.
+    fn preserve_snapshots(&mut self, at: usize, data: &[u8]) {
+        if self.snapshots.is_empty() {
+            return;
+        }
+        let current = &self.mmap[HEADER_SIZE..HEADER_SIZE + self.capacity];
+        self.snapshots.retain(|weak| match weak.upgrade() {
+            Some(pages) => {
+                pages.preserve(current, at, data);
+                true
+            }
+            None => false,
+        });
+    }
+
+    /// Marks the payload as being rewritten in place (odd sequence word), so
+    /// readers copying it concurrently detect the tear and retry. Called
+    /// right before the first payload store; `publish` ends the write.
+    fn begin_write(&mut self) {
+        // SAFETY: the mapping starts with a page-aligned header and `&mut self`
+        // makes this the only writer
+        unsafe { begin_write_ptr(self.mmap.as_mut_ptr()) }
+    }
+
+    /// Publishes the payload now in the mapping as `version`: writes the
+    /// header, ends the write started by `begin_write` and flushes the first
+    /// `dirty` payload bytes (the whole mapping in history mode, whose ring
+    /// was just appended to). Every write path ends here, after recording
+    /// history and preserving snapshot pages.
+    fn publish(
+        &mut self,
+        version: u64,
+        length: usize,
+        dirty: usize,
+    ) -> Result<SharedStateInfo, SharedMemoryError> {
+        // Write header (includes magic, version, length)
+        write_header_unchecked(&mut self.mmap, version, length);
+        // SAFETY: see `begin_write`
+        unsafe { end_write_ptr(self.mmap.as_mut_ptr()) };
+
+        // Ensure changes are visible
+        let flushed = match self.history_offset {
+            Some(_) => self.mmap.flush(),
+            None => self.mmap.flush_range(0, HEADER_SIZE + dirty),
+        };
+        flushed.map_err(|e| SharedMemoryError::Io(e.to_string()))?;
+
+        Ok(SharedStateInfo {
+            name: self.name.clone(),
+            path: Some(self.path.clone()),
+            fd: None,
+            version,
+            length,
+            capacity: self.capacity,
+        })
+    }
 }
 
 impl Drop for LinuxSharedMemoryRegion {
@@ -164,26 +302,98 @@ impl SharedMemoryRegion for LinuxSharedMemoryRegion {
             });
         }
 
+        self.push_history(version, data)?;
+        self.preserve_snapshots(0, data);
+        self.begin_write();
+
         // Write data after header
-        let data_offset = HEADER_SIZE;
-        self.mmap[data_offset..data_offset + data.len()].copy_from_slice(data);
+        copy_payload(&mut self.mmap[HEADER_SIZE..HEADER_SIZE + data.len()], data);
+        self.publish(version, data.len(), data.len())
+    }
 
-        // Write header (includes magic, version, length)
-        write_header_unchecked(&mut self.mmap, version, data.len());
+    fn write_vectored(
+        &mut self,
+        version: u64,
+        bufs: &[IoSlice<'_>],
+    ) -> Result<SharedStateInfo, SharedMemoryError> {
+        let length: usize = bufs.iter().map(|b| b.len()).sum();
+        if length > self.capacity {
+            return Err(SharedMemoryError::DataTooLarge {
+                data_len: length,
+                capacity: self.capacity,
+            });
+        }
 
-        // Ensure changes are visible
-        self.mmap
-            .flush()
-            .map_err(|e| SharedMemoryError::Io(e.to_string()))?;
+        if self.history_offset.is_some() {
+            // History slots are delta-encoded against a contiguous payload
+            return self.write(version, &gather(bufs));
+        }
 
-        Ok(SharedStateInfo {
-            name: self.name.clone(),
-            path: Some(self.path.clone()),
-            fd: None,
-            version,
-            length: data.len(),
-            capacity: self.capacity,
-        })
+        // Copy each piece straight into the mapping, then publish once
+        let mut at = 0;
+        self.begin_write();
+        for buf in bufs {
+            self.preserve_snapshots(at, buf);
+            let start = HEADER_SIZE + at;
+            copy_payload(&mut self.mmap[start..start + buf.len()], buf);
+            at += buf.len();
+        }
+        self.publish(version, length, length)
+    }
+
+    fn write_with(
+        &mut self,
+        version: u64,
+        max_len: usize,
+        fill: &mut dyn FnMut(&mut [u8]) -> usize,
+    ) -> Result<SharedStateInfo, SharedMemoryError> {
+        if max_len > self.capacity {
+            return Err(SharedMemoryError::DataTooLarge {
+                data_len: max_len,
+                capacity: self.capacity,
+            });
+        }
+
+        self.snapshots.retain(|s| s.strong_count() > 0);
+        if self.history_offset.is_some() || !self.snapshots.is_empty() {
+            // History deltas and snapshot pages need the old payload intact
+            // until the new one is complete, so render off to the side
+            let mut data = vec![0u8; max_len];
+            let length = fill_len(fill(&mut data), max_len);
+            return self.write(version, &data[..length]);
+        }
+
+        // Readers skip the payload until `publish` ends the write, so they
+        // never see it half rendered
+        self.begin_write();
+        let length = fill_len(
+            fill(&mut self.mmap[HEADER_SIZE..HEADER_SIZE + max_len]),
+            max_len,
+        );
+        self.publish(version, length, length)
+    }
+
+    fn patch(
+        &mut self,
+        version: u64,
+        offset: usize,
+        bytes: &[u8],
+    ) -> Result<SharedStateInfo, SharedMemoryError> {
+        let (_, length) =
+            read_header(&self.mmap, self.capacity).ok_or(SharedMemoryError::InvalidHeader)?;
+        let end = patch_end(offset, bytes.len(), length)?;
+
+        if self.history_offset.is_some() {
+            // History slots are delta-encoded against the whole payload
+            let mut data = self.read()?;
+            data[offset..end].copy_from_slice(bytes);
+            return self.write(version, &data);
+        }
+
+        self.preserve_snapshots(offset, bytes);
+        self.begin_write();
+        self.mmap[HEADER_SIZE + offset..HEADER_SIZE + end].copy_from_slice(bytes);
+        self.publish(version, length, end)
     }
 
     fn read(&self) -> Result<Vec<u8>, SharedMemoryError> {
@@ -206,6 +416,25 @@ impl SharedMemoryRegion for LinuxSharedMemoryRegion {
         // SAFETY: mmap is valid and HEADER_SIZE is within bounds
         unsafe { self.mmap.as_mut_ptr().add(HEADER_SIZE) }
     }
+
+    fn reader_ack(&self) -> Option<u64> {
+        // SAFETY: the mapping is page aligned and covers the header
+        Some(unsafe { read_ack_ptr(self.mmap.as_ptr()) })
+    }
+
+    fn ack(&mut self, version: u64) {
+        // SAFETY: the mapping is page aligned, writable and covers the header
+        unsafe { ack_version_ptr(self.mmap.as_mut_ptr(), version) }
+    }
+}
+
+/// Copies payload bytes into the mapping (across threads for large copies
+/// with `parallel`).
+fn copy_payload(target: &mut [u8], data: &[u8]) {
+    #[cfg(feature = "parallel")]
+    memio_core::parallel::copy(target, data);
+    #[cfg(not(feature = "parallel"))]
+    target.copy_from_slice(data);
 }
 
 /// Factory for creating Linux memio regions.
@@ -239,6 +468,25 @@ impl LinuxSharedMemoryFactory {
         self.base_path.join(filename)
     }
 
+    /// Creates a region in history mode that also keeps the last
+    /// `config.slots` versions, readable with `read_version`.
+    ///
+    /// Each slot can hold a full payload, so the file grows by roughly
+    /// `config.slots * capacity` bytes.
+    pub fn create_with_history(
+        &self,
+        name: &str,
+        capacity: usize,
+        config: HistoryConfig,
+    ) -> Result<LinuxSharedMemoryRegion, SharedMemoryError> {
+        if capacity == 0 || config.slots == 0 {
+            return Err(SharedMemoryError::InvalidCapacity);
+        }
+
+        let path = self.generate_path(name);
+        self.open_or_create_with(name, path, capacity, true, Some(config))
+    }
+
     /// Opens or creates a memio file.
     fn open_or_create(
         &self,
@@ -247,7 +495,23 @@ impl LinuxSharedMemoryFactory {
         capacity: usize,
         create: bool,
     ) -> Result<LinuxSharedMemoryRegion, SharedMemoryError> {
-        let file_len = HEADER_SIZE + capacity;
+        self.open_or_create_with(name, path, capacity, create, None)
+    }
+
+    fn open_or_create_with(
+        &self,
+        name: &str,
+        path: PathBuf,
+        mut capacity: usize,
+        create: bool,
+        history: Option<HistoryConfig>,
+    ) -> Result<LinuxSharedMemoryRegion, SharedMemoryError> {
+        // History slots start on a cache line after the payload.
+        let history_offset = history.map(|_| (HEADER_SIZE + capacity).next_multiple_of(64));
+        let file_len = match (history, history_offset) {
+            (Some(config), Some(offset)) => offset + config.area_size(capacity),
+            _ => HEADER_SIZE + capacity,
+        };
 
         let file = OpenOptions::new()
             .read(true)
@@ -270,14 +534,28 @@ impl LinuxSharedMemoryFactory {
         let mut mmap =
             unsafe { MmapMut::map_mut(&file).map_err(|_| SharedMemoryError::MmapFailed)? };
 
+        let mut history_offset = history_offset;
         if create {
             // Initialize header with version 0 and length 0
             write_header_unchecked(&mut mmap, 0, 0);
+            if let (Some(config), Some(offset)) = (history, history_offset) {
+                init_history(&mut mmap[offset..], &config, capacity)?;
+                write_u64_le(&mut mmap, SHARED_STATE_HISTORY_OFFSET, offset as u64);
+            }
         } else {
             // Validate existing header
             if !validate_magic(&mmap) {
                 return Err(SharedMemoryError::InvalidHeader);
             }
+            // The payload ends where the history area begins.
+            let offset = read_history_offset(&mmap).unwrap_or(0);
+            if offset != 0 {
+                if offset < HEADER_SIZE || offset > mmap.len() {
+                    return Err(SharedMemoryError::InvalidHeader);
+                }
+                capacity = capacity.min(offset - HEADER_SIZE);
+                history_offset = Some(offset);
+            }
         }
 
         // Track in registry
@@ -291,6 +569,10 @@ impl LinuxSharedMemoryFactory {
             path,
             mmap,
             capacity,
+            snapshot_base: None,
+            snapshots: Vec::new(),
+            history_offset,
+            history_scratch: Vec::new(),
         })
     }
 }
@@ -406,6 +688,141 @@ mod tests {
         factory.remove("test2").unwrap();
     }
 
+    #[test]
+    fn test_snapshot_is_stable_across_writes() {
+        let factory = test_factory();
+        let mut region = factory.create("snap_test", 64 * 1024).unwrap();
+
+        let v1 = vec![1u8; 32 * 1024];
+        region.write(1, &v1).unwrap();
+        let snap = region.snapshot().unwrap();
+        assert_eq!(snap.version(), 1);
+        assert_eq!(snap.preserved_bytes(), 0);
+
+        // Change a single page; only that page should be preserved.
+        let mut v2 = v1.clone();
+        v2[5000] = 2;
+        region.write(2, &v2).unwrap();
+        assert_eq!(snap.preserved_bytes(), 4096);
+
+        region.write(3, &[9u8; 48 * 1024]).unwrap();
+        assert_eq!(snap.to_vec(), v1);
+        assert_eq!(region.read().unwrap(), vec![9u8; 48 * 1024]);
+
+        drop(snap);
+        region.write(4, b"done").unwrap();
+        assert!(region.snapshots.is_empty());
+
+        factory.remove("snap_test").unwrap();
+    }
+
+    #[test]
+    fn test_patch_in_place() {
+        let factory = test_factory();
+        let mut region = factory.create("patch_test", 1024).unwrap();
+        region.write(1, &[0u8; 16]).unwrap();
+        let snap = region.snapshot().unwrap();
+
+        let info = region.patch(2, 8, &7u64.to_le_bytes()).unwrap();
+        assert_eq!((info.version, info.length), (2, 16));
+        let data = region.read().unwrap();
+        assert_eq!(&data[8..], &7u64.to_le_bytes());
+        assert_eq!(snap.to_vec(), vec![0u8; 16]);
+        assert!(region.patch(3, 12, &[0u8; 8]).is_err());
+
+        factory.remove("patch_test").unwrap();
+    }
+
+    #[test]
+    fn test_write_vectored() {
+        let factory = test_factory();
+        let mut region = factory.create("test_vectored", 1024).unwrap();
+
+        let header = 3u32.to_le_bytes();
+        let xs = [1u8, 2, 3];
+        let info = region
+            .write_vectored(
+                4,
+                &[IoSlice::new(&header), IoSlice::new(&xs), IoSlice::new(&[])],
+            )
+            .unwrap();
+        assert_eq!((info.version, info.length), (4, 7));
+        assert_eq!(region.read().unwrap(), [3, 0, 0, 0, 1, 2, 3]);
+
+        let big = vec![0u8; 1000];
+        assert!(matches!(
+            region.write_vectored(5, &[IoSlice::new(&big), IoSlice::new(&big)]),
+            Err(SharedMemoryError::DataTooLarge { data_len: 2000, .. })
+        ));
+        assert_eq!(region.info().unwrap().version, 4);
+    }
+
+    #[test]
+    fn test_write_with() {
+        let factory = test_factory();
+        let mut region = factory.create("test_write_with", 1024).unwrap();
+
+        let info = region
+            .write_with(1, 16, &mut |buf| {
+                assert_eq!(buf.len(), 16);
+                buf[..5].copy_from_slice(b"hello");
+                5
+            })
+            .unwrap();
+        assert_eq!((info.version, info.length), (1, 5));
+        assert_eq!(region.read().unwrap(), b"hello");
+
+        // A live snapshot keeps the old payload while the new one is filled
+        let snap = region.snapshot().unwrap();
+        region
+            .write_with(2, 8, &mut |buf| {
+                buf[..3].copy_from_slice(b"bye");
+                3
+            })
+            .unwrap();
+        assert_eq!(snap.to_vec(), b"hello");
+        assert_eq!(region.read().unwrap(), b"bye");
+
+        assert!(region.write_with(3, 2048, &mut |_| 0).is_err());
+        assert_eq!(region.info().unwrap().version, 2);
+
+        // An overlong length is clamped to what the closure was lent
+        let info = region
+            .write_with(3, 4, &mut |buf| {
+                buf.copy_from_slice(b"abcd");
+                5
+            })
+            .unwrap();
+        assert_eq!((info.version, info.length), (3, 4));
+        assert_eq!(region.read().unwrap(), b"abcd");
+    }
+
+    #[test]
+    fn test_history_mode() {
+        let factory = test_factory();
+        let mut region = factory
+            .create_with_history("history_test", 4096, HistoryConfig::new(4))
+            .unwrap();
+        assert_eq!(region.capacity(), 4096);
+
+        for version in 1..=6u64 {
+            let mut data = vec![0u8; 2048];
+            data[0] = version as u8;
+            region.write(version, &data).unwrap();
+        }
+
+        assert_eq!(region.history_versions(), vec![3, 4, 5, 6]);
+        assert_eq!(region.read_version(4).unwrap()[0], 4);
+        assert!(region.read_version(1).is_err());
+        assert_eq!(region.read().unwrap()[0], 6);
+
+        // Reopening finds the history area through the header. Dropping
+        // either handle removes the file, so no explicit cleanup here.
+        let reopened = factory.open("history_test").unwrap();
+        assert_eq!(reopened.capacity(), 4096);
+        assert_eq!(reopened.read_version(5).unwrap()[0], 5);
+    }
+
     #[test]
     fn test_list_and_exists() {
         let factory = test_factory();
@@ -22,8 +22,9 @@
 //! let current_version = manager.version("state")?;
 //! ```
 
-#[cfg(any(target_os = "android", target_os = "windows"))]
+#[cfg(any(target_os = "linux", target_os = "android", target_os = "windows"))]
 use std::collections::HashMap;
+use std::io::IoSlice;
 use std::sync::{Arc, Mutex};
 use std::time::{Duration, Instant};
 
@@ -31,10 +32,18 @@ use std::time::{Duration, Instant};
 use memio_core::SharedMemoryRegion;
 use memio_core::{SharedMemoryError, SharedStateInfo};
 
+use crate::snapshot::RegionSnapshot;
+
+#[cfg(target_os = "linux")]
+use crate::broadcast_ring::BroadcastRing;
+#[cfg(target_os = "linux")]
+use crate::doorbell::Doorbell;
 #[cfg(target_os = "linux")]
 use crate::linux::LinuxSharedMemoryFactory;
 #[cfg(target_os = "linux")]
 use crate::registry::SharedRegistry;
+#[cfg(target_os = "linux")]
+use crate::shared_heap::SharedHeap;
 
 #[cfg(target_os = "android")]
 use crate::android;
@@ -60,6 +69,16 @@ pub struct MemioManager {
     #[cfg(target_os = "linux")]
     registry: Mutex<SharedRegistry<LinuxSharedMemoryFactory>>,
 
+    #[cfg(target_os = "linux")]
+    heaps: Mutex<HashMap<String, Arc<SharedHeap>>>,
+
+    #[cfg(target_os = "linux")]
+    broadcasts: Mutex<HashMap<String, Arc<BroadcastRing>>>,
+
+    /// Rung after every publish so web processes wake instead of polling.
+    #[cfg(target_os = "linux")]
+    doorbell: Option<Arc<Doorbell>>,
+
     #[cfg(target_os = "android")]
     buffers: Mutex<HashMap<String, BufferInfo>>,
 
@@ -115,8 +134,24 @@ impl MemioManager {
 
         let registry = SharedRegistry::new_linux()
             .map_err(|e| SharedMemoryError::CreateFailed(e.to_string()))?;
+
+        // Readers fall back to polling if the doorbell is unavailable
+        let doorbell = match Doorbell::create() {
+            Ok(doorbell) => {
+                doorbell.export_env();
+                Some(Arc::new(doorbell))
+            }
+            Err(e) => {
+                tracing::warn!("memio doorbell unavailable, readers will poll: {}", e);
+                None
+            }
+        };
+
         Ok(Self {
             registry: Mutex::new(registry),
+            heaps: Mutex::new(HashMap::new()),
+            broadcasts: Mutex::new(HashMap::new()),
+            doorbell,
         })
     }
 
@@ -153,6 +188,7 @@ impl MemioManager {
     pub fn create_buffer(&self, name: &str, capacity: usize) -> Result<(), SharedMemoryError> {
         let mut registry = self.registry.lock()?;
         registry.create_buffer(name.to_string(), capacity)?;
+        self.notify();
         Ok(())
     }
 
@@ -178,6 +214,180 @@ impl MemioManager {
         Err(SharedMemoryError::PlatformNotSupported)
     }
 
+    /// Creates a buffer in history mode that keeps the last `slots` versions.
+    ///
+    /// Readers that fall behind can fetch an older version with
+    /// `read_version` while it is still resident. Slots are delta-encoded
+    /// against the previous version with periodic keyframes.
+    ///
+    /// # Example
+    /// ```ignore
+    /// manager.create_buffer_with_history("timeline", 1024 * 1024, 32)?;
+    /// ```
+    #[cfg(target_os = "linux")]
+    pub fn create_buffer_with_history(
+        &self,
+        name: &str,
+        capacity: usize,
+        slots: usize,
+    ) -> Result<(), SharedMemoryError> {
+        let config = memio_core::HistoryConfig::new(slots);
+        let mut registry = self.registry.lock()?;
+        registry.create_buffer_with(name, |factory, name| {
+            factory.create_with_history(name, capacity, config)
+        })?;
+        self.notify();
+        Ok(())
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    pub fn create_buffer_with_history(
+        &self,
+        _name: &str,
+        _capacity: usize,
+        _slots: usize,
+    ) -> Result<(), SharedMemoryError> {
+        Err(SharedMemoryError::PlatformNotSupported)
+    }
+
+    /// Reads a specific version from a history-mode buffer.
+    ///
+    /// Returns `NotFound` if the version is no longer resident.
+    #[cfg(target_os = "linux")]
+    pub fn read_version(&self, name: &str, version: u64) -> Result<ReadResult, SharedMemoryError> {
+        let registry = self.registry.lock()?;
+
+        let region = registry
+            .get(name)
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+
+        let data = region.read_version(version)?;
+        Ok(ReadResult { data, version })
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    pub fn read_version(
+        &self,
+        _name: &str,
+        _version: u64,
+    ) -> Result<ReadResult, SharedMemoryError> {
+        Err(SharedMemoryError::PlatformNotSupported)
+    }
+
+    /// Lists the versions a history-mode buffer still holds, oldest first.
+    #[cfg(target_os = "linux")]
+    pub fn history_versions(&self, name: &str) -> Result<Vec<u64>, SharedMemoryError> {
+        let registry = self.registry.lock()?;
+
+        let region = registry
+            .get(name)
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+
+        Ok(region.history_versions())
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    pub fn history_versions(&self, _name: &str) -> Result<Vec<u64>, SharedMemoryError> {
+        Err(SharedMemoryError::PlatformNotSupported)
+    }
+
+    /// Creates a multi-object heap: one region holding many named objects.
+    ///
+    /// The heap is listed in the registry under `name` as a single entry, so
+    /// the WebKit extension maps one file and exposes every object inside it.
+    ///
+    /// # Arguments
+    /// * `name` - Registry name of the heap
+    /// * `capacity` - Arena size in bytes shared by all objects
+    /// * `slots` - Maximum number of objects (directory size)
+    ///
+    /// # Example
+    /// ```ignore
+    /// let heap = manager.create_heap("objects", 16 * 1024 * 1024, 1024)?;
+    /// heap.write("selection", 1, &bytes)?;
+    /// ```
+    #[cfg(target_os = "linux")]
+    pub fn create_heap(
+        &self,
+        name: &str,
+        capacity: usize,
+        slots: usize,
+    ) -> Result<Arc<SharedHeap>, SharedMemoryError> {
+        let heap = Arc::new(SharedHeap::create(name, capacity, slots)?);
+        if let Some(doorbell) = &self.doorbell {
+            heap.set_doorbell(doorbell.clone());
+        }
+        self.registry.lock()?.register(name, heap.path())?;
+        self.heaps.lock()?.insert(name.to_string(), heap.clone());
+        self.notify();
+        Ok(heap)
+    }
+
+    /// Returns a heap previously created with `create_heap`.
+    #[cfg(target_os = "linux")]
+    pub fn heap(&self, name: &str) -> Result<Arc<SharedHeap>, SharedMemoryError> {
+        self.heaps
+            .lock()?
+            .get(name)
+            .cloned()
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))
+    }
+
+    /// Creates a multi-consumer broadcast ring.
+    ///
+    /// Every attached reader (WebViews through `memio_broadcast_open`, a
+    /// recorder through `BroadcastReader::attach`) receives every record;
+    /// `publish` returns false while the slowest live reader is a full ring
+    /// behind. Each publish rings the doorbell.
+    ///
+    /// # Example
+    /// ```ignore
+    /// let events = manager.create_broadcast("events", 1024 * 1024, 16)?;
+    /// events.publish(&record)?;
+    /// ```
+    #[cfg(target_os = "linux")]
+    pub fn create_broadcast(
+        &self,
+        name: &str,
+        capacity: usize,
+        slots: usize,
+    ) -> Result<Arc<BroadcastRing>, SharedMemoryError> {
+        let ring = Arc::new(BroadcastRing::create(capacity, slots)?);
+        if let Some(doorbell) = &self.doorbell {
+            ring.set_doorbell(doorbell.clone());
+        }
+        self.broadcasts
+            .lock()?
+            .insert(name.to_string(), ring.clone());
+        Ok(ring)
+    }
+
+    /// Returns a broadcast ring previously created with `create_broadcast`.
+    #[cfg(target_os = "linux")]
+    pub fn broadcast(&self, name: &str) -> Result<Arc<BroadcastRing>, SharedMemoryError> {
+        self.broadcasts
+            .lock()?
+            .get(name)
+            .cloned()
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))
+    }
+
+    /// Returns the doorbell rung after every publish.
+    ///
+    /// Its path is exported as `MEMIO_SHARED_DOORBELL`; other processes can
+    /// `Doorbell::open` it and `wait` instead of polling versions.
+    #[cfg(target_os = "linux")]
+    pub fn doorbell(&self) -> Option<Arc<Doorbell>> {
+        self.doorbell.clone()
+    }
+
+    #[cfg(target_os = "linux")]
+    fn notify(&self) {
+        if let Some(doorbell) = &self.doorbell {
+            doorbell.ring();
+        }
+    }
+
     /// Writes data to a memio buffer with versioning.
     ///
     /// # Arguments
@@ -207,6 +417,8 @@ impl MemioManager {
             .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
 
         let info = region.write(version, data)?;
+        drop(registry);
+        self.notify();
 
         Ok(WriteResult {
             version: info.version,
@@ -254,6 +466,112 @@ impl MemioManager {
         Err(SharedMemoryError::PlatformNotSupported)
     }
 
+    /// Writes the concatenation of `bufs` to a memio buffer as one version.
+    ///
+    /// On Linux each piece is copied straight into the mapping and the
+    /// header is published once, so a payload built from a header struct and
+    /// several independently owned arrays needs no staging buffer.
+    ///
+    /// # Example
+    /// ```ignore
+    /// use std::io::IoSlice;
+    ///
+    /// manager.write_vectored("mesh", 2, &[
+    ///     IoSlice::new(&header_bytes),
+    ///     IoSlice::new(&positions),
+    ///     IoSlice::new(&indices),
+    /// ])?;
+    /// ```
+    #[cfg(target_os = "linux")]
+    pub fn write_vectored(
+        &self,
+        name: &str,
+        version: u64,
+        bufs: &[IoSlice<'_>],
+    ) -> Result<WriteResult, SharedMemoryError> {
+        let mut registry = self.registry.lock()?;
+
+        let region = registry
+            .get_mut(name)
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+
+        let info = region.write_vectored(version, bufs)?;
+        drop(registry);
+        self.notify();
+
+        Ok(WriteResult {
+            version: info.version,
+            length: info.length,
+        })
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    pub fn write_vectored(
+        &self,
+        name: &str,
+        version: u64,
+        bufs: &[IoSlice<'_>],
+    ) -> Result<WriteResult, SharedMemoryError> {
+        self.write(name, version, &memio_core::gather(bufs))
+    }
+
+    /// Lets `fill` write a new payload of up to `max_len` bytes directly
+    /// into a memio buffer, then publishes the length it returns as `version`.
+    ///
+    /// On Linux the closure gets the mapped payload area itself, so a
+    /// producer (decoder, image filter) skips the intermediate heap buffer
+    /// and copy. History-mode buffers, buffers with live snapshots and other
+    /// platforms fill a temporary buffer first.
+    ///
+    /// # Example
+    /// ```ignore
+    /// manager.write_with("frame", 9, width * height * 4, |pixels| {
+    ///     decoder.decode_into(pixels)
+    /// })?;
+    /// ```
+    #[cfg(target_os = "linux")]
+    pub fn write_with<F>(
+        &self,
+        name: &str,
+        version: u64,
+        max_len: usize,
+        mut fill: F,
+    ) -> Result<WriteResult, SharedMemoryError>
+    where
+        F: FnMut(&mut [u8]) -> usize,
+    {
+        let mut registry = self.registry.lock()?;
+
+        let region = registry
+            .get_mut(name)
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+
+        let info = region.write_with(version, max_len, &mut fill)?;
+        drop(registry);
+        self.notify();
+
+        Ok(WriteResult {
+            version: info.version,
+            length: info.length,
+        })
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    pub fn write_with<F>(
+        &self,
+        name: &str,
+        version: u64,
+        max_len: usize,
+        mut fill: F,
+    ) -> Result<WriteResult, SharedMemoryError>
+    where
+        F: FnMut(&mut [u8]) -> usize,
+    {
+        let mut data = vec![0u8; max_len];
+        let length = memio_core::fill_len(fill(&mut data), max_len);
+        self.write(name, version, &data[..length])
+    }
+
     /// Reads data from a memio buffer.
     ///
     /// # Arguments
@@ -304,6 +622,40 @@ impl MemioManager {
         Err(SharedMemoryError::PlatformNotSupported)
     }
 
+    /// Takes a consistent snapshot of a buffer for long-running readers.
+    ///
+    /// The snapshot keeps returning the version it captured while the
+    /// writer continues to publish. On Linux it is copy-on-write: taking it
+    /// copies nothing, and later writes only copy the pages they change.
+    /// Other platforms copy the payload once, like `read`.
+    ///
+    /// # Example
+    /// ```ignore
+    /// let snap = manager.snapshot("scene")?;
+    /// std::thread::spawn(move || export(snap.version(), &snap.to_vec()));
+    /// ```
+    #[cfg(target_os = "linux")]
+    pub fn snapshot(&self, name: &str) -> Result<RegionSnapshot, SharedMemoryError> {
+        let mut registry = self.registry.lock()?;
+
+        let region = registry
+            .get_mut(name)
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+
+        region.snapshot()
+    }
+
+    #[cfg(any(target_os = "android", target_os = "windows"))]
+    pub fn snapshot(&self, name: &str) -> Result<RegionSnapshot, SharedMemoryError> {
+        let result = self.read(name)?;
+        Ok(RegionSnapshot::from_vec(name, result.version, result.data))
+    }
+
+    #[cfg(not(any(target_os = "linux", target_os = "android", target_os = "windows")))]
+    pub fn snapshot(&self, _name: &str) -> Result<RegionSnapshot, SharedMemoryError> {
+        Err(SharedMemoryError::PlatformNotSupported)
+    }
+
     /// Gets the current version of a buffer (without reading data).
     ///
     /// This is useful for efficient polling - check if version changed before
@@ -337,10 +689,7 @@ impl MemioManager {
 
     #[cfg(target_os = "android")]
     pub fn version(&self, name: &str) -> Result<u64, SharedMemoryError> {
-        // Android: Read the info to get version
-        // Note: The MemioJsBridge has a direct path for this on the JS side
-        let (version, _) = android::read_from_shared(name)?;
-        Ok(version)
+        Ok(android::read_shared_info(name)?.version)
     }
 
     #[cfg(target_os = "windows")]
@@ -353,6 +702,48 @@ impl MemioManager {
         Err(SharedMemoryError::PlatformNotSupported)
     }
 
+    /// Records that a reader consumed `version` of a buffer.
+    ///
+    /// Raises the reader ack word in the buffer header, which on-demand
+    /// writers (`PublishPolicy::OnDemand`) check before serializing. Reads
+    /// served by the backend (memio:// scheme, channel stream) call this;
+    /// the WebKit extension writes the word itself.
+    #[cfg(target_os = "linux")]
+    pub fn ack(&self, name: &str, version: u64) -> Result<(), SharedMemoryError> {
+        let mut registry = self.registry.lock()?;
+
+        let region = registry
+            .get_mut(name)
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+
+        region.ack(version);
+        Ok(())
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    pub fn ack(&self, _name: &str, _version: u64) -> Result<(), SharedMemoryError> {
+        // Readers are only tracked in Linux region headers
+        Ok(())
+    }
+
+    /// Returns the highest version readers acknowledged, or `None` where
+    /// readers are not tracked.
+    #[cfg(target_os = "linux")]
+    pub fn reader_ack(&self, name: &str) -> Result<Option<u64>, SharedMemoryError> {
+        let registry = self.registry.lock()?;
+
+        let region = registry
+            .get(name)
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+
+        Ok(region.reader_ack())
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    pub fn reader_ack(&self, _name: &str) -> Result<Option<u64>, SharedMemoryError> {
+        Ok(None)
+    }
+
     /// Gets detailed information about a buffer.
     ///
     /// # Arguments
@@ -360,15 +751,27 @@ impl MemioManager {
     ///
     /// # Returns
     /// `SharedStateInfo` with version, length, capacity, etc.
+    ///
+    /// On Linux, names not in the registry are looked up as objects of the
+    /// heaps created with `create_heap` (which the WebView reads as buffers).
     #[cfg(target_os = "linux")]
     pub fn info(&self, name: &str) -> Result<SharedStateInfo, SharedMemoryError> {
         let registry = self.registry.lock()?;
 
-        let region = registry
-            .get(name)
-            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
+        match registry.get(name) {
+            Some(region) => region.info(),
+            None => self.heap_object_info(name),
+        }
+    }
 
-        region.info()
+    /// Header of the heap object `name`, from the first heap holding it.
+    #[cfg(target_os = "linux")]
+    fn heap_object_info(&self, name: &str) -> Result<SharedStateInfo, SharedMemoryError> {
+        self.heaps
+            .lock()?
+            .values()
+            .find_map(|heap| heap.info(name).ok().map(|object| heap.state_info(object)))
+            .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))
     }
 
     #[cfg(target_os = "android")]
@@ -379,16 +782,12 @@ impl MemioManager {
             .get(name)
             .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
 
-        let (version, data) = android::read_from_shared(name)?;
-        let fd = android::get_shared_fd(name).ok();
+        // Header only: status polling must not copy the payload
+        let info = android::read_shared_info(name)?;
 
         Ok(SharedStateInfo {
-            name: name.to_string(),
-            path: None,
-            fd,
-            version,
-            length: data.len(),
             capacity: buffer_info.capacity,
+            ..info
         })
     }
 
@@ -400,15 +799,16 @@ impl MemioManager {
             .get(name)
             .ok_or_else(|| SharedMemoryError::NotFound(name.to_string()))?;
 
-        let (version, data) =
-            windows::read_from_shared(name).map_err(|e| SharedMemoryError::Io(e))?;
+        // Header only: status polling must not copy the payload
+        let (version, length) =
+            windows::read_shared_info(name).map_err(|e| SharedMemoryError::Io(e))?;
 
         Ok(SharedStateInfo {
             name: name.to_string(),
             path: None,
             fd: None,
             version,
-            length: data.len(),
+            length,
             capacity: buffer_info.capacity,
         })
     }
@@ -418,6 +818,36 @@ impl MemioManager {
         Err(SharedMemoryError::PlatformNotSupported)
     }
 
+    /// Gets header information for several buffers at once.
+    ///
+    /// Reads only the headers (no payload copies) and returns one result per
+    /// name, in order; a missing buffer fails its own entry, not the batch.
+    /// On Linux the registry lock is taken once for the whole batch, and
+    /// heap objects are found as in `info`.
+    #[cfg(target_os = "linux")]
+    pub fn info_many<S: AsRef<str>>(
+        &self,
+        names: &[S],
+    ) -> Result<Vec<Result<SharedStateInfo, SharedMemoryError>>, SharedMemoryError> {
+        let registry = self.registry.lock()?;
+
+        Ok(names
+            .iter()
+            .map(|name| match registry.get(name.as_ref()) {
+                Some(region) => region.info(),
+                None => self.heap_object_info(name.as_ref()),
+            })
+            .collect())
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    pub fn info_many<S: AsRef<str>>(
+        &self,
+        names: &[S],
+    ) -> Result<Vec<Result<SharedStateInfo, SharedMemoryError>>, SharedMemoryError> {
+        Ok(names.iter().map(|name| self.info(name.as_ref())).collect())
+    }
+
     /// Blocks until a buffer version changes or timeout is reached.
     ///
     /// Returns `Ok(Some(ReadResult))` when data changes, `Ok(None)` on timeout.
@@ -563,4 +993,79 @@ mod tests {
         assert_eq!(read_result.data, data);
         assert_eq!(read_result.version, 1);
     }
+
+    #[test]
+    #[cfg(any(target_os = "linux", target_os = "android"))]
+    fn test_snapshot() {
+        let manager = MemioManager::new().expect("Failed to create manager");
+
+        manager
+            .create_buffer("snapshot", 1024)
+            .expect("Failed to create buffer");
+        manager.write("snapshot", 1, b"first").unwrap();
+
+        let snap = manager.snapshot("snapshot").expect("Failed to snapshot");
+        manager.write("snapshot", 2, b"second").unwrap();
+
+        assert_eq!(snap.version(), 1);
+        assert_eq!(snap.to_vec(), b"first");
+        assert_eq!(manager.read("snapshot").unwrap().data, b"second");
+    }
+
+    #[test]
+    #[cfg(any(target_os = "linux", target_os = "android"))]
+    fn test_info_many() {
+        let manager = MemioManager::new().expect("Failed to create manager");
+
+        manager.create_buffer("info_a", 1024).unwrap();
+        manager.create_buffer("info_b", 2048).unwrap();
+        manager.write("info_a", 3, b"abc").unwrap();
+
+        let infos = manager
+            .info_many(&["info_a", "missing", "info_b"])
+            .expect("Failed to read headers");
+        assert_eq!(infos.len(), 3);
+
+        let a = infos[0].as_ref().unwrap();
+        assert_eq!((a.version, a.length, a.capacity), (3, 3, 1024));
+        assert!(matches!(infos[1], Err(SharedMemoryError::NotFound(_))));
+        assert_eq!(infos[2].as_ref().unwrap().capacity, 2048);
+    }
+
+    #[test]
+    #[cfg(target_os = "linux")]
+    fn test_info_finds_heap_objects() {
+        let manager = MemioManager::new().expect("Failed to create manager");
+
+        let heap = manager.create_heap("info_heap", 64 * 1024, 16).unwrap();
+        heap.write("info_heap/shard0", 4, b"shard").unwrap();
+
+        let info = manager.info("info_heap/shard0").unwrap();
+        assert_eq!((info.version, info.length), (4, 5));
+        assert_eq!(info.path.as_deref(), Some(heap.path()));
+
+        let infos = manager
+            .info_many(&["info_heap/shard0", "info_heap/missing"])
+            .unwrap();
+        assert_eq!(infos[0].as_ref().unwrap().version, 4);
+        assert!(matches!(infos[1], Err(SharedMemoryError::NotFound(_))));
+    }
+
+    #[test]
+    #[cfg(target_os = "linux")]
+    fn test_reader_ack() {
+        let manager = MemioManager::new().expect("Failed to create manager");
+
+        manager.create_buffer("acked", 1024).unwrap();
+        manager.write("acked", 4, b"data").unwrap();
+        assert_eq!(manager.reader_ack("acked").unwrap(), Some(0));
+
+        manager.ack("acked", 4).unwrap();
+        manager.ack("acked", 2).unwrap();
+        assert_eq!(manager.reader_ack("acked").unwrap(), Some(4));
+
+        // Publishing does not reset what readers have seen
+        manager.write("acked", 5, b"more").unwrap();
+        assert_eq!(manager.reader_ack("acked").unwrap(), Some(4));
+    }
 }
@@ -0,0 +1,752 @@
+//! Record and replay of buffer version streams.
+//!
+//! A [`Recorder`] appends every version it observes to a log file; a
+//! [`Player`] republishes a log at its original pace (or faster) so
+//! consumers can be benchmarked against production-shaped traffic.
+//!
+//! # Log format
+//!
+//! Little-endian, every record 8-byte aligned so the file can be mapped and
+//! walked in place:
+//!
+//! ```text
+//! file header (64 bytes):
+//!   0  magic "MEMIOREC"
+//!   8  format version (u32)
+//!   16 wall-clock start, ns since the Unix epoch (u64)
+//! record:
+//!   0  record length incl. header and padding (u32)
+//!   4  kind: 1 = keyframe, 2 = delta against the previous record of the same name (u8)
+//!   5  name length (u8)
+//!   8  timestamp, ns since start (u64)
+//!   16 version (u64)
+//!   24 decoded length (u64)
+//!   32 name bytes, then payload, then zero padding
+//! ```
+//!
+//! Deltas use [`memio_core::delta`]; a keyframe is written every
+//! `keyframe_interval` records per buffer so playback can start anywhere
+//! near a keyframe.
+
+use std::collections::HashMap;
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::path::Path;
+use std::sync::atomic::{Ordering, fence};
+use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
+
+use memio_core::{MemioError, MemioResult, delta, read_u64_le};
+
+use crate::MemioManager;
+
+/// Magic bytes at the start of a recording.
+pub const RECORDING_MAGIC: &[u8; 8] = b"MEMIOREC";
+/// Current log format version.
+pub const RECORDING_FORMAT_VERSION: u32 = 1;
+/// Size of the file header.
+pub const RECORDING_HEADER_SIZE: usize = 64;
+/// Size of the fixed part of each record.
+pub const RECORD_HEADER_SIZE: usize = 32;
+
+const KIND_KEYFRAME: u8 = 1;
+const KIND_DELTA: u8 = 2;
+
+/// Default number of records per buffer between keyframes.
+pub const DEFAULT_KEYFRAME_INTERVAL: u32 = 64;
+
+/// Per-buffer state the recorder needs to encode the next delta.
+#[derive(Debug, Default)]
+struct Track {
+    version: u64,
+    data: Vec<u8>,
+    since_keyframe: u32,
+    recorded: bool,
+}
+
+/// Appends buffer versions to a recording.
+///
+/// # Example
+/// ```ignore
+/// let mut recorder = Recorder::create("session.memrec")?;
+/// loop {
+///     recorder.poll(&manager, &["scene", "selection"])?;
+///     std::thread::sleep(Duration::from_millis(1));
+/// }
+/// ```
+#[derive(Debug)]
+pub struct Recorder {
+    out: BufWriter<File>,
+    start: Instant,
+    tracks: HashMap<String, Track>,
+    keyframe_interval: u32,
+    scratch: Vec<u8>,
+    records: u64,
+    bytes: u64,
+}
+
+impl Recorder {
+    /// Creates (or truncates) a recording at `path`.
+    pub fn create(path: impl AsRef<Path>) -> MemioResult<Self> {
+        let file =
+            File::create(path.as_ref()).map_err(|e| MemioError::CreateFailed(e.to_string()))?;
+        let mut out = BufWriter::with_capacity(1 << 20, file);
+
+        let start_ns = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .map(|d| d.as_nanos() as u64)
+            .unwrap_or(0);
+        let mut header = [0u8; RECORDING_HEADER_SIZE];
+        header[..8].copy_from_slice(RECORDING_MAGIC);
+        header[8..12].copy_from_slice(&RECORDING_FORMAT_VERSION.to_le_bytes());
+        header[16..24].copy_from_slice(&start_ns.to_le_bytes());
+        out.write_all(&header)?;
+
+        Ok(Self {
+            out,
+            start: Instant::now(),
+            tracks: HashMap::new(),
+            keyframe_interval: DEFAULT_KEYFRAME_INTERVAL,
+            scratch: Vec::new(),
+            records: 0,
+            bytes: RECORDING_HEADER_SIZE as u64,
+        })
+    }
+
+    /// Sets how many records per buffer may pass between keyframes.
+    pub fn with_keyframe_interval(mut self, interval: u32) -> Self {
+        self.keyframe_interval = interval.max(1);
+        self
+    }
+
+    /// Number of records written so far.
+    pub fn records(&self) -> u64 {
+        self.records
+    }
+
+    /// Bytes written so far, including the file header.
+    pub fn bytes_written(&self) -> u64 {
+        self.bytes
+    }
+
+    /// Last version recorded for `name`, if any.
+    pub fn last_version(&self, name: &str) -> Option<u64> {
+        self.tracks
+            .get(name)
+            .filter(|t| t.recorded)
+            .map(|t| t.version)
+    }
+
+    /// Records one version of `name` stamped with the current time.
+    ///
+    /// Returns `false` (and writes nothing) if `version` was already the
+    /// last one recorded for this buffer.
+    pub fn record(&mut self, name: &str, version: u64, data: &[u8]) -> MemioResult<bool> {
+        let elapsed = self.start.elapsed().as_nanos() as u64;
+        self.record_at(name, version, data, elapsed)
+    }
+
+    /// Records one version with an explicit timestamp (ns since start).
+    pub fn record_at(
+        &mut self,
+        name: &str,
+        version: u64,
+        data: &[u8],
+        timestamp_ns: u64,
+    ) -> MemioResult<bool> {
+        if name.len() > u8::MAX as usize {
+            return Err(MemioError::Internal(format!(
+                "Buffer name too long to record: {}",
+                name
+            )));
+        }
+
+        let interval = self.keyframe_interval;
+        let track = self.tracks.entry(name.to_string()).or_default();
+        if track.recorded && track.version == version {
+            return Ok(false);
+        }
+
+        let mut kind = KIND_KEYFRAME;
+        if track.recorded && track.since_keyframe + 1 < interval {
+            self.scratch.clear();
+            delta::encode(&track.data, data, &mut self.scratch);
+            if self.scratch.len() < data.len() {
+                kind = KIND_DELTA;
+            }
+        }
+        let payload: &[u8] = if kind == KIND_DELTA {
+            &self.scratch
+        } else {
+            data
+        };
+
+        let unpadded = RECORD_HEADER_SIZE + name.len() + payload.len();
+        let total = unpadded.next_multiple_of(8);
+        let total_u32 = u32::try_from(total).map_err(|_| MemioError::DataTooLarge {
+            data_len: total,
+            capacity: u32::MAX as usize,
+        })?;
+
+        let mut header = [0u8; RECORD_HEADER_SIZE];
+        header[0..4].copy_from_slice(&total_u32.to_le_bytes());
+        header[4] = kind;
+        header[5] = name.len() as u8;
+        header[8..16].copy_from_slice(&timestamp_ns.to_le_bytes());
+        header[16..24].copy_from_slice(&version.to_le_bytes());
+        header[24..32].copy_from_slice(&(data.len() as u64).to_le_bytes());
+        self.out.write_all(&header)?;
+        self.out.write_all(name.as_bytes())?;
+        self.out.write_all(payload)?;
+        self.out.write_all(&[0u8; 8][..total - unpadded])?;
+
+        track.version = version;
+        track.data.clear();
+        track.data.extend_from_slice(data);
+        track.since_keyframe = if kind == KIND_KEYFRAME {
+            0
+        } else {
+            track.since_keyframe + 1
+        };
+        track.recorded = true;
+        self.records += 1;
+        self.bytes += total as u64;
+        Ok(true)
+    }
+
+    /// Records the current version of each named buffer if it changed.
+    ///
+    /// For history-mode buffers every version still resident since the
+    /// last poll is recorded, so a slow poll loop does not drop versions.
+    /// Returns the number of records written.
+    pub fn poll(&mut self, manager: &MemioManager, names: &[&str]) -> MemioResult<usize> {
+        let mut written = 0;
+        for &name in names {
+            let version = manager.version(name)?;
+            if self.last_version(name) == Some(version) {
+                continue;
+            }
+
+            let last = self.last_version(name);
+            let missed: Vec<u64> = manager
+                .history_versions(name)
+                .unwrap_or_default()
+                .into_iter()
+                .filter(|&v| v != version && last.is_none_or(|l| v > l))
+                .collect();
+            for v in missed {
+                if let Ok(result) = manager.read_version(name, v) {
+                    written += self.record(name, v, &result.data)? as usize;
+                }
+            }
+
+            let result = manager.read(name)?;
+            written += self.record(name, result.version, &result.data)? as usize;
+        }
+        Ok(written)
+    }
+
+    /// Flushes buffered records to disk.
+    pub fn flush(&mut self) -> MemioResult<()> {
+        self.out.flush()?;
+        Ok(())
+    }
+}
+
+impl Drop for Recorder {
+    fn drop(&mut self) {
+        let _ = self.out.flush();
+    }
+}
+
+/// One decoded version from a recording.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct RecordedFrame {
+    /// Buffer name.
+    pub name: String,
+    /// Version as published by the original writer.
+    pub version: u64,
+    /// Time since the start of the recording.
+    pub timestamp: Duration,
+    /// Decoded payload.
+    pub data: Vec<u8>,
+}
+
+#[derive(Debug)]
+enum Backing {
+    #[cfg(target_os = "linux")]
+    Mapped(memmap2::Mmap),
+    #[cfg_attr(target_os = "linux", allow(dead_code))]
+    Owned(Vec<u8>),
+}
+
+/// Read access to a recording file (memory-mapped on Linux).
+#[derive(Debug)]
+pub struct RecordingReader {
+    data: Backing,
+    start_unix_ns: u64,
+}
+
+impl RecordingReader {
+    /// Opens a recording and validates its header.
+    pub fn open(path: impl AsRef<Path>) -> MemioResult<Self> {
+        let path = path.as_ref();
+
+        #[cfg(target_os = "linux")]
+        let data = {
+            let file = File::open(path).map_err(|e| MemioError::OpenFailed(e.to_string()))?;
+            let map = unsafe { memmap2::Mmap::map(&file).map_err(|_| MemioError::MmapFailed)? };
+            Backing::Mapped(map)
+        };
+        #[cfg(not(target_os = "linux"))]
+        let data =
+            Backing::Owned(std::fs::read(path).map_err(|e| MemioError::OpenFailed(e.to_string()))?);
+
+        let reader = Self {
+            data,
+            start_unix_ns: 0,
+        };
+        let bytes = reader.bytes();
+        if bytes.len() < RECORDING_HEADER_SIZE || &bytes[..8] != RECORDING_MAGIC {
+            return Err(MemioError::InvalidHeader);
+        }
+        let format = u32::from_le_bytes(bytes[8..12].try_into().unwrap_or_default());
+        if format != RECORDING_FORMAT_VERSION {
+            return Err(MemioError::Protocol(format!(
+                "Unsupported recording format {}",
+                format
+            )));
+        }
+        let start_unix_ns = read_u64_le(bytes, 16);
+        Ok(Self {
+            start_unix_ns,
+            ..reader
+        })
+    }
+
+    fn bytes(&self) -> &[u8] {
+        match &self.data {
+            #[cfg(target_os = "linux")]
+            Backing::Mapped(m) => m,
+            Backing::Owned(v) => v,
+        }
+    }
+
+    /// Wall-clock start of the recording, ns since the Unix epoch.
+    pub fn start_unix_ns(&self) -> u64 {
+        self.start_unix_ns
+    }
+
+    /// Iterates over decoded frames in recording order.
+    ///
+    /// Iteration stops at the first truncated or corrupt record, so a
+    /// log cut short by a crash still plays up to that point.
+    pub fn frames(&self) -> RecordingFrames<'_> {
+        RecordingFrames {
+            bytes: self.bytes(),
+            pos: RECORDING_HEADER_SIZE,
+            last: HashMap::new(),
+        }
+    }
+}
+
+/// Iterator over the frames of a [`RecordingReader`].
+#[derive(Debug)]
+pub struct RecordingFrames<'a> {
+    bytes: &'a [u8],
+    pos: usize,
+    last: HashMap<String, Vec<u8>>,
+}
+
+impl Iterator for RecordingFrames<'_> {
+    type Item = RecordedFrame;
+
+    fn next(&mut self) -> Option<RecordedFrame> {
+        let rest = self.bytes.get(self.pos..)?;
+        if rest.len() < RECORD_HEADER_SIZE {
+            return None;
+        }
+        let total = u32::from_le_bytes(rest[0..4].try_into().ok()?) as usize;
+        let kind = rest[4];
+        let name_len = rest[5] as usize;
+        if total < RECORD_HEADER_SIZE + name_len || total > rest.len() {
+            return None;
+        }
+        let timestamp = Duration::from_nanos(read_u64_le(rest, 8));
+        let version = read_u64_le(rest, 16);
+        let length = read_u64_le(rest, 24) as usize;
+        let name = std::str::from_utf8(&rest[32..32 + name_len])
+            .ok()?
+            .to_string();
+        let payload = &rest[32 + name_len..total];
+
+        let data = match kind {
+            KIND_KEYFRAME => payload.get(..length)?.to_vec(),
+            KIND_DELTA => {
+                let prev = self.last.get(&name)?;
+                // `length` comes from the file: bound it by what the delta
+                // can produce before reserving for it
+                let mut out = Vec::with_capacity(length.min(prev.len() + payload.len()));
+                delta::decode(prev, payload, &mut out).ok()?;
+                if out.len() != length {
+                    return None;
+                }
+                out
+            }
+            _ => return None,
+        };
+
+        self.pos += total;
+        self.last.insert(name.clone(), data.clone());
+        Some(RecordedFrame {
+            name,
+            version,
+            timestamp,
+            data,
+        })
+    }
+}
+
+/// Republishes a recording, preserving (or scaling) its timing.
+#[derive(Debug)]
+pub struct Player {
+    reader: RecordingReader,
+    speed: f64,
+}
+
+/// Summary of a playback run.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct PlaybackStats {
+    /// Frames delivered.
+    pub frames: u64,
+    /// Payload bytes delivered.
+    pub bytes: u64,
+    /// Wall time spent playing.
+    pub elapsed: Duration,
+    /// Largest amount a frame was delivered after its scheduled time.
+    pub max_lag: Duration,
+}
+
+impl Player {
+    /// Opens a recording for playback at original speed.
+    pub fn open(path: impl AsRef<Path>) -> MemioResult<Self> {
+        Ok(Self {
+            reader: RecordingReader::open(path)?,
+            speed: 1.0,
+        })
+    }
+
+    /// Sets the playback speed multiplier; `0.0` plays as fast as possible.
+    pub fn with_speed(mut self, speed: f64) -> Self {
+        self.speed = if speed.is_finite() {
+            speed.max(0.0)
+        } else {
+            0.0
+        };
+        self
+    }
+
+    /// Returns the underlying reader.
+    pub fn reader(&self) -> &RecordingReader {
+        &self.reader
+    }
+
+    /// Delivers every frame to `sink` at its (scaled) recorded time.
+    pub fn play(
+        &self,
+        mut sink: impl FnMut(&RecordedFrame) -> MemioResult<()>,
+    ) -> MemioResult<PlaybackStats> {
+        let start = Instant::now();
+        let mut stats = PlaybackStats::default();
+        for frame in self.reader.frames() {
+            if self.speed > 0.0 {
+                let due = frame.timestamp.div_f64(self.speed);
+                let now = start.elapsed();
+                if due > now {
+                    std::thread::sleep(due - now);
+                } else {
+                    stats.max_lag = stats.max_lag.max(now - due);
+                }
+            }
+            sink(&frame)?;
+            stats.frames += 1;
+            stats.bytes += frame.data.len() as u64;
+        }
+        stats.elapsed = start.elapsed();
+        Ok(stats)
+    }
+
+    /// Republishes the recording into `manager`, creating any missing
+    /// buffers with `capacity` bytes (use the largest recorded frame).
+    pub fn play_to_manager(
+        &self,
+        manager: &MemioManager,
+        capacity: usize,
+    ) -> MemioResult<PlaybackStats> {
+        self.play(|frame| {
+            if !manager.has_buffer(&frame.name) {
+                manager.create_buffer(&frame.name, capacity.max(frame.data.len()).max(1))?;
+            }
+            manager.write(&frame.name, frame.version, &frame.data)?;
+            Ok(())
+        })
+    }
+}
+
+/// Reads buffers published by another process through its registry
+/// manifest, for recording without access to its `MemioManager`.
+#[cfg(target_os = "linux")]
+#[derive(Debug)]
+pub struct RegistrySource {
+    manifest: std::path::PathBuf,
+    maps: HashMap<String, (std::path::PathBuf, memmap2::Mmap)>,
+}
+
+#[cfg(target_os = "linux")]
+impl RegistrySource {
+    /// Uses the manifest at `path` (`name=path` lines).
+    pub fn new(path: impl Into<std::path::PathBuf>) -> Self {
+        Self {
+            manifest: path.into(),
+            maps: HashMap::new(),
+        }
+    }
+
+    /// Uses the manifest named by `MEMIO_SHARED_REGISTRY`.
+    pub fn from_env() -> MemioResult<Self> {
+        let path = std::env::var_os("MEMIO_SHARED_REGISTRY")
+            .ok_or_else(|| MemioError::NotFound("MEMIO_SHARED_REGISTRY".to_string()))?;
+        Ok(Self::new(path))
+    }
+
+    /// Lists the buffer names currently in the manifest.
+    pub fn names(&self) -> MemioResult<Vec<String>> {
+        Ok(self.entries()?.into_iter().map(|(n, _)| n).collect())
+    }
+
+    fn entries(&self) -> MemioResult<Vec<(String, std::path::PathBuf)>> {
+        let text = std::fs::read_to_string(&self.manifest)
+            .map_err(|e| MemioError::OpenFailed(e.to_string()))?;
+        Ok(text
+            .lines()
+            .filter_map(|line| line.split_once('='))
+            .map(|(n, p)| (n.trim().to_string(), p.trim().into()))
+            .collect())
+    }
+
+    /// Reads the current `(version, payload)` of `name`.
+    ///
+    /// Retries while the writer is mid-publish (header seq odd or changed
+    /// during the copy), giving up with `Internal` after a few attempts.
+    /// Fails with `InvalidHeader` for entries that are not state buffers
+    /// (heaps); a buffer not written yet reads as version 0.
+    pub fn read(&mut self, name: &str) -> MemioResult<(u64, Vec<u8>)> {
+        let path = self
+            .entries()?
+            .into_iter()
+            .find(|(n, _)| n == name)
+            .map(|(_, p)| p)
+            .ok_or_else(|| MemioError::NotFound(name.to_string()))?;
+
+        let stale = self.maps.get(name).is_none_or(|(p, _)| *p != path);
+        if stale {
+            let file = File::open(&path).map_err(|e| MemioError::OpenFailed(e.to_string()))?;
+            let map = unsafe { memmap2::Mmap::map(&file).map_err(|_| MemioError::MmapFailed)? };
+            self.maps.insert(name.to_string(), (path, map));
+        }
+        let (_, map) = &self.maps[name];
+
+        let header = memio_core::SHARED_STATE_HEADER_SIZE;
+        if map.len() < header {
+            return Err(MemioError::InvalidHeader);
+        }
+        let capacity = map.len() - header;
+        for _ in 0..8 {
+            // SAFETY: the mapping is page aligned and holds a whole header
+            let seq = unsafe { memio_core::read_seq_ptr(map.as_ptr()) };
+            let (version, length) =
+                memio_core::read_header(map, capacity).ok_or(MemioError::InvalidHeader)?;
+            if seq & 1 == 0 {
+                let data = map[header..header + length].to_vec();
+                fence(Ordering::Acquire);
+                if unsafe { memio_core::read_seq_ptr(map.as_ptr()) } == seq {
+                    return Ok((version, data));
+                }
+            }
+            std::thread::yield_now();
+        }
+        Err(MemioError::Internal(format!(
+            "Buffer '{}' kept changing during read",
+            name
+        )))
+    }
+
+    /// Records every named buffer whose version changed since the last poll.
+    /// Entries that vanished, heaps and buffers not written yet are skipped.
+    pub fn poll_into(&mut self, recorder: &mut Recorder, names: &[String]) -> MemioResult<usize> {
+        let mut written = 0;
+        for name in names {
+            match self.read(name) {
+                // Created but never published: nothing to record yet
+                Ok((0, _)) => continue,
+                Ok((version, data)) => written += recorder.record(name, version, &data)? as usize,
+                Err(MemioError::NotFound(_) | MemioError::InvalidHeader) => continue,
+                Err(e) => return Err(e),
+            }
+        }
+        Ok(written)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn temp_path(tag: &str) -> std::path::PathBuf {
+        std::env::temp_dir().join(format!("memio_rec_{}_{}.memrec", tag, std::process::id()))
+    }
+
+    #[test]
+    fn test_record_and_read_back() {
+        let path = temp_path("roundtrip");
+        let mut frames = Vec::new();
+        {
+            let mut recorder = Recorder::create(&path).unwrap().with_keyframe_interval(4);
+            let mut data = vec![5u8; 16 * 1024];
+            for version in 1..=10u64 {
+                data[version as usize * 100] = version as u8;
+                assert!(
+                    recorder
+                        .record_at("scene", version, &data, version * 1000)
+                        .unwrap()
+                );
+                frames.push(data.clone());
+            }
+            assert!(!recorder.record_at("scene", 10, &data, 11_000).unwrap());
+            recorder.record_at("cursor", 1, b"xy", 12_000).unwrap();
+
+            // Deltas keep the log far smaller than ten raw copies.
+            recorder.flush().unwrap();
+            assert!(recorder.bytes_written() < 4 * 16 * 1024);
+        }
+
+        let reader = RecordingReader::open(&path).unwrap();
+        let read: Vec<RecordedFrame> = reader.frames().collect();
+        assert_eq!(read.len(), 11);
+        for (i, frame) in read.iter().take(10).enumerate() {
+            assert_eq!(frame.name, "scene");
+            assert_eq!(frame.version, i as u64 + 1);
+            assert_eq!(frame.data, frames[i]);
+        }
+        assert_eq!(read[10].data, b"xy");
+        assert_eq!(read[10].timestamp, Duration::from_nanos(12_000));
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    fn test_corrupt_delta_stops_iteration() {
+        let path = temp_path("corrupt");
+        {
+            let mut recorder = Recorder::create(&path).unwrap();
+            let mut data = [1u8; 256];
+            recorder.record_at("a", 1, &data, 0).unwrap();
+            data[10] = 2;
+            recorder.record_at("a", 2, &data, 1000).unwrap();
+        }
+        let mut bytes = std::fs::read(&path).unwrap();
+        let first = u32::from_le_bytes(bytes[64..68].try_into().unwrap()) as usize;
+        let second = RECORDING_HEADER_SIZE + first;
+        assert_eq!(bytes[second + 4], KIND_DELTA);
+
+        // A decoded length the delta cannot produce ends playback cleanly
+        bytes[second + 24..second + 32].copy_from_slice(&(u64::MAX / 2).to_le_bytes());
+        std::fs::write(&path, &bytes).unwrap();
+        let frames: Vec<_> = RecordingReader::open(&path).unwrap().frames().collect();
+        assert_eq!(frames.len(), 1);
+
+        // So does a delta claiming an output far beyond its payload
+        bytes[second + 24..second + 32].copy_from_slice(&16383u64.to_le_bytes());
+        let payload = second + 32 + bytes[second + 5] as usize;
+        assert_eq!(&bytes[payload..payload + 2], &[0x80, 0x02]);
+        bytes[payload..payload + 2].copy_from_slice(&[0xff, 0x7f]);
+        std::fs::write(&path, &bytes).unwrap();
+        let frames: Vec<_> = RecordingReader::open(&path).unwrap().frames().collect();
+        assert_eq!(frames.len(), 1);
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[cfg(target_os = "linux")]
+    #[test]
+    fn test_registry_source_skips_heaps() {
+        use memio_core::SharedMemoryFactory;
+
+        let dir = std::env::temp_dir().join(format!("memio_rec_src_{}", std::process::id()));
+        std::fs::create_dir_all(&dir).unwrap();
+
+        let header = memio_core::SHARED_STATE_HEADER_SIZE;
+        let mut buffer = vec![0u8; header + 64];
+        memio_core::write_header_unchecked(&mut buffer, 3, 5);
+        buffer[header..header + 5].copy_from_slice(b"hello");
+        std::fs::write(dir.join("state.buf"), &buffer).unwrap();
+        // Created the normal way: valid magic, version 0
+        let factory = crate::LinuxSharedMemoryFactory::with_base_path(&dir);
+        let empty = factory.create("rec_src_empty", 64).unwrap();
+        let heap = crate::SharedHeap::create_in(&dir, "objects", 4096, 4).unwrap();
+        heap.write("a", 1, b"object").unwrap();
+
+        let manifest = dir.join("registry");
+        std::fs::write(
+            &manifest,
+            format!(
+                "state={}\nobjects={}\nempty={}\n",
+                dir.join("state.buf").display(),
+                heap.path().display(),
+                empty.path().display()
+            ),
+        )
+        .unwrap();
+
+        let path = temp_path("source");
+        let mut source = RegistrySource::new(&manifest);
+        let names = source.names().unwrap();
+        assert_eq!(names.len(), 3);
+        {
+            let mut recorder = Recorder::create(&path).unwrap();
+            assert_eq!(source.poll_into(&mut recorder, &names).unwrap(), 1);
+        }
+        let reader = RecordingReader::open(&path).unwrap();
+        let frames: Vec<_> = reader.frames().collect();
+        assert_eq!(frames.len(), 1);
+        assert_eq!(frames[0].name, "state");
+        assert_eq!(frames[0].data, b"hello");
+
+        drop((heap, empty));
+        std::fs::remove_file(&path).unwrap();
+        std::fs::remove_dir_all(&dir).unwrap();
+    }
+
+    #[test]
+    fn test_player_respects_speed() {
+        let path = temp_path("player");
+        {
+            let mut recorder = Recorder::create(&path).unwrap();
+            recorder.record_at("a", 1, b"one", 0).unwrap();
+            recorder.record_at("a", 2, b"two", 40_000_000).unwrap();
+        }
+
+        let mut seen = Vec::new();
+        let stats = Player::open(&path)
+            .unwrap()
+            .with_speed(2.0)
+            .play(|f| {
+                seen.push(f.version);
+                Ok(())
+            })
+            .unwrap();
+        assert_eq!(seen, vec![1, 2]);
+        assert!(stats.elapsed >= Duration::from_millis(20));
+
+        std::fs::remove_file(&path).unwrap();
+    }
+}
@@ -22,6 +22,7 @@ pub struct SharedRegistry<F: SharedMemoryFactory> {
     factory: F,
     manifest_path: PathBuf,
     entries: HashMap<String, RegistryEntry<F::Region>>,
+    external: HashMap<String, PathBuf>,
 }
 
 impl<F: SharedMemoryFactory> Debug for SharedRegistry<F> {
@@ -29,6 +30,7 @@ impl<F: SharedMemoryFactory> Debug for SharedRegistry<F> {
         f.debug_struct("SharedRegistry")
             .field("manifest_path", &self.manifest_path)
             .field("entry_count", &self.entries.len())
+            .field("external_count", &self.external.len())
             .finish()
     }
 }
@@ -40,19 +42,29 @@ impl<F: SharedMemoryFactory> SharedRegistry<F> {
             factory,
             manifest_path,
             entries: HashMap::new(),
+            external: HashMap::new(),
         };
         registry.set_env()?;
         Ok(registry)
     }
 
     /// Registers an existing path under a name (without a region).
+    ///
+    /// The path is listed in the manifest so readers can map it, but the
+    /// registry does not own it (e.g. a `SharedHeap` managed elsewhere).
     pub fn register(
         &mut self,
-        _name: impl Into<String>,
-        _path: impl AsRef<Path>,
+        name: impl Into<String>,
+        path: impl AsRef<Path>,
     ) -> MemioResult<()> {
-        // Note: This method is kept for API compatibility but doesn't store regions.
-        // Use create_buffer for full functionality.
+        self.external
+            .insert(name.into(), path.as_ref().to_path_buf());
+        self.write_manifest()
+    }
+
+    /// Removes a path previously added with `register`.
+    pub fn unregister(&mut self, name: &str) -> MemioResult<()> {
+        self.external.remove(name);
         self.write_manifest()
     }
 
@@ -61,9 +73,21 @@ impl<F: SharedMemoryFactory> SharedRegistry<F> {
         &mut self,
         name: impl Into<String>,
         capacity: usize,
+    ) -> Result<(), SharedMemoryError> {
+        self.create_buffer_with(name, |factory, name| factory.create(name, capacity))
+    }
+
+    /// Creates a buffer with a custom constructor and registers it.
+    ///
+    /// Use this for factory-specific options the generic `create` does not
+    /// cover, e.g. `LinuxSharedMemoryFactory::create_with_history`.
+    pub fn create_buffer_with(
+        &mut self,
+        name: impl Into<String>,
+        create: impl FnOnce(&F, &str) -> Result<F::Region, SharedMemoryError>,
     ) -> Result<(), SharedMemoryError> {
         let name = name.into();
-        let region = self.factory.create(&name, capacity)?;
+        let region = create(&self.factory, &name)?;
         let path = if let Ok(info) = region.info() {
             info.path.unwrap_or_default()
         } else {
@@ -90,6 +114,11 @@ impl<F: SharedMemoryFactory> SharedRegistry<F> {
         self.entries.keys().cloned().collect()
     }
 
+    /// Lists names registered with `register`.
+    pub fn list_external(&self) -> Vec<String> {
+        self.external.keys().cloned().collect()
+    }
+
     /// Returns the manifest path.
     pub fn path(&self) -> &Path {
         &self.manifest_path
@@ -116,6 +145,12 @@ impl<F: SharedMemoryFactory> SharedRegistry<F> {
             out.push_str(&entry.path.to_string_lossy());
             out.push('\n');
         }
+        for (name, path) in &self.external {
+            out.push_str(name);
+            out.push('=');
+            out.push_str(&path.to_string_lossy());
+            out.push('\n');
+        }
         std::fs::write(&self.manifest_path, out)?;
         Ok(())
     }
@@ -0,0 +1,638 @@
+//! Request/response RPC over binary frames.
+//!
+//! `RpcDispatcher` maps method ids to handlers and answers a batch of
+//! request frames (see `memio_core::rpc`) with a batch of response frames.
+//! It is transport-agnostic: on Linux `RpcChannel` serves it over a pair of
+//! `SharedRingBuffer`s (JS→Rust requests, Rust→JS responses) and wakes the
+//! web process through the doorbell; elsewhere the plugin feeds it raw IPC
+//! bodies.
+//!
+//! ```ignore
+//! let rpc = RpcDispatcher::new();
+//! rpc.register(1, |(a, b): (u32, u32)| Ok(a + b));
+//! rpc.register_raw(2, |input, out| { out.extend_from_slice(input); Ok(()) });
+//! app.manage(Arc::new(rpc));
+//! ```
+
+use std::collections::HashMap;
+use std::sync::RwLock;
+
+use memio_core::rpc::{
+    RPC_FLAG_ERROR, RPC_FLAG_RESPONSE, RPC_FRAME_HEADER_SIZE, RPC_FRAME_LENGTH_OFFSET, RpcFrames,
+    push_frame,
+};
+use memio_core::{MemioError, MemioResult};
+
+/// Built-in method answering with its own payload; used by benchmarks and
+/// liveness checks.
+pub const RPC_METHOD_ECHO: u32 = 0;
+
+/// Handler writing its response into a reusable buffer.
+pub type RpcHandler = Box<dyn Fn(&[u8], &mut Vec<u8>) -> Result<(), String> + Send + Sync>;
+
+/// Little-endian binary encoding for typed handler arguments and results.
+pub trait RpcCodec: Sized {
+    fn encode(&self, out: &mut Vec<u8>);
+    fn decode(input: &[u8]) -> MemioResult<Self>;
+}
+
+macro_rules! impl_rpc_codec_num {
+    ($($t:ty),*) => {$(
+        impl RpcCodec for $t {
+            fn encode(&self, out: &mut Vec<u8>) {
+                out.extend_from_slice(&self.to_le_bytes());
+            }
+
+            fn decode(input: &[u8]) -> MemioResult<Self> {
+                const N: usize = std::mem::size_of::<$t>();
+                let bytes: [u8; N] = input
+                    .get(..N)
+                    .and_then(|b| b.try_into().ok())
+                    .ok_or_else(|| rpc_decode_error(stringify!($t), input.len()))?;
+                Ok(<$t>::from_le_bytes(bytes))
+            }
+        }
+    )*};
+}
+
+impl_rpc_codec_num!(u8, u16, u32, u64, i32, i64, f32, f64);
+
+impl RpcCodec for () {
+    fn encode(&self, _out: &mut Vec<u8>) {}
+
+    fn decode(_input: &[u8]) -> MemioResult<Self> {
+        Ok(())
+    }
+}
+
+impl RpcCodec for bool {
+    fn encode(&self, out: &mut Vec<u8>) {
+        out.push(*self as u8);
+    }
+
+    fn decode(input: &[u8]) -> MemioResult<Self> {
+        Ok(u8::decode(input)? != 0)
+    }
+}
+
+/// Raw bytes: the whole payload.
+impl RpcCodec for Vec<u8> {
+    fn encode(&self, out: &mut Vec<u8>) {
+        out.extend_from_slice(self);
+    }
+
+    fn decode(input: &[u8]) -> MemioResult<Self> {
+        Ok(input.to_vec())
+    }
+}
+
+/// UTF-8 text: the whole payload.
+impl RpcCodec for String {
+    fn encode(&self, out: &mut Vec<u8>) {
+        out.extend_from_slice(self.as_bytes());
+    }
+
+    fn decode(input: &[u8]) -> MemioResult<Self> {
+        String::from_utf8(input.to_vec()).map_err(|e| MemioError::Deserialization(e.to_string()))
+    }
+}
+
+/// Two fixed-size values back to back.
+impl<A: RpcCodec + FixedSize, B: RpcCodec> RpcCodec for (A, B) {
+    fn encode(&self, out: &mut Vec<u8>) {
+        self.0.encode(out);
+        self.1.encode(out);
+    }
+
+    fn decode(input: &[u8]) -> MemioResult<Self> {
+        let a = A::decode(input)?;
+        let b = B::decode(input.get(A::SIZE..).unwrap_or_default())?;
+        Ok((a, b))
+    }
+}
+
+/// Codec types with a fixed encoded size, usable as the head of a tuple.
+pub trait FixedSize {
+    const SIZE: usize;
+}
+
+macro_rules! impl_fixed_size {
+    ($($t:ty),*) => {$(
+        impl FixedSize for $t {
+            const SIZE: usize = std::mem::size_of::<$t>();
+        }
+    )*};
+}
+
+impl_fixed_size!(u8, u16, u32, u64, i32, i64, f32, f64, bool);
+
+fn rpc_decode_error(ty: &str, len: usize) -> MemioError {
+    MemioError::Deserialization(format!("expected {} in {}-byte payload", ty, len))
+}
+
+/// Method table answering request frames.
+pub struct RpcDispatcher {
+    handlers: RwLock<HashMap<u32, RpcHandler>>,
+}
+
+impl std::fmt::Debug for RpcDispatcher {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let methods = self.handlers.read().map(|h| h.len()).unwrap_or(0);
+        f.debug_struct("RpcDispatcher")
+            .field("methods", &methods)
+            .finish()
+    }
+}
+
+impl Default for RpcDispatcher {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl RpcDispatcher {
+    /// Creates a dispatcher with only `RPC_METHOD_ECHO` registered.
+    pub fn new() -> Self {
+        let dispatcher = Self {
+            handlers: RwLock::new(HashMap::new()),
+        };
+        dispatcher.register_raw(RPC_METHOD_ECHO, |input, out| {
+            out.extend_from_slice(input);
+            Ok(())
+        });
+        dispatcher
+    }
+
+    /// Registers a handler that appends its response to `out`.
+    ///
+    /// `out` is reused across calls, so steady-state dispatch allocates
+    /// nothing. Replaces any handler already registered for `method`.
+    pub fn register_raw<F>(&self, method: u32, handler: F)
+    where
+        F: Fn(&[u8], &mut Vec<u8>) -> Result<(), String> + Send + Sync + 'static,
+    {
+        if let Ok(mut handlers) = self.handlers.write() {
+            handlers.insert(method, Box::new(handler));
+        }
+    }
+
+    /// Registers a typed handler; arguments and result use `RpcCodec`.
+    pub fn register<Req, Resp, F>(&self, method: u32, handler: F)
+    where
+        Req: RpcCodec,
+        Resp: RpcCodec,
+        F: Fn(Req) -> Result<Resp, String> + Send + Sync + 'static,
+    {
+        self.register_raw(method, move |input, out| {
+            let request = Req::decode(input).map_err(|e| e.to_string())?;
+            handler(request)?.encode(out);
+            Ok(())
+        });
+    }
+
+    /// Answers every complete request frame in `input`, appending one
+    /// response frame each to `output`.
+    ///
+    /// Returns the number of input bytes consumed; a trailing partial frame
+    /// is left for the caller to complete.
+    pub fn dispatch(&self, input: &[u8], output: &mut Vec<u8>) -> MemioResult<usize> {
+        let handlers = self
+            .handlers
+            .read()
+            .map_err(|e| MemioError::LockPoisoned(e.to_string()))?;
+
+        let mut frames = RpcFrames::new(input);
+        for (header, payload) in frames.by_ref() {
+            if header.is_response() {
+                continue;
+            }
+
+            // Reserve the header, let the handler append, then patch length
+            let start = output.len();
+            push_frame(
+                output,
+                header.correlation,
+                header.method,
+                RPC_FLAG_RESPONSE,
+                &[],
+            );
+            let result = match handlers.get(&header.method) {
+                Some(handler) => handler(payload, output),
+                None => Err(format!("unknown rpc method {}", header.method)),
+            };
+            if let Err(message) = result {
+                output.truncate(start);
+                push_frame(
+                    output,
+                    header.correlation,
+                    header.method,
+                    RPC_FLAG_RESPONSE | RPC_FLAG_ERROR,
+                    message.as_bytes(),
+                );
+                continue;
+            }
+            let length = (output.len() - start - RPC_FRAME_HEADER_SIZE) as u32;
+            let at = start + RPC_FRAME_LENGTH_OFFSET;
+            output[at..at + 4].copy_from_slice(&length.to_le_bytes());
+        }
+        Ok(frames.consumed())
+    }
+}
+
+#[cfg(target_os = "linux")]
+pub use channel::RpcChannel;
+
+#[cfg(target_os = "linux")]
+mod channel {
+    use std::borrow::Cow;
+    use std::path::Path;
+    use std::sync::Arc;
+    use std::sync::atomic::{AtomicBool, Ordering};
+    use std::thread::JoinHandle;
+    use std::time::Duration;
+
+    use memio_core::MemioResult;
+    use memio_core::rpc::{
+        RPC_FLAG_ERROR, RPC_FLAG_RESPONSE, RPC_FRAME_HEADER_SIZE, RpcFrameHeader, RpcFrames,
+        push_frame,
+    };
+
+    use super::RpcDispatcher;
+    use crate::doorbell::Doorbell;
+    use crate::shared_ring::SharedRingBuffer;
+
+    /// Poll interval when no doorbell is available.
+    const POLL_INTERVAL: Duration = Duration::from_millis(1);
+    /// Upper bound on one doorbell sleep, so `Drop` is noticed promptly.
+    const WAIT_TIMEOUT: Duration = Duration::from_millis(100);
+
+    /// One client's RPC connection: a request ring the web process writes
+    /// and a response ring it reads, served by a dedicated thread.
+    #[derive(Debug)]
+    pub struct RpcChannel {
+        request_path: std::path::PathBuf,
+        response_path: std::path::PathBuf,
+        stop: Arc<AtomicBool>,
+        thread: Option<JoinHandle<()>>,
+    }
+
+    impl RpcChannel {
+        /// Creates both rings (`capacity` bytes each) and starts serving.
+        ///
+        /// With a doorbell the server sleeps until the client rings it after
+        /// writing requests, and rings it after writing responses.
+        pub fn open(
+            dispatcher: Arc<RpcDispatcher>,
+            capacity: usize,
+            doorbell: Option<Arc<Doorbell>>,
+        ) -> MemioResult<Self> {
+            let requests = SharedRingBuffer::create(capacity)?;
+            let responses = SharedRingBuffer::create(capacity)?;
+            let request_path = requests.path().to_path_buf();
+            let response_path = responses.path().to_path_buf();
+            let stop = Arc::new(AtomicBool::new(false));
+
+            let thread = {
+                let stop = stop.clone();
+                std::thread::Builder::new()
+                    .name("memio-rpc".into())
+                    .spawn(move || serve(dispatcher, requests, responses, doorbell, stop))?
+            };
+
+            Ok(Self {
+                request_path,
+                response_path,
+                stop,
+                thread: Some(thread),
+            })
+        }
+
+        /// Ring the client writes request frames into.
+        pub fn request_path(&self) -> &Path {
+            &self.request_path
+        }
+
+        /// Ring the client reads response frames from.
+        pub fn response_path(&self) -> &Path {
+            &self.response_path
+        }
+    }
+
+    impl Drop for RpcChannel {
+        fn drop(&mut self) {
+            self.stop.store(true, Ordering::Release);
+            if let Some(thread) = self.thread.take() {
+                let _ = thread.join();
+            }
+            let _ = std::fs::remove_file(&self.request_path);
+            let _ = std::fs::remove_file(&self.response_path);
+        }
+    }
+
+    fn serve(
+        dispatcher: Arc<RpcDispatcher>,
+        mut requests: SharedRingBuffer,
+        mut responses: SharedRingBuffer,
+        doorbell: Option<Arc<Doorbell>>,
+        stop: Arc<AtomicBool>,
+    ) {
+        let mut input = vec![0u8; requests.capacity()];
+        let mut output = Vec::with_capacity(responses.capacity());
+        let mut header = [0u8; RPC_FRAME_HEADER_SIZE];
+
+        while !stop.load(Ordering::Acquire) {
+            let seen = doorbell.as_ref().map(|d| d.sequence());
+
+            // The client publishes whole batches, but read whole frames only
+            // so a batch never splits across two dispatches.
+            let mut batch = 0;
+            let mut malformed = None;
+            while requests.peek(&mut header) == RPC_FRAME_HEADER_SIZE {
+                let Some(frame) = RpcFrameHeader::decode(&header) else {
+                    break;
+                };
+                let len = frame.frame_len();
+                if batch + len > input.len() || requests.available() < len {
+                    // Batches are published whole, so a frame that is still
+                    // incomplete with nothing before it never will be
+                    if batch == 0 {
+                        malformed = Some(frame);
+                    }
+                    break;
+                }
+                if requests.read(&mut input[batch..batch + len]).unwrap_or(0) != len {
+                    break;
+                }
+                batch += len;
+            }
+
+            output.clear();
+            if let Some(frame) = malformed {
+                // No way to find the next frame boundary: drop everything
+                // queued and fail the bad call; the rest time out client-side
+                let dropped = requests.read(&mut input).unwrap_or(0);
+                tracing::warn!(
+                    "memio rpc: malformed request frame ({} bytes declared), dropped {} bytes",
+                    frame.length,
+                    dropped
+                );
+                push_frame(
+                    &mut output,
+                    frame.correlation,
+                    frame.method,
+                    RPC_FLAG_RESPONSE | RPC_FLAG_ERROR,
+                    b"malformed rpc request frame",
+                );
+            } else if batch == 0 {
+                match (&doorbell, seen) {
+                    (Some(doorbell), Some(seen)) => {
+                        doorbell.wait(seen, Some(WAIT_TIMEOUT));
+                    }
+                    _ => std::thread::sleep(POLL_INTERVAL),
+                }
+                continue;
+            } else if let Err(e) = dispatcher.dispatch(&input[..batch], &mut output) {
+                tracing::warn!("memio rpc dispatch failed: {}", e);
+                continue;
+            }
+
+            let output = fit_responses(&output, responses.capacity());
+            send_responses(&output, &mut responses, doorbell.as_deref(), &stop);
+        }
+    }
+
+    /// Replaces every response frame that can never fit in the response
+    /// ring with an error frame for the same call.
+    fn fit_responses(output: &[u8], capacity: usize) -> Cow<'_, [u8]> {
+        let mut frames = RpcFrames::new(output);
+        if frames.all(|(frame, _)| frame.frame_len() <= capacity) {
+            return Cow::Borrowed(output);
+        }
+
+        let mut fitted = Vec::with_capacity(capacity);
+        for (frame, payload) in RpcFrames::new(output) {
+            if frame.frame_len() <= capacity {
+                push_frame(
+                    &mut fitted,
+                    frame.correlation,
+                    frame.method,
+                    frame.flags,
+                    payload,
+                );
+            } else {
+                let message = format!(
+                    "rpc response ({} bytes) exceeds the response ring ({} bytes)",
+                    frame.frame_len(),
+                    capacity
+                );
+                push_frame(
+                    &mut fitted,
+                    frame.correlation,
+                    frame.method,
+                    RPC_FLAG_RESPONSE | RPC_FLAG_ERROR,
+                    message.as_bytes(),
+                );
+            }
+        }
+        Cow::Owned(fitted)
+    }
+
+    /// Writes response frames, as many whole frames per publish as fit,
+    /// waiting for the client to drain the ring when it is full.
+    ///
+    /// Every frame must fit in the ring (see `fit_responses`).
+    fn send_responses(
+        output: &[u8],
+        responses: &mut SharedRingBuffer,
+        doorbell: Option<&Doorbell>,
+        stop: &AtomicBool,
+    ) {
+        let mut pending = output;
+        while !pending.is_empty() {
+            let free = responses.free_space();
+            let mut frames = RpcFrames::new(pending);
+            let mut fit = 0;
+            while frames.next().is_some() && frames.consumed() <= free {
+                fit = frames.consumed();
+            }
+
+            if fit == 0 {
+                // Full: wake the client so it drains, then retry
+                if let Some(doorbell) = doorbell {
+                    doorbell.ring();
+                }
+                if stop.load(Ordering::Acquire) {
+                    return;
+                }
+                std::thread::sleep(POLL_INTERVAL);
+                continue;
+            }
+
+            match responses.try_write_all(&[&pending[..fit]]) {
+                Ok(true) => pending = &pending[fit..],
+                Ok(false) => std::thread::sleep(POLL_INTERVAL),
+                Err(e) => {
+                    tracing::warn!("memio rpc response write failed: {}", e);
+                    return;
+                }
+            }
+        }
+        if let Some(doorbell) = doorbell {
+            doorbell.ring();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use memio_core::rpc::{RpcFrameHeader, RpcFrames};
+
+    #[test]
+    fn test_dispatch_typed_and_errors() {
+        let rpc = RpcDispatcher::new();
+        rpc.register(1, |(a, b): (u32, u32)| Ok(a + b));
+
+        let mut input = Vec::new();
+        let mut args = Vec::new();
+        (2u32, 40u32).encode(&mut args);
+        push_frame(&mut input, 10, 1, 0, &args);
+        push_frame(&mut input, 11, 99, 0, b"");
+        push_frame(&mut input, 12, RPC_METHOD_ECHO, 0, b"ping");
+
+        let mut output = Vec::new();
+        assert_eq!(rpc.dispatch(&input, &mut output).unwrap(), input.len());
+
+        let frames: Vec<(RpcFrameHeader, &[u8])> = RpcFrames::new(&output).collect();
+        assert_eq!(frames.len(), 3);
+        assert_eq!(frames[0].0.correlation, 10);
+        assert_eq!(u32::decode(frames[0].1).unwrap(), 42);
+        assert!(frames[1].0.is_error());
+        assert_eq!(frames[2].1, b"ping");
+    }
+
+    #[cfg(target_os = "linux")]
+    #[test]
+    fn test_channel_round_trip() {
+        use crate::doorbell::Doorbell;
+        use crate::shared_ring::SharedRingBuffer;
+        use std::sync::Arc;
+        use std::time::{Duration, Instant};
+
+        let rpc = Arc::new(RpcDispatcher::new());
+        let doorbell = Arc::new(Doorbell::create_in(std::env::temp_dir()).unwrap());
+        let channel = RpcChannel::open(rpc, 4096, Some(doorbell.clone())).unwrap();
+        let mut requests = SharedRingBuffer::open(channel.request_path()).unwrap();
+        let mut responses = SharedRingBuffer::open(channel.response_path()).unwrap();
+
+        let mut batch = Vec::new();
+        for id in 0..8u32 {
+            push_frame(&mut batch, id, RPC_METHOD_ECHO, 0, &id.to_le_bytes());
+        }
+        assert!(requests.try_write_all(&[&batch]).unwrap());
+        doorbell.ring();
+
+        let deadline = Instant::now() + Duration::from_secs(5);
+        while responses.available() < batch.len() && Instant::now() < deadline {
+            std::thread::sleep(Duration::from_millis(1));
+        }
+        let mut out = vec![0u8; batch.len()];
+        assert_eq!(responses.read(&mut out).unwrap(), batch.len());
+        for (id, (header, payload)) in RpcFrames::new(&out).enumerate() {
+            assert!(header.is_response());
+            assert_eq!(header.correlation, id as u32);
+            assert_eq!(payload, (id as u32).to_le_bytes());
+        }
+    }
+
+    #[cfg(target_os = "linux")]
+    fn read_responses(
+        responses: &mut crate::shared_ring::SharedRingBuffer,
+        count: usize,
+    ) -> Vec<(RpcFrameHeader, Vec<u8>)> {
+        use std::time::{Duration, Instant};
+
+        let mut buf = Vec::new();
+        let mut chunk = vec![0u8; responses.capacity()];
+        let deadline = Instant::now() + Duration::from_secs(5);
+        while RpcFrames::new(&buf).count() < count && Instant::now() < deadline {
+            let n = responses.read(&mut chunk).unwrap();
+            buf.extend_from_slice(&chunk[..n]);
+            std::thread::sleep(Duration::from_millis(1));
+        }
+        RpcFrames::new(&buf)
+            .map(|(header, payload)| (header, payload.to_vec()))
+            .collect()
+    }
+
+    #[cfg(target_os = "linux")]
+    #[test]
+    fn test_channel_recovers_from_malformed_frame() {
+        use crate::shared_ring::SharedRingBuffer;
+        use std::sync::Arc;
+
+        let channel = RpcChannel::open(Arc::new(RpcDispatcher::new()), 1024, None).unwrap();
+        let mut requests = SharedRingBuffer::open(channel.request_path()).unwrap();
+        let mut responses = SharedRingBuffer::open(channel.response_path()).unwrap();
+
+        // Declares more payload than the ring can ever hold
+        let mut bad = [0u8; 16];
+        RpcFrameHeader {
+            length: 4096,
+            correlation: 7,
+            method: RPC_METHOD_ECHO,
+            flags: 0,
+        }
+        .encode(&mut bad);
+        assert!(requests.try_write_all(&[&bad]).unwrap());
+        let frames = read_responses(&mut responses, 1);
+        assert_eq!(frames.len(), 1);
+        assert_eq!(frames[0].0.correlation, 7);
+        assert!(frames[0].0.is_error());
+
+        // The channel keeps serving
+        let mut good = Vec::new();
+        push_frame(&mut good, 8, RPC_METHOD_ECHO, 0, b"ok");
+        assert!(requests.try_write_all(&[&good]).unwrap());
+        let frames = read_responses(&mut responses, 1);
+        assert_eq!(
+            (frames[0].0.correlation, frames[0].1.as_slice()),
+            (8, &b"ok"[..])
+        );
+    }
+
+    #[cfg(target_os = "linux")]
+    #[test]
+    fn test_channel_streams_large_response_batches() {
+        use crate::shared_ring::SharedRingBuffer;
+        use std::sync::Arc;
+
+        let rpc = Arc::new(RpcDispatcher::new());
+        rpc.register_raw(1, |_, out| {
+            out.resize(out.len() + 4096, 0);
+            Ok(())
+        });
+        rpc.register(2, |id: u8| Ok(vec![id; 300]));
+        let channel = RpcChannel::open(rpc, 1024, None).unwrap();
+        let mut requests = SharedRingBuffer::open(channel.request_path()).unwrap();
+        let mut responses = SharedRingBuffer::open(channel.response_path()).unwrap();
+
+        // Eight 316-byte responses (more than the ring holds at once) and
+        // one that can never fit
+        let mut batch = Vec::new();
+        for id in 0..8u32 {
+            push_frame(&mut batch, id, 2, 0, &[id as u8]);
+        }
+        push_frame(&mut batch, 8, 1, 0, b"");
+        assert!(requests.try_write_all(&[&batch]).unwrap());
+        let frames = read_responses(&mut responses, 9);
+
+        assert_eq!(frames.len(), 9);
+        for (id, (header, payload)) in frames.iter().take(8).enumerate() {
+            assert_eq!(header.correlation, id as u32);
+            assert_eq!(payload, &vec![id as u8; 300]);
+        }
+        assert_eq!(frames[8].0.correlation, 8);
+        assert!(frames[8].0.is_error());
+    }
+}
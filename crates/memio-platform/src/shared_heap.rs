@@ -0,0 +1,1005 @@
+//! Multi-object shared heap implementation.
+//!
+//! Packs many small named objects into a single memory-mapped file so that
+//! readers (and the WebKit extension) only need one mapping and one registry
+//! line, instead of one `/dev/shm` file per buffer.
+//!
+//! # Layout
+//!
+//! ```text
+//! [heap header][free-list heads][directory: slots x entry][arena ...]
+//! ```
+//!
+//! - Blocks are carved from the arena in power-of-two size classes starting at
+//!   `SHARED_HEAP_MIN_BLOCK`. Freed blocks go onto a per-class lock-free stack
+//!   (tagged head to avoid ABA); fresh blocks come from an atomic bump pointer.
+//! - Each directory entry maps `name -> (offset, length, capacity, version)` and
+//!   carries a sequence word that is odd while the object is being written, so
+//!   readers in other processes can detect torn reads and retry.
+//! - A new name is claimed in a free slot, then the directory is re-scanned
+//!   before the slot goes live, so writers racing to create the same name
+//!   (in one or several processes) end up sharing one slot.
+//! - The heap `generation` is bumped after every publish, letting readers skip
+//!   the directory scan entirely when nothing changed.
+
+use std::collections::HashMap;
+use std::fs::OpenOptions;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering, fence};
+use std::sync::{Arc, Mutex, OnceLock};
+
+use memmap2::MmapMut;
+
+use memio_core::shared_heap_spec::*;
+use memio_core::{MemioError, MemioResult, SharedMemoryRegion, SharedStateInfo};
+
+use crate::doorbell::Doorbell;
+
+static HEAP_COUNTER: AtomicU64 = AtomicU64::new(0);
+
+/// Default number of directory slots for a new heap.
+pub const DEFAULT_HEAP_SLOTS: usize = 1024;
+
+const ENTRY_FREE: u32 = 0;
+const ENTRY_CLAIMED: u32 = 1;
+const ENTRY_LIVE: u32 = 2;
+
+/// Yields spent waiting on a rival claim of the same name before the
+/// claimant is presumed dead (claims hold no lock and last microseconds).
+const CLAIM_WAIT_YIELDS: u32 = 100_000;
+
+/// Attempts `read` makes while the object is being written before giving up.
+const READ_ATTEMPTS: u32 = 10_000;
+
+/// Free-list heads pack a 24-bit ABA tag above a 40-bit block index.
+const INDEX_BITS: u32 = 40;
+const INDEX_MASK: u64 = (1 << INDEX_BITS) - 1;
+
+/// Metadata for an object stored in a [`SharedHeap`].
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct HeapObjectInfo {
+    pub name: String,
+    pub offset: usize,
+    pub length: usize,
+    pub capacity: usize,
+    pub version: u64,
+}
+
+/// A single memory-mapped region holding many named, versioned objects.
+pub struct SharedHeap {
+    path: PathBuf,
+    mmap: MmapMut,
+    owner: bool,
+    capacity: usize,
+    dir_offset: usize,
+    dir_slots: usize,
+    free_offset: usize,
+    arena_offset: usize,
+    index: Mutex<HashMap<String, usize>>,
+    doorbell: OnceLock<Arc<Doorbell>>,
+}
+
+impl std::fmt::Debug for SharedHeap {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("SharedHeap")
+            .field("path", &self.path)
+            .field("capacity", &self.capacity)
+            .field("dir_slots", &self.dir_slots)
+            .finish()
+    }
+}
+
+// SAFETY: all shared mutation goes through atomics or is serialized by the
+// per-entry sequence lock; the mapping itself lives as long as the heap.
+unsafe impl Send for SharedHeap {}
+unsafe impl Sync for SharedHeap {}
+
+impl SharedHeap {
+    /// Creates a new heap in `/dev/shm` with `capacity` bytes of arena space.
+    pub fn create(name: &str, capacity: usize, dir_slots: usize) -> MemioResult<Self> {
+        Self::create_in("/dev/shm", name, capacity, dir_slots)
+    }
+
+    /// Creates a new heap under a custom base directory.
+    pub fn create_in(
+        base: impl AsRef<Path>,
+        name: &str,
+        capacity: usize,
+        dir_slots: usize,
+    ) -> MemioResult<Self> {
+        if capacity == 0 || dir_slots == 0 {
+            return Err(MemioError::InvalidCapacity);
+        }
+
+        let pid = std::process::id();
+        let nonce = HEAP_COUNTER.fetch_add(1, Ordering::Relaxed);
+        let path = base
+            .as_ref()
+            .join(format!("memio_heap_{}_{}_{}_0.bin", name, pid, nonce));
+
+        let free_offset = SHARED_HEAP_HEADER_SIZE;
+        let dir_offset = align_up(free_offset + SHARED_HEAP_SIZE_CLASSES * 8, 64);
+        let arena_offset = align_up(dir_offset + dir_slots * SHARED_HEAP_ENTRY_SIZE, 64);
+        let capacity = align_up(capacity, SHARED_HEAP_MIN_BLOCK);
+        let file_len = arena_offset + capacity;
+
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(&path)
+            .map_err(|e| MemioError::CreateFailed(e.to_string()))?;
+        file.set_len(file_len as u64)
+            .map_err(|e| MemioError::CreateFailed(e.to_string()))?;
+
+        let mut mmap = unsafe { MmapMut::map_mut(&file).map_err(|_| MemioError::MmapFailed)? };
+
+        let put = |buf: &mut [u8], offset: usize, value: u64| {
+            buf[offset..offset + 8].copy_from_slice(&value.to_le_bytes());
+        };
+        put(&mut mmap, SHARED_HEAP_CAPACITY_OFFSET, capacity as u64);
+        put(&mut mmap, SHARED_HEAP_DIR_OFFSET_OFFSET, dir_offset as u64);
+        put(&mut mmap, SHARED_HEAP_DIR_SLOTS_OFFSET, dir_slots as u64);
+        put(
+            &mut mmap,
+            SHARED_HEAP_FREE_OFFSET_OFFSET,
+            free_offset as u64,
+        );
+        put(
+            &mut mmap,
+            SHARED_HEAP_ARENA_OFFSET_OFFSET,
+            arena_offset as u64,
+        );
+        // Magic last so readers never observe a half-initialized header.
+        put(&mut mmap, 0, SHARED_HEAP_MAGIC);
+
+        Ok(Self {
+            path,
+            mmap,
+            owner: true,
+            capacity,
+            dir_offset,
+            dir_slots,
+            free_offset,
+            arena_offset,
+            index: Mutex::new(HashMap::new()),
+            doorbell: OnceLock::new(),
+        })
+    }
+
+    /// Opens an existing heap (e.g. from another process).
+    pub fn open(path: impl AsRef<Path>) -> MemioResult<Self> {
+        let path = path.as_ref().to_path_buf();
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .open(&path)
+            .map_err(|e| MemioError::OpenFailed(e.to_string()))?;
+        let mmap = unsafe { MmapMut::map_mut(&file).map_err(|_| MemioError::MmapFailed)? };
+
+        if mmap.len() < SHARED_HEAP_HEADER_SIZE || read_u64(&mmap, 0) != SHARED_HEAP_MAGIC {
+            return Err(MemioError::InvalidHeader);
+        }
+
+        let capacity = read_u64(&mmap, SHARED_HEAP_CAPACITY_OFFSET) as usize;
+        let dir_offset = read_u64(&mmap, SHARED_HEAP_DIR_OFFSET_OFFSET) as usize;
+        let dir_slots = read_u64(&mmap, SHARED_HEAP_DIR_SLOTS_OFFSET) as usize;
+        let free_offset = read_u64(&mmap, SHARED_HEAP_FREE_OFFSET_OFFSET) as usize;
+        let arena_offset = read_u64(&mmap, SHARED_HEAP_ARENA_OFFSET_OFFSET) as usize;
+        if arena_offset + capacity > mmap.len() {
+            return Err(MemioError::InvalidHeader);
+        }
+
+        Ok(Self {
+            path,
+            mmap,
+            owner: false,
+            capacity,
+            dir_offset,
+            dir_slots,
+            free_offset,
+            arena_offset,
+            index: Mutex::new(HashMap::new()),
+            doorbell: OnceLock::new(),
+        })
+    }
+
+    /// Returns the path of the backing file.
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+
+    /// Returns the arena capacity in bytes.
+    pub fn capacity(&self) -> usize {
+        self.capacity
+    }
+
+    /// Returns the number of arena bytes handed out by the bump allocator.
+    pub fn used(&self) -> usize {
+        self.atomic_u64(SHARED_HEAP_BUMP_OFFSET)
+            .load(Ordering::Relaxed) as usize
+    }
+
+    /// Returns the heap generation, bumped after every publish or removal.
+    pub fn generation(&self) -> u64 {
+        self.atomic_u64(SHARED_HEAP_GENERATION_OFFSET)
+            .load(Ordering::Acquire)
+    }
+
+    /// Returns true if any object changed since `generation`.
+    pub fn changed_since(&self, generation: u64) -> bool {
+        self.generation() != generation
+    }
+
+    /// Reserves an object with at least `capacity` bytes without publishing data.
+    pub fn reserve(&self, name: &str, capacity: usize) -> MemioResult<()> {
+        self.find_or_claim(name, capacity).map(|_| ())
+    }
+
+    /// Writes an object, allocating or growing its block as needed.
+    pub fn write(&self, name: &str, version: u64, data: &[u8]) -> MemioResult<HeapObjectInfo> {
+        // The slot may be removed (and reclaimed) between lookup and lock
+        let entry = loop {
+            let slot = self.find_or_claim(name, data.len())?;
+            if let Some(entry) = self.lock_live(slot, name) {
+                break entry;
+            }
+        };
+        let mut offset = self.entry_u64(entry, SHARED_HEAP_ENTRY_OFFSET_OFFSET) as usize;
+        let mut capacity = self.entry_u64(entry, SHARED_HEAP_ENTRY_CAPACITY_OFFSET) as usize;
+
+        if data.len() > capacity {
+            let (new_offset, new_capacity) = match self.alloc_block(data.len()) {
+                Ok(block) => block,
+                Err(e) => {
+                    self.unlock_entry(entry);
+                    return Err(e);
+                }
+            };
+            self.free_block(offset, capacity);
+            offset = new_offset;
+            capacity = new_capacity;
+            self.set_entry_u64(entry, SHARED_HEAP_ENTRY_OFFSET_OFFSET, offset as u64);
+            self.set_entry_u64(entry, SHARED_HEAP_ENTRY_CAPACITY_OFFSET, capacity as u64);
+        }
+
+        unsafe {
+            std::ptr::copy_nonoverlapping(
+                data.as_ptr(),
+                self.mmap.as_ptr().add(offset) as *mut u8,
+                data.len(),
+            );
+        }
+        self.set_entry_u64(entry, SHARED_HEAP_ENTRY_LENGTH_OFFSET, data.len() as u64);
+        self.set_entry_u64(entry, SHARED_HEAP_ENTRY_VERSION_OFFSET, version);
+        self.unlock_entry(entry);
+
+        self.publish();
+
+        Ok(HeapObjectInfo {
+            name: name.to_string(),
+            offset,
+            length: data.len(),
+            capacity,
+            version,
+        })
+    }
+
+    /// Reads an object. Returns `(version, data)`.
+    ///
+    /// Retries while a writer holds the entry, failing with `Internal` if it
+    /// stays locked (e.g. its writer died mid-write) and with `InvalidHeader`
+    /// if a stable entry points outside the mapping.
+    pub fn read(&self, name: &str) -> MemioResult<(u64, Vec<u8>)> {
+        let slot = self
+            .find(name)
+            .ok_or_else(|| MemioError::NotFound(name.to_string()))?;
+        let entry = self.entry_offset(slot);
+
+        for attempt in 0..READ_ATTEMPTS {
+            if attempt > 0 {
+                if attempt < 64 {
+                    std::hint::spin_loop();
+                } else {
+                    std::thread::yield_now();
+                }
+            }
+            let seq = self.seq(entry).load(Ordering::Acquire);
+            if seq & 1 == 1 {
+                continue;
+            }
+            let offset = self.entry_u64(entry, SHARED_HEAP_ENTRY_OFFSET_OFFSET) as usize;
+            let length = self.entry_u64(entry, SHARED_HEAP_ENTRY_LENGTH_OFFSET) as usize;
+            let version = self.entry_u64(entry, SHARED_HEAP_ENTRY_VERSION_OFFSET);
+            if offset
+                .checked_add(length)
+                .is_none_or(|end| end > self.mmap.len())
+            {
+                if self.seq(entry).load(Ordering::Acquire) == seq {
+                    return Err(MemioError::InvalidHeader);
+                }
+                continue;
+            }
+            let data = self.mmap[offset..offset + length].to_vec();
+            fence(Ordering::Acquire);
+            if self.seq(entry).load(Ordering::Relaxed) == seq {
+                return Ok((version, data));
+            }
+        }
+        Err(MemioError::Internal(format!(
+            "Heap object '{}' kept changing during read",
+            name
+        )))
+    }
+
+    /// Returns metadata for an object without copying its data.
+    pub fn info(&self, name: &str) -> MemioResult<HeapObjectInfo> {
+        let slot = self
+            .find(name)
+            .ok_or_else(|| MemioError::NotFound(name.to_string()))?;
+        Ok(self.slot_info(slot, name.to_string()))
+    }
+
+    /// Describes an object as a buffer backed by this heap's file.
+    pub(crate) fn state_info(&self, object: HeapObjectInfo) -> SharedStateInfo {
+        SharedStateInfo {
+            name: object.name,
+            path: Some(self.path.clone()),
+            fd: None,
+            version: object.version,
+            length: object.length,
+            capacity: object.capacity,
+        }
+    }
+
+    /// Returns the current version of an object.
+    pub fn version(&self, name: &str) -> MemioResult<u64> {
+        self.info(name).map(|info| info.version)
+    }
+
+    /// Lists all live objects.
+    pub fn list(&self) -> Vec<HeapObjectInfo> {
+        (0..self.dir_slots)
+            .filter(|&slot| self.entry_state(slot).load(Ordering::Acquire) == ENTRY_LIVE)
+            .map(|slot| {
+                let name = self.entry_name(slot);
+                self.slot_info(slot, name)
+            })
+            .collect()
+    }
+
+    /// Removes an object and returns its block to the free list.
+    pub fn remove(&self, name: &str) -> MemioResult<()> {
+        let not_found = || MemioError::NotFound(name.to_string());
+        let slot = self.find(name).ok_or_else(not_found)?;
+        // A concurrent remove got there first: its block must not be freed twice
+        let entry = self.lock_live(slot, name).ok_or_else(not_found)?;
+        let offset = self.entry_u64(entry, SHARED_HEAP_ENTRY_OFFSET_OFFSET) as usize;
+        let capacity = self.entry_u64(entry, SHARED_HEAP_ENTRY_CAPACITY_OFFSET) as usize;
+        self.entry_state(slot).store(ENTRY_FREE, Ordering::Release);
+        self.unlock_entry(entry);
+        self.free_block(offset, capacity);
+
+        if let Ok(mut index) = self.index.lock() {
+            index.remove(name);
+        }
+        self.publish();
+        Ok(())
+    }
+
+    /// Rings `doorbell` after every publish or removal, so readers in other
+    /// processes wake up instead of polling the generation. Set once.
+    pub fn set_doorbell(&self, doorbell: Arc<Doorbell>) {
+        let _ = self.doorbell.set(doorbell);
+    }
+
+    /// Bumps the generation and notifies sleeping readers.
+    fn publish(&self) {
+        self.atomic_u64(SHARED_HEAP_GENERATION_OFFSET)
+            .fetch_add(1, Ordering::AcqRel);
+        if let Some(doorbell) = self.doorbell.get() {
+            doorbell.ring();
+        }
+    }
+
+    fn find(&self, name: &str) -> Option<usize> {
+        if let Ok(index) = self.index.lock()
+            && let Some(&slot) = index.get(name)
+            && self.entry_state(slot).load(Ordering::Acquire) == ENTRY_LIVE
+            && self.entry_name(slot) == name
+        {
+            return Some(slot);
+        }
+
+        let slot = (0..self.dir_slots).find(|&slot| {
+            self.entry_state(slot).load(Ordering::Acquire) == ENTRY_LIVE
+                && self.entry_name(slot) == name
+        })?;
+        if let Ok(mut index) = self.index.lock() {
+            index.insert(name.to_string(), slot);
+        }
+        Some(slot)
+    }
+
+    fn find_or_claim(&self, name: &str, capacity: usize) -> MemioResult<usize> {
+        if let Some(slot) = self.find(name) {
+            return Ok(slot);
+        }
+        if name.is_empty() || name.len() > SHARED_HEAP_NAME_MAX {
+            return Err(MemioError::Internal(format!(
+                "Heap object name must be 1..={} bytes: {}",
+                SHARED_HEAP_NAME_MAX, name
+            )));
+        }
+
+        let (offset, block) = self.alloc_block(capacity)?;
+        let mut yields = 0;
+        loop {
+            let Some(slot) = self.claim_slot(name) else {
+                self.free_block(offset, block);
+                return Err(MemioError::Internal(format!(
+                    "Heap directory full ({} slots)",
+                    self.dir_slots
+                )));
+            };
+
+            let state = self.entry_state(slot);
+            match self.rival_claim(slot, name) {
+                None => {
+                    let entry = self.entry_offset(slot);
+                    self.set_entry_u64(entry, SHARED_HEAP_ENTRY_OFFSET_OFFSET, offset as u64);
+                    self.set_entry_u64(entry, SHARED_HEAP_ENTRY_CAPACITY_OFFSET, block as u64);
+                    self.set_entry_u64(entry, SHARED_HEAP_ENTRY_LENGTH_OFFSET, 0);
+                    self.set_entry_u64(entry, SHARED_HEAP_ENTRY_VERSION_OFFSET, 0);
+                    state.store(ENTRY_LIVE, Ordering::Release);
+
+                    if let Ok(mut index) = self.index.lock() {
+                        index.insert(name.to_string(), slot);
+                    }
+                    return Ok(slot);
+                }
+                Some(rival) => {
+                    state.store(ENTRY_FREE, Ordering::Release);
+                    if self.entry_state(rival).load(Ordering::Acquire) == ENTRY_LIVE {
+                        self.free_block(offset, block);
+                        return Ok(rival);
+                    }
+                }
+            }
+
+            // A lower-index claim of the same name wins: wait for it to go live
+            yields += 1;
+            if yields > CLAIM_WAIT_YIELDS {
+                self.free_block(offset, block);
+                return Err(MemioError::Internal(format!(
+                    "Heap object '{}' is stuck being claimed",
+                    name
+                )));
+            }
+            std::thread::yield_now();
+            if let Some(slot) = self.find(name) {
+                self.free_block(offset, block);
+                return Ok(slot);
+            }
+        }
+    }
+
+    /// Claims a free directory slot and writes `name` into it.
+    fn claim_slot(&self, name: &str) -> Option<usize> {
+        let slot = (0..self.dir_slots).find(|&slot| {
+            self.entry_state(slot)
+                .compare_exchange(
+                    ENTRY_FREE,
+                    ENTRY_CLAIMED,
+                    Ordering::AcqRel,
+                    Ordering::Relaxed,
+                )
+                .is_ok()
+        })?;
+
+        let entry = self.entry_offset(slot);
+        let base = self.mmap.as_ptr() as *mut u8;
+        unsafe {
+            let name_ptr = base.add(entry + SHARED_HEAP_ENTRY_NAME_OFFSET);
+            std::ptr::write_bytes(name_ptr, 0, SHARED_HEAP_NAME_MAX);
+            std::ptr::copy_nonoverlapping(name.as_ptr(), name_ptr, name.len());
+        }
+        self.name_len(entry)
+            .store(name.len() as u32, Ordering::Release);
+        Some(slot)
+    }
+
+    /// Looks for another slot holding `name` before `slot` (claimed by us)
+    /// goes live, so two writers claiming the same name at once never
+    /// publish it twice. A live slot or a lower-index claim wins and is
+    /// returned. A higher-index claim yields to ours, but may not have seen
+    /// it yet, so we wait for it to resolve (released, or live and winning).
+    fn rival_claim(&self, slot: usize, name: &str) -> Option<usize> {
+        // Our name is visible to every rival whose scan starts after this
+        // fence; otherwise its name is visible to our scan
+        fence(Ordering::SeqCst);
+        for other in (0..self.dir_slots).filter(|&other| other != slot) {
+            let mut yields = 0;
+            loop {
+                let state = self.entry_state(other).load(Ordering::Acquire);
+                if state == ENTRY_FREE || self.entry_name(other) != name {
+                    break;
+                }
+                if state == ENTRY_LIVE || other < slot {
+                    return Some(other);
+                }
+                yields += 1;
+                if yields > CLAIM_WAIT_YIELDS {
+                    // Claimant presumed dead; its claim never goes live
+                    break;
+                }
+                std::thread::yield_now();
+            }
+        }
+        None
+    }
+
+    /// Allocates a block for `size` bytes. Returns `(file offset, block size)`.
+    fn alloc_block(&self, size: usize) -> MemioResult<(usize, usize)> {
+        let class = size_class(size);
+        if class >= SHARED_HEAP_SIZE_CLASSES {
+            return Err(MemioError::DataTooLarge {
+                data_len: size,
+                capacity: self.capacity,
+            });
+        }
+        let block = SHARED_HEAP_MIN_BLOCK << class;
+
+        // Fast path: reuse a freed block of the same class.
+        let head = self.free_head(class);
+        let mut current = head.load(Ordering::Acquire);
+        loop {
+            let index = current & INDEX_MASK;
+            if index == 0 {
+                break;
+            }
+            let offset = index as usize * SHARED_HEAP_MIN_BLOCK;
+            let next = self.atomic_u64(offset).load(Ordering::Acquire);
+            let tag = (current >> INDEX_BITS).wrapping_add(1);
+            let new = (tag << INDEX_BITS) | (next & INDEX_MASK);
+            match head.compare_exchange_weak(current, new, Ordering::AcqRel, Ordering::Acquire) {
+                Ok(_) => return Ok((offset, block)),
+                Err(observed) => current = observed,
+            }
+        }
+
+        // Slow path: carve a fresh block from the bump pointer.
+        let bump = self.atomic_u64(SHARED_HEAP_BUMP_OFFSET);
+        let mut used = bump.load(Ordering::Relaxed);
+        loop {
+            let end = used as usize + block;
+            if end > self.capacity {
+                return Err(MemioError::ArenaFull {
+                    requested: block,
+                    available: self.capacity.saturating_sub(used as usize),
+                });
+            }
+            match bump.compare_exchange_weak(used, end as u64, Ordering::AcqRel, Ordering::Relaxed)
+            {
+                Ok(_) => return Ok((self.arena_offset + used as usize, block)),
+                Err(observed) => used = observed,
+            }
+        }
+    }
+
+    /// Pushes a block back onto its size-class free list.
+    fn free_block(&self, offset: usize, block: usize) {
+        if block == 0 {
+            return;
+        }
+        let class = size_class(block);
+        let head = self.free_head(class);
+        let index = (offset / SHARED_HEAP_MIN_BLOCK) as u64;
+        let link = self.atomic_u64(offset);
+        let mut current = head.load(Ordering::Acquire);
+        loop {
+            link.store(current & INDEX_MASK, Ordering::Release);
+            let tag = (current >> INDEX_BITS).wrapping_add(1);
+            let new = (tag << INDEX_BITS) | index;
+            match head.compare_exchange_weak(current, new, Ordering::AcqRel, Ordering::Acquire) {
+                Ok(_) => return,
+                Err(observed) => current = observed,
+            }
+        }
+    }
+
+    fn lock_entry(&self, entry: usize) {
+        let seq = self.seq(entry);
+        loop {
+            let current = seq.load(Ordering::Relaxed);
+            if current & 1 == 0
+                && seq
+                    .compare_exchange_weak(
+                        current,
+                        current + 1,
+                        Ordering::Acquire,
+                        Ordering::Relaxed,
+                    )
+                    .is_ok()
+            {
+                return;
+            }
+            std::hint::spin_loop();
+        }
+    }
+
+    fn unlock_entry(&self, entry: usize) {
+        self.seq(entry).fetch_add(1, Ordering::Release);
+    }
+
+    /// Locks `slot` if it still holds `name` live. Slots only leave
+    /// `ENTRY_LIVE` under the entry lock, so the check holds until unlock.
+    /// Returns the entry offset, or `None` (unlocked) if the slot was
+    /// removed or reused under another name since it was looked up.
+    fn lock_live(&self, slot: usize, name: &str) -> Option<usize> {
+        let entry = self.entry_offset(slot);
+        self.lock_entry(entry);
+        if self.entry_state(slot).load(Ordering::Acquire) == ENTRY_LIVE
+            && self.entry_name(slot) == name
+        {
+            return Some(entry);
+        }
+        self.unlock_entry(entry);
+        None
+    }
+
+    fn slot_info(&self, slot: usize, name: String) -> HeapObjectInfo {
+        let entry = self.entry_offset(slot);
+        HeapObjectInfo {
+            name,
+            offset: self.entry_u64(entry, SHARED_HEAP_ENTRY_OFFSET_OFFSET) as usize,
+            length: self.entry_u64(entry, SHARED_HEAP_ENTRY_LENGTH_OFFSET) as usize,
+            capacity: self.entry_u64(entry, SHARED_HEAP_ENTRY_CAPACITY_OFFSET) as usize,
+            version: self.entry_u64(entry, SHARED_HEAP_ENTRY_VERSION_OFFSET),
+        }
+    }
+
+    fn entry_name(&self, slot: usize) -> String {
+        let entry = self.entry_offset(slot);
+        let len = (self.name_len(entry).load(Ordering::Acquire) as usize).min(SHARED_HEAP_NAME_MAX);
+        let start = entry + SHARED_HEAP_ENTRY_NAME_OFFSET;
+        String::from_utf8_lossy(&self.mmap[start..start + len]).into_owned()
+    }
+
+    fn entry_offset(&self, slot: usize) -> usize {
+        self.dir_offset + slot * SHARED_HEAP_ENTRY_SIZE
+    }
+
+    fn entry_state(&self, slot: usize) -> &AtomicU32 {
+        self.atomic_u32(self.entry_offset(slot) + SHARED_HEAP_ENTRY_STATE_OFFSET)
+    }
+
+    fn name_len(&self, entry: usize) -> &AtomicU32 {
+        self.atomic_u32(entry + SHARED_HEAP_ENTRY_NAME_LEN_OFFSET)
+    }
+
+    fn seq(&self, entry: usize) -> &AtomicU64 {
+        self.atomic_u64(entry + SHARED_HEAP_ENTRY_SEQ_OFFSET)
+    }
+
+    fn entry_u64(&self, entry: usize, field: usize) -> u64 {
+        self.atomic_u64(entry + field).load(Ordering::Acquire)
+    }
+
+    fn set_entry_u64(&self, entry: usize, field: usize, value: u64) {
+        self.atomic_u64(entry + field)
+            .store(value, Ordering::Release);
+    }
+
+    fn free_head(&self, class: usize) -> &AtomicU64 {
+        self.atomic_u64(self.free_offset + class * 8)
+    }
+
+    fn atomic_u64(&self, offset: usize) -> &AtomicU64 {
+        debug_assert!(offset % 8 == 0 && offset + 8 <= self.mmap.len());
+        // SAFETY: offset is 8-aligned within the page-aligned mapping.
+        unsafe { &*(self.mmap.as_ptr().add(offset) as *const AtomicU64) }
+    }
+
+    fn atomic_u32(&self, offset: usize) -> &AtomicU32 {
+        debug_assert!(offset % 4 == 0 && offset + 4 <= self.mmap.len());
+        // SAFETY: offset is 4-aligned within the page-aligned mapping.
+        unsafe { &*(self.mmap.as_ptr().add(offset) as *const AtomicU32) }
+    }
+}
+
+impl Drop for SharedHeap {
+    fn drop(&mut self) {
+        if self.owner
+            && self.path.exists()
+            && let Err(e) = std::fs::remove_file(&self.path)
+        {
+            eprintln!("Warning: Failed to remove heap file {:?}: {}", self.path, e);
+        }
+    }
+}
+
+/// One heap object used as a [`SharedMemoryRegion`].
+///
+/// Lets a `MemioState` (typically a shard of a `ShardedMemioState`) publish
+/// into a shared heap: every shard is an object with its own version in the
+/// heap directory, all behind a single mapping and registry line. Objects
+/// grow as needed, so the payload is only bounded by the heap arena.
+#[derive(Debug, Clone)]
+pub struct HeapObjectRegion {
+    heap: Arc<SharedHeap>,
+    name: String,
+}
+
+impl HeapObjectRegion {
+    /// Binds object `name` of `heap`; the object is created on first write.
+    pub fn new(heap: Arc<SharedHeap>, name: impl Into<String>) -> Self {
+        Self {
+            heap,
+            name: name.into(),
+        }
+    }
+
+    /// Returns the object name.
+    pub fn name(&self) -> &str {
+        &self.name
+    }
+
+    /// Returns the heap holding the object.
+    pub fn heap(&self) -> &Arc<SharedHeap> {
+        &self.heap
+    }
+
+    fn state_info(&self, object: HeapObjectInfo) -> SharedStateInfo {
+        self.heap.state_info(object)
+    }
+}
+
+impl SharedMemoryRegion for HeapObjectRegion {
+    fn capacity(&self) -> usize {
+        self.heap.capacity()
+    }
+
+    fn info(&self) -> MemioResult<SharedStateInfo> {
+        self.heap
+            .info(&self.name)
+            .map(|object| self.state_info(object))
+    }
+
+    fn write(&mut self, version: u64, data: &[u8]) -> MemioResult<SharedStateInfo> {
+        self.heap
+            .write(&self.name, version, data)
+            .map(|object| self.state_info(object))
+    }
+
+    fn read(&self) -> MemioResult<Vec<u8>> {
+        self.heap.read(&self.name).map(|(_, data)| data)
+    }
+
+    /// Objects move when they grow, so there is no stable data pointer.
+    unsafe fn data_ptr(&self) -> *const u8 {
+        std::ptr::null()
+    }
+
+    unsafe fn data_ptr_mut(&mut self) -> *mut u8 {
+        std::ptr::null_mut()
+    }
+}
+
+/// Returns the size class index for an allocation of `size` bytes.
+fn size_class(size: usize) -> usize {
+    let blocks = size.max(1).div_ceil(SHARED_HEAP_MIN_BLOCK);
+    blocks.next_power_of_two().trailing_zeros() as usize
+}
+
+fn read_u64(buf: &[u8], offset: usize) -> u64 {
+    let mut bytes = [0u8; 8];
+    bytes.copy_from_slice(&buf[offset..offset + 8]);
+    u64::from_le_bytes(bytes)
+}
+
+fn align_up(value: usize, align: usize) -> usize {
+    (value + align - 1) & !(align - 1)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::env;
+
+    fn test_heap(capacity: usize, slots: usize) -> SharedHeap {
+        let temp_dir = env::temp_dir().join("memio_test");
+        std::fs::create_dir_all(&temp_dir).unwrap();
+        SharedHeap::create_in(temp_dir, "heap", capacity, slots).unwrap()
+    }
+
+    #[test]
+    fn test_heap_write_and_read() {
+        let heap = test_heap(64 * 1024, 16);
+        let generation = heap.generation();
+
+        heap.write("a", 1, b"alpha").unwrap();
+        heap.write("b", 7, b"bravo bravo").unwrap();
+        assert!(heap.changed_since(generation));
+
+        assert_eq!(heap.read("a").unwrap(), (1, b"alpha".to_vec()));
+        assert_eq!(heap.read("b").unwrap(), (7, b"bravo bravo".to_vec()));
+        assert_eq!(heap.list().len(), 2);
+
+        let reopened = SharedHeap::open(heap.path()).unwrap();
+        assert_eq!(reopened.read("b").unwrap().0, 7);
+    }
+
+    #[test]
+    fn test_heap_grow_and_reuse() {
+        let heap = test_heap(64 * 1024, 16);
+
+        let small = heap.write("obj", 1, &[1u8; 10]).unwrap();
+        assert_eq!(small.capacity, SHARED_HEAP_MIN_BLOCK);
+
+        let grown = heap.write("obj", 2, &[2u8; 1000]).unwrap();
+        assert_eq!(grown.capacity, 1024);
+        assert_eq!(heap.read("obj").unwrap(), (2, vec![2u8; 1000]));
+
+        // The released 64-byte block is handed out again.
+        let other = heap.write("other", 1, &[3u8; 8]).unwrap();
+        assert_eq!(other.offset, small.offset);
+
+        heap.remove("obj").unwrap();
+        assert!(heap.read("obj").is_err());
+        let again = heap.write("again", 1, &[4u8; 900]).unwrap();
+        assert_eq!(again.offset, grown.offset);
+    }
+
+    #[test]
+    fn test_heap_full() {
+        let heap = test_heap(256, 4);
+        heap.write("a", 1, &[0u8; 200]).unwrap();
+        assert!(matches!(
+            heap.write("b", 1, &[0u8; 200]),
+            Err(MemioError::ArenaFull { .. })
+        ));
+    }
+
+    #[test]
+    fn test_concurrent_alloc() {
+        let heap = std::sync::Arc::new(test_heap(1024 * 1024, 512));
+        let handles: Vec<_> = (0..4)
+            .map(|t| {
+                let heap = heap.clone();
+                std::thread::spawn(move || {
+                    for i in 0..100 {
+                        let name = format!("t{}_{}", t, i);
+                        heap.write(&name, i, name.as_bytes()).unwrap();
+                    }
+                })
+            })
+            .collect();
+        for handle in handles {
+            handle.join().unwrap();
+        }
+
+        let mut offsets: Vec<_> = heap.list().into_iter().map(|o| o.offset).collect();
+        assert_eq!(offsets.len(), 400);
+        offsets.sort_unstable();
+        offsets.dedup();
+        assert_eq!(offsets.len(), 400);
+    }
+
+    #[test]
+    fn test_concurrent_claim_same_name() {
+        let heap = std::sync::Arc::new(test_heap(1024 * 1024, 512));
+        let start = std::sync::Arc::new(std::sync::Barrier::new(4));
+        let handles: Vec<_> = (0..4)
+            .map(|t| {
+                let heap = heap.clone();
+                let start = start.clone();
+                std::thread::spawn(move || {
+                    start.wait();
+                    for i in 0..100 {
+                        heap.write(&format!("shared_{}", i), t, &[t as u8; 32])
+                            .unwrap();
+                    }
+                })
+            })
+            .collect();
+        for handle in handles {
+            handle.join().unwrap();
+        }
+
+        let mut names: Vec<_> = heap.list().into_iter().map(|o| o.name).collect();
+        assert_eq!(names.len(), 100);
+        names.sort_unstable();
+        names.dedup();
+        assert_eq!(names.len(), 100);
+    }
+
+    #[test]
+    fn test_concurrent_write_and_remove() {
+        let heap = std::sync::Arc::new(test_heap(1024 * 1024, 64));
+        let start = std::sync::Arc::new(std::sync::Barrier::new(8));
+        let handles: Vec<_> = (0..8)
+            .map(|t| {
+                let heap = heap.clone();
+                let start = start.clone();
+                std::thread::spawn(move || {
+                    start.wait();
+                    for i in 0..5000u64 {
+                        let name = format!("obj_{}", i % 2);
+                        if (t + i) % 2 == 0 {
+                            let fill = [(t * 16 + i % 2) as u8; 48];
+                            heap.write(&name, i, &fill).unwrap();
+                        } else {
+                            match heap.remove(&name) {
+                                Ok(()) | Err(MemioError::NotFound(_)) => {}
+                                Err(e) => panic!("remove failed: {e}"),
+                            }
+                        }
+                    }
+                })
+            })
+            .collect();
+        for handle in handles {
+            handle.join().unwrap();
+        }
+
+        // No block was freed twice or shared by two live objects, and every
+        // survivor holds bytes written under its own name
+        let objects = heap.list();
+        let mut offsets: Vec<_> = objects.iter().map(|o| o.offset).collect();
+        offsets.sort_unstable();
+        offsets.dedup();
+        assert_eq!(offsets.len(), objects.len());
+        for object in &objects {
+            let (_, data) = heap.read(&object.name).unwrap();
+            let index = object.name["obj_".len()..].parse::<u8>().unwrap();
+            assert_eq!(data.len(), 48);
+            assert!(data.iter().all(|&b| b == data[0] && b % 16 == index));
+        }
+        for i in 0..32 {
+            let fresh = heap.write(&format!("fresh_{}", i), 1, &[0u8; 48]).unwrap();
+            assert!(!offsets.contains(&fresh.offset));
+            offsets.push(fresh.offset);
+        }
+    }
+
+    #[test]
+    fn test_read_gives_up_on_bad_entries() {
+        let heap = test_heap(64 * 1024, 16);
+        heap.write("a", 1, b"abc").unwrap();
+        let entry = heap.entry_offset(heap.find("a").unwrap());
+
+        // Writer died holding the entry
+        heap.lock_entry(entry);
+        assert!(matches!(heap.read("a"), Err(MemioError::Internal(_))));
+        heap.unlock_entry(entry);
+
+        heap.set_entry_u64(entry, SHARED_HEAP_ENTRY_LENGTH_OFFSET, u64::MAX / 2);
+        assert!(matches!(heap.read("a"), Err(MemioError::InvalidHeader)));
+    }
+
+    #[test]
+    fn test_object_region_shards() {
+        let heap = std::sync::Arc::new(test_heap(64 * 1024, 16));
+        let mut shards: Vec<_> = (0..3)
+            .map(|i| HeapObjectRegion::new(heap.clone(), format!("world/{}", i)))
+            .collect();
+        for (i, shard) in shards.iter_mut().enumerate() {
+            shard.write(1, &[i as u8; 100]).unwrap();
+        }
+
+        let generation = heap.generation();
+        let info = shards[1].write(2, &[9u8; 2000]).unwrap();
+        assert!(heap.changed_since(generation));
+        assert_eq!(
+            (info.name.as_str(), info.version, info.length),
+            ("world/1", 2, 2000)
+        );
+        assert_eq!(shards[1].read().unwrap(), vec![9u8; 2000]);
+
+        // Untouched shards keep their version and bytes
+        assert_eq!(shards[0].info().unwrap().version, 1);
+        assert_eq!(heap.read("world/2").unwrap(), (1, vec![2u8; 100]));
+    }
+}
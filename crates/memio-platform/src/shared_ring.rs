@@ -1,6 +1,10 @@
 //! Shared ring buffer implementation.
 //!
 //! Provides a memory-mapped file-based ring buffer for inter-process communication.
+//!
+//! Single producer, single consumer. The layout is shared with the WebKit
+//! extension (`shared/shared_rpc_spec.json`): a 64-byte header holding
+//! magic, capacity, head and tail, followed by the data area.
 
 use std::fs::OpenOptions;
 use std::path::{Path, PathBuf};
@@ -8,9 +12,12 @@ use std::sync::atomic::{AtomicU64, Ordering};
 
 use memmap2::MmapMut;
 
+use memio_core::shared_rpc_spec::{
+    SHARED_RING_CAPACITY_OFFSET, SHARED_RING_HEAD_OFFSET, SHARED_RING_HEADER_SIZE,
+    SHARED_RING_MAGIC, SHARED_RING_TAIL_OFFSET,
+};
 use memio_core::{MemioError, MemioResult};
 
-const RING_MAGIC: u64 = 0x5455_5242_4F52_494E; // "MEMIORIN"
 static RING_COUNTER: AtomicU64 = AtomicU64::new(0);
 
 #[repr(C)]
@@ -50,7 +57,10 @@ impl SharedRingBuffer {
         let path = path.as_ref().to_path_buf();
         let metadata = std::fs::metadata(&path)?;
         let size = metadata.len() as usize;
-        Self::open_or_create(path, size, false)
+        if size < SHARED_RING_HEADER_SIZE {
+            return Err(MemioError::InvalidHeader);
+        }
+        Self::open_or_create(path, size - SHARED_RING_HEADER_SIZE, false)
     }
 
     /// Returns the path to the ring buffer file.
@@ -63,6 +73,50 @@ impl SharedRingBuffer {
         self.capacity
     }
 
+    /// Returns the number of bytes waiting to be read.
+    pub fn available(&self) -> usize {
+        let header = self.header();
+        let head = header.head.load(Ordering::Acquire);
+        let tail = header.tail.load(Ordering::Acquire);
+        head.wrapping_sub(tail) as usize
+    }
+
+    /// Returns the number of bytes that can be written without blocking.
+    pub fn free_space(&self) -> usize {
+        self.capacity.saturating_sub(self.available())
+    }
+
+    /// Writes all `parts` back to back, or nothing if they do not fit.
+    ///
+    /// The head is published once, so a reader never sees a partial batch.
+    /// Returns false when the ring is too full.
+    pub fn try_write_all(&mut self, parts: &[&[u8]]) -> MemioResult<bool> {
+        let total: usize = parts.iter().map(|p| p.len()).sum();
+        if total > self.free_space() {
+            return Ok(false);
+        }
+
+        let header_ptr = self.mmap.as_mut_ptr() as *mut RingHeader;
+        let head = unsafe { (*header_ptr).head.load(Ordering::Acquire) };
+        let mut pos = head;
+        for part in parts {
+            self.copy_in(pos, part);
+            pos = pos.wrapping_add(part.len() as u64);
+        }
+        unsafe {
+            (*header_ptr).head.store(pos, Ordering::Release);
+        }
+        Ok(true)
+    }
+
+    /// Copies up to `out.len()` readable bytes without consuming them.
+    pub fn peek(&self, out: &mut [u8]) -> usize {
+        let n = out.len().min(self.available());
+        let tail = self.header().tail.load(Ordering::Acquire);
+        self.copy_out(tail, &mut out[..n]);
+        n
+    }
+
     /// Writes data to the ring buffer.
     ///
     /// Returns the number of bytes written. May be less than `data.len()`
@@ -147,8 +201,7 @@ impl SharedRingBuffer {
     }
 
     fn open_or_create(path: PathBuf, capacity: usize, create: bool) -> MemioResult<Self> {
-        let header_size = std::mem::size_of::<RingHeader>();
-        let data_offset = align_up(header_size, 64);
+        let data_offset = SHARED_RING_HEADER_SIZE;
         let file_len = data_offset + capacity;
 
         let file = OpenOptions::new()
@@ -167,7 +220,7 @@ impl SharedRingBuffer {
         if create {
             unsafe {
                 header_ptr.write(RingHeader {
-                    magic: RING_MAGIC,
+                    magic: SHARED_RING_MAGIC,
                     capacity: capacity as u64,
                     head: AtomicU64::new(0),
                     tail: AtomicU64::new(0),
@@ -175,7 +228,7 @@ impl SharedRingBuffer {
             }
         } else {
             let header = unsafe { &*header_ptr };
-            if header.magic != RING_MAGIC {
+            if header.magic != SHARED_RING_MAGIC || header.capacity as usize != capacity {
                 return Err(MemioError::Internal(
                     "Invalid ring buffer magic.".to_string(),
                 ));
@@ -190,12 +243,74 @@ impl SharedRingBuffer {
         })
     }
 
-    #[allow(dead_code)]
     fn header(&self) -> &RingHeader {
         unsafe { &*(self.mmap.as_ptr() as *const RingHeader) }
     }
+
+    /// Copies `data` to stream position `pos`, wrapping at the end.
+    fn copy_in(&mut self, pos: u64, data: &[u8]) {
+        let write_pos = (pos as usize) % self.capacity;
+        let first = data.len().min(self.capacity - write_pos);
+        let base = unsafe { self.mmap.as_mut_ptr().add(self.data_offset) };
+        unsafe {
+            std::ptr::copy_nonoverlapping(data.as_ptr(), base.add(write_pos), first);
+            std::ptr::copy_nonoverlapping(data.as_ptr().add(first), base, data.len() - first);
+        }
+    }
+
+    /// Copies `out.len()` bytes from stream position `pos`, wrapping at the end.
+    fn copy_out(&self, pos: u64, out: &mut [u8]) {
+        let read_pos = (pos as usize) % self.capacity;
+        let first = out.len().min(self.capacity - read_pos);
+        let base = unsafe { self.mmap.as_ptr().add(self.data_offset) };
+        unsafe {
+            std::ptr::copy_nonoverlapping(base.add(read_pos), out.as_mut_ptr(), first);
+            std::ptr::copy_nonoverlapping(base, out.as_mut_ptr().add(first), out.len() - first);
+        }
+    }
 }
 
-fn align_up(value: usize, align: usize) -> usize {
-    (value + align - 1) & !(align - 1)
+// The struct layout is what the extension reads through the spec offsets.
+const _: () = {
+    assert!(std::mem::offset_of!(RingHeader, capacity) == SHARED_RING_CAPACITY_OFFSET);
+    assert!(std::mem::offset_of!(RingHeader, head) == SHARED_RING_HEAD_OFFSET);
+    assert!(std::mem::offset_of!(RingHeader, tail) == SHARED_RING_TAIL_OFFSET);
+    assert!(std::mem::size_of::<RingHeader>() <= SHARED_RING_HEADER_SIZE);
+};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_write_all_is_all_or_nothing() {
+        let mut ring = SharedRingBuffer::create(32).unwrap();
+        assert!(ring.try_write_all(&[b"0123456789", b"abcdef"]).unwrap());
+        assert!(!ring.try_write_all(&[&[0u8; 17]]).unwrap());
+        assert_eq!(ring.available(), 16);
+
+        let mut out = [0u8; 16];
+        assert_eq!(ring.peek(&mut out), 16);
+        assert_eq!(&out, b"0123456789abcdef");
+        assert_eq!(ring.read(&mut out).unwrap(), 16);
+        assert_eq!(ring.available(), 0);
+        let _ = std::fs::remove_file(ring.path());
+    }
+
+    #[test]
+    fn test_wraps_and_reopens() {
+        let mut ring = SharedRingBuffer::create(16).unwrap();
+        let mut out = [0u8; 12];
+        ring.write(&[1u8; 12]).unwrap();
+        ring.read(&mut out).unwrap();
+        // Crosses the end of the data area
+        assert!(ring.try_write_all(&[&[2u8; 6], &[3u8; 6]]).unwrap());
+
+        let mut other = SharedRingBuffer::open(ring.path()).unwrap();
+        assert_eq!(other.capacity(), 16);
+        assert_eq!(other.read(&mut out).unwrap(), 12);
+        assert_eq!(&out[..6], &[2u8; 6]);
+        assert_eq!(&out[6..], &[3u8; 6]);
+        let _ = std::fs::remove_file(ring.path());
+    }
 }
@@ -0,0 +1,252 @@
+//! Point-in-time snapshots of memio regions.
+//!
+//! A [`RegionSnapshot`] gives long-running readers (exporters, compute
+//! workers) a stable view of one published version while the writer keeps
+//! publishing new ones.
+//!
+//! On Linux the snapshot is copy-on-write at page granularity: it reads
+//! through a read-only mapping of the region file, and the writing region
+//! copies a page into the snapshot's overlay only right before it changes
+//! that page. Taking a snapshot is O(1); its cost afterwards is proportional
+//! to how much the writer changes, not to the buffer size.
+//!
+//! Other platforms fall back to an owned copy of the payload.
+
+#[cfg(target_os = "linux")]
+use std::collections::HashMap;
+#[cfg(target_os = "linux")]
+use std::sync::{Arc, Mutex};
+
+use memio_core::SharedMemoryError;
+#[cfg(target_os = "linux")]
+use memmap2::Mmap;
+
+/// Granularity of copy-on-write preservation.
+#[cfg(target_os = "linux")]
+pub(crate) const SNAPSHOT_PAGE_SIZE: usize = 4096;
+
+/// Page-granular copy-on-write view of a region payload.
+///
+/// Shared between a [`RegionSnapshot`] and the region that produced it;
+/// the region only holds a weak reference, so dropping the snapshot stops
+/// all preservation work.
+#[cfg(target_os = "linux")]
+#[derive(Debug)]
+pub(crate) struct CowPages {
+    /// Read-only mapping of the whole region file.
+    base: Arc<Mmap>,
+    /// Payload offset inside `base`.
+    offset: usize,
+    /// Payload length at the time of the snapshot.
+    length: usize,
+    /// Pages preserved before the writer overwrote them.
+    overlay: Mutex<HashMap<usize, Box<[u8]>>>,
+}
+
+#[cfg(target_os = "linux")]
+impl CowPages {
+    pub(crate) fn new(base: Arc<Mmap>, offset: usize, length: usize) -> Self {
+        Self {
+            base,
+            offset,
+            length,
+            overlay: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Preserves every snapshot page that writing `data` at payload offset
+    /// `at` is about to change. `current` is the live payload.
+    ///
+    /// Must be called before the write. Pages whose bytes would not change
+    /// are skipped so rewriting identical data costs no memory.
+    pub(crate) fn preserve(&self, current: &[u8], at: usize, data: &[u8]) {
+        let end = (at + data.len()).min(self.length);
+        if at >= end {
+            return;
+        }
+
+        let Ok(mut overlay) = self.overlay.lock() else {
+            return;
+        };
+        let first = at / SNAPSHOT_PAGE_SIZE;
+        let last = (end - 1) / SNAPSHOT_PAGE_SIZE;
+        for page in first..=last {
+            if overlay.contains_key(&page) {
+                continue;
+            }
+            let page_start = page * SNAPSHOT_PAGE_SIZE;
+            let page_end = (page_start + SNAPSHOT_PAGE_SIZE).min(self.length);
+
+            // Only the part of the page covered by this write can change.
+            let touch_start = page_start.max(at);
+            let touch_end = page_end.min(at + data.len());
+            if current[touch_start..touch_end] == data[touch_start - at..touch_end - at] {
+                continue;
+            }
+
+            overlay.insert(page, current[page_start..page_end].into());
+        }
+    }
+
+    fn read_into(&self, offset: usize, dst: &mut [u8]) {
+        let live = &self.base[self.offset..self.offset + self.length];
+        let mut pos = offset;
+        let mut out = 0;
+        while out < dst.len() {
+            let page = pos / SNAPSHOT_PAGE_SIZE;
+            let in_page = pos % SNAPSHOT_PAGE_SIZE;
+            let n = (SNAPSHOT_PAGE_SIZE - in_page).min(dst.len() - out);
+
+            // Hold the overlay lock while copying from the live mapping: the
+            // writer preserves a page under the same lock before touching it,
+            // so a page missing from the overlay cannot change mid-copy.
+            let overlay = self.overlay.lock().unwrap_or_else(|e| e.into_inner());
+            match overlay.get(&page) {
+                Some(saved) => dst[out..out + n].copy_from_slice(&saved[in_page..in_page + n]),
+                None => dst[out..out + n].copy_from_slice(&live[pos..pos + n]),
+            }
+            drop(overlay);
+
+            pos += n;
+            out += n;
+        }
+    }
+
+    fn preserved_bytes(&self) -> usize {
+        self.overlay
+            .lock()
+            .map(|o| o.values().map(|p| p.len()).sum())
+            .unwrap_or(0)
+    }
+}
+
+#[derive(Debug)]
+enum SnapshotData {
+    Owned(Vec<u8>),
+    #[cfg(target_os = "linux")]
+    Cow(Arc<CowPages>),
+}
+
+/// Consistent view of one version of a memio region.
+///
+/// Obtained from [`MemioManager::snapshot`](crate::MemioManager::snapshot)
+/// or `LinuxSharedMemoryRegion::snapshot`. The contents never change, no
+/// matter how many versions the writer publishes afterwards.
+///
+/// Writes that bypass the region (raw `data_ptr_mut` access or frontend
+/// writes through the WebKit extension) are not tracked.
+///
+/// # Example
+/// ```ignore
+/// let snap = manager.snapshot("scene")?;
+/// let mut chunk = vec![0u8; 64 * 1024];
+/// for offset in (0..snap.len()).step_by(chunk.len()) {
+///     let n = chunk.len().min(snap.len() - offset);
+///     snap.read_at(offset, &mut chunk[..n])?;
+///     exporter.push(&chunk[..n]);
+/// }
+/// ```
+#[derive(Debug)]
+pub struct RegionSnapshot {
+    name: String,
+    version: u64,
+    data: SnapshotData,
+}
+
+impl RegionSnapshot {
+    /// Creates a snapshot that owns a copy of the payload.
+    pub fn from_vec(name: impl Into<String>, version: u64, data: Vec<u8>) -> Self {
+        Self {
+            name: name.into(),
+            version,
+            data: SnapshotData::Owned(data),
+        }
+    }
+
+    #[cfg(target_os = "linux")]
+    pub(crate) fn from_cow(name: impl Into<String>, version: u64, pages: Arc<CowPages>) -> Self {
+        Self {
+            name: name.into(),
+            version,
+            data: SnapshotData::Cow(pages),
+        }
+    }
+
+    /// Returns the region name.
+    pub fn name(&self) -> &str {
+        &self.name
+    }
+
+    /// Returns the version captured by this snapshot.
+    pub fn version(&self) -> u64 {
+        self.version
+    }
+
+    /// Returns the payload length in bytes.
+    pub fn len(&self) -> usize {
+        match &self.data {
+            SnapshotData::Owned(v) => v.len(),
+            #[cfg(target_os = "linux")]
+            SnapshotData::Cow(p) => p.length,
+        }
+    }
+
+    /// Returns true if the payload is empty.
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Copies `dst.len()` bytes starting at `offset` into `dst`.
+    pub fn read_at(&self, offset: usize, dst: &mut [u8]) -> Result<(), SharedMemoryError> {
+        let end = offset
+            .checked_add(dst.len())
+            .filter(|&end| end <= self.len())
+            .ok_or(SharedMemoryError::DataTooLarge {
+                data_len: offset.saturating_add(dst.len()),
+                capacity: self.len(),
+            })?;
+
+        match &self.data {
+            SnapshotData::Owned(v) => dst.copy_from_slice(&v[offset..end]),
+            #[cfg(target_os = "linux")]
+            SnapshotData::Cow(p) => p.read_into(offset, dst),
+        }
+        Ok(())
+    }
+
+    /// Copies the whole payload into a new `Vec`.
+    pub fn to_vec(&self) -> Vec<u8> {
+        let mut out = vec![0u8; self.len()];
+        let _ = self.read_at(0, &mut out);
+        out
+    }
+
+    /// Returns how many bytes were copied to keep this snapshot stable.
+    ///
+    /// Zero right after the snapshot is taken; grows with the pages the
+    /// writer modifies. Owned snapshots report their full length.
+    pub fn preserved_bytes(&self) -> usize {
+        match &self.data {
+            SnapshotData::Owned(v) => v.len(),
+            #[cfg(target_os = "linux")]
+            SnapshotData::Cow(p) => p.preserved_bytes(),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_owned_snapshot_read_at() {
+        let snap = RegionSnapshot::from_vec("s", 3, b"hello world".to_vec());
+        assert_eq!(snap.version(), 3);
+        assert_eq!(snap.len(), 11);
+
+        let mut buf = [0u8; 5];
+        snap.read_at(6, &mut buf).unwrap();
+        assert_eq!(&buf, b"world");
+        assert!(snap.read_at(7, &mut buf).is_err());
+    }
+}
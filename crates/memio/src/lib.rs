@@ -45,6 +45,7 @@ pub use memio_core::{
     MemioSchema,
     MemioState,
     NoOpRegion,
+    PublishPolicy,
     SharedMemoryError,
     SharedMemoryFactory,
     SharedMemoryRegion,
@@ -97,7 +98,8 @@ pub mod plugin {
 pub mod prelude {
     // Core types
     pub use crate::{
-        MemioError, MemioManager, MemioResult, MemioState, ReadResult, SharedStateInfo, WriteResult,
+        MemioError, MemioManager, MemioResult, MemioState, PublishPolicy, ReadResult,
+        SharedStateInfo, WriteResult,
     };
 
     // Derive macro
@@ -8,6 +8,9 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include "memio_spec.h"
 
@@ -26,24 +29,161 @@ static const char* JS_MEMIO_LIST_BUFFERS =
 
 static const char* JS_MEMIO_SHARED_DEBUG = 
   "globalThis.__memioSharedDebug = function(){ "
+  "var stats = globalThis.__memioExtensionStats ? globalThis.__memioExtensionStats() : {}; "
   "return { "
     "has: !!globalThis.__memioSharedBuffers, "
-    "keys: globalThis.__memioSharedBuffers ? Object.keys(globalThis.__memioSharedBuffers) : [] "
+    "keys: globalThis.__memioSharedBuffers ? Object.keys(globalThis.__memioSharedBuffers) : [], "
+    "evaluations: stats.evaluations, "
+    "copies: stats.copies, "
+    "bytesCopied: stats.bytesCopied "
   "}; "
   "};";
 
+// Buffers accessed within this window keep being refreshed in the
+// background; older ones are only refreshed on their next access.
+#define MEMIO_ACTIVE_WINDOW_US (2 * G_USEC_PER_SEC)
+
+// New versions at least this large are copied on a worker thread and
+// swapped in by the main loop; smaller ones are cheaper to copy inline.
+#define MEMIO_ASYNC_COPY_MIN (1024 * 1024)
+
+// Staging blocks kept for reuse once JS has released them.
+#define MEMIO_STAGING_POOL_MAX 8
+
+// Copies memioReadInto attempts before reporting a race with the writer.
+#define MEMIO_READ_INTO_ATTEMPTS 4
+
+// Refresh interval without a doorbell, and the safety-net interval with one
+#define MEMIO_POLL_INTERVAL_MS 100
+#define MEMIO_DOORBELL_POLL_INTERVAL_MS 1000
+
+typedef struct _SharedCache SharedCache;
+
+// Native storage for one buffer's bytes. Every JS context wraps the same
+// block zero-copy (jsc_value_new_array_buffer), so N frames cost one copy.
+// Each wrapper and the owning cache hold a reference; the last one returns
+// the block to the staging pool.
 typedef struct {
+  guint8 *data;
+  gsize capacity;
+  gint refs;
+} StagingBlock;
+
+struct _SharedCache {
   char *path;
   GMappedFile *file;
   gsize file_len;
-  guint64 last_version;
-  guint64 last_length;
+  guint64 last_version;   // Version held by `block`
+  guint64 last_length;    // Payload length held by `block`
   gboolean failed;  // Track if mapping failed to avoid repeated logs
-} SharedCache;
+  gboolean is_heap;       // Mapping is a multi-object heap, not a buffer
+  SharedCache *heap;      // Heap holding this object (heap objects only)
+  gboolean listed;        // Has a __memioSharedManifest entry
+  guint64 manifest_length;
+  StagingBlock *block;    // Pooled storage, grown geometrically, never shrunk
+  StagingBlock *spare;    // Previous block, reused by the next worker copy
+  guint generation;       // Bumped when `block` or the served length changes
+  gint64 last_access;     // Monotonic time of the last JS access
+  gboolean pending;       // A worker copy is in flight
+  guint64 *ack_word;      // Writable view of the header's reader ack word
+  gboolean ack_failed;    // Header could not be mapped writable
+};
+
+typedef struct {
+  SharedCache *cache;   // Caches live as long as the process
+  gchar *name;
+  GMappedFile *file;    // Keeps the mapping alive while the worker copies
+  guint8 header[MEMIO_HEADER_SIZE];
+  gsize payload_offset;
+  gsize check_offset;   // u64 in the mapping that must not change during the copy
+  guint64 check_value;
+  guint64 version;
+  guint64 length;
+  StagingBlock *block;
+  gboolean torn;
+} CopyJob;
+
+// A JS context served by the extension: one frame in one script world.
+typedef struct {
+  GWeakRef frame;
+  WebKitScriptWorld *world;  // Not owned; worlds live as long as the process
+  JSCContext *context;
+} ContextBinding;
+
+// Per-context wrapper of a cache's block, kept as context data.
+typedef struct {
+  JSCValue *typed;
+  guint generation;
+} ContextView;
+
+// Extension counters, exposed through __memioSharedDebug().
+// `evaluations` counts JS source compiled by the extension; the refresh
+// path must not add to it.
+static guint64 stat_evaluations = 0;
+static guint64 stat_copies = 0;
+static guint64 stat_bytes_copied = 0;
+
+static GThreadPool *copy_pool = NULL;
+static GMutex staging_lock;
+static GSList *staging_free = NULL;  // StagingBlock*, guarded by staging_lock
+static guint staging_free_len = 0;
 
 static GHashTable *shared_cache_map = NULL;
+static GHashTable *registry_entries = NULL;  // name -> path, from the registry file
 static gchar *registry_path = NULL;
 
+// Doorbell from MEMIO_SHARED_DOORBELL: a process-shared futex word the
+// backend bumps after every publish. NULL when the backend has none.
+static guint32 *doorbell_sequence = NULL;
+static guint32 *doorbell_waiters = NULL;
+static gint doorbell_pending = 0;
+
+static GPtrArray *bindings = NULL;       // ContextBinding*
+static GPtrArray *script_worlds = NULL;  // WebKitScriptWorld*, default world first
+static guint refresh_source = 0;
+
+static void staging_unref(gpointer data);
+
+static void ack_unmap(SharedCache *cache) {
+  if (cache->ack_word) {
+    munmap((guint8 *)cache->ack_word - MEMIO_ACK_OFFSET, MEMIO_HEADER_SIZE);
+    cache->ack_word = NULL;
+  }
+  cache->ack_failed = FALSE;
+}
+
+// Raises the buffer's reader ack word to `version` once JS has actually
+// consumed it, so a backend using PublishPolicy::OnDemand publishes again.
+// The cache mapping is read-only, so the header alone is mapped writable.
+static void ack_version(SharedCache *cache, guint64 version) {
+  if (!cache->path || cache->heap || cache->is_heap || version == 0) {
+    return;
+  }
+  if (!cache->ack_word) {
+    if (cache->ack_failed) {
+      return;
+    }
+    int fd = open(cache->path, O_RDWR);
+    guint8 *header = fd < 0 ? MAP_FAILED
+                            : mmap(NULL, MEMIO_HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+                                   fd, 0);
+    if (fd >= 0) {
+      close(fd);
+    }
+    if (header == MAP_FAILED) {
+      cache->ack_failed = TRUE;
+      return;
+    }
+    cache->ack_word = (guint64 *)(header + MEMIO_ACK_OFFSET);
+  }
+
+  guint64 seen = __atomic_load_n(cache->ack_word, __ATOMIC_RELAXED);
+  while (seen < version &&
+         !__atomic_compare_exchange_n(cache->ack_word, &seen, version, TRUE, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED)) {
+  }
+}
+
 static void shared_cache_free(gpointer data) {
   SharedCache *cache = (SharedCache *)data;
   if (!cache) {
@@ -52,6 +192,13 @@ static void shared_cache_free(gpointer data) {
   if (cache->file) {
     g_mapped_file_unref(cache->file);
   }
+  if (cache->block) {
+    staging_unref(cache->block);
+  }
+  if (cache->spare) {
+    staging_unref(cache->spare);
+  }
+  ack_unmap(cache);
   g_free(cache->path);
   g_free(cache);
 }
@@ -68,6 +215,16 @@ static SharedCache *get_cache(const char *name) {
   return cache;
 }
 
+static gboolean recently_accessed(SharedCache *cache) {
+  return cache->last_access > 0 &&
+         g_get_monotonic_time() - cache->last_access < MEMIO_ACTIVE_WINDOW_US;
+}
+
+// True if JS read this buffer recently and it is materialized.
+static gboolean cache_is_active(SharedCache *cache) {
+  return cache->block && recently_accessed(cache);
+}
+
 static gboolean ensure_cache(SharedCache *cache, const char *path) {
   if (!path || path[0] == '\0') {
     return FALSE;
@@ -78,6 +235,7 @@ static gboolean ensure_cache(SharedCache *cache, const char *path) {
       g_mapped_file_unref(cache->file);
       cache->file = NULL;
     }
+    ack_unmap(cache);
     g_free(cache->path);
     cache->path = g_strdup(path);
     cache->failed = FALSE;  // Reset failed flag for new path
@@ -115,7 +273,571 @@ static gboolean ensure_cache(SharedCache *cache, const char *path) {
   return cache->file != NULL;
 }
 
-static gboolean update_buffer(JSCContext *context, const char *name, const char *path) {
+// Every extension-side JS evaluation goes through here so it is counted.
+static JSCValue *memio_evaluate(JSCContext *context, const char *code) {
+  stat_evaluations++;
+  return jsc_context_evaluate(context, code, -1);
+}
+
+// __memioSharedManifest objects of one context, built through the JSC API
+// and mutated in place.
+typedef struct {
+  JSCValue *manifest;
+  JSCValue *buffers;
+  GHashTable *entries;  // name -> ManifestEntry
+} ManifestCache;
+
+typedef struct {
+  JSCValue *object;
+  guint64 length;
+} ManifestEntry;
+
+static void manifest_entry_free(gpointer data) {
+  ManifestEntry *entry = data;
+  g_object_unref(entry->object);
+  g_free(entry);
+}
+
+static void manifest_cache_free(gpointer data) {
+  ManifestCache *cache = data;
+  g_clear_object(&cache->manifest);
+  g_clear_object(&cache->buffers);
+  g_hash_table_destroy(cache->entries);
+  g_free(cache);
+}
+
+static void set_number(JSCValue *object, const char *name, double value) {
+  JSCValue *number = jsc_value_new_number(jsc_value_get_context(object), value);
+  jsc_value_object_set_property(object, name, number);
+  g_object_unref(number);
+}
+
+// Returns the manifest cache of `context`, (re)building the objects if
+// page JS replaced __memioSharedManifest.
+static ManifestCache *manifest_cache(JSCContext *context) {
+  ManifestCache *cache = g_object_get_data(G_OBJECT(context), "memio-manifest");
+  if (!cache) {
+    cache = g_new0(ManifestCache, 1);
+    cache->entries = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, manifest_entry_free);
+    g_object_set_data_full(G_OBJECT(context), "memio-manifest", cache, manifest_cache_free);
+  }
+
+  // JSC hands out one wrapper per JS object, so identity is a cheap check
+  JSCValue *current = jsc_context_get_value(context, "__memioSharedManifest");
+  if (current && current == cache->manifest) {
+    g_object_unref(current);
+    return cache;
+  }
+
+  g_clear_object(&cache->manifest);
+  g_clear_object(&cache->buffers);
+  g_hash_table_remove_all(cache->entries);
+  if (current && jsc_value_is_object(current)) {
+    // Adopt a manifest created by page JS, keeping its other fields
+    cache->manifest = current;
+    current = NULL;
+  } else {
+    cache->manifest = jsc_value_new_object(context, NULL, NULL);
+    set_number(cache->manifest, "version", 1);
+    jsc_context_set_value(context, "__memioSharedManifest", cache->manifest);
+  }
+  if (current) {
+    g_object_unref(current);
+  }
+
+  cache->buffers = jsc_value_object_get_property(cache->manifest, "buffers");
+  if (!cache->buffers || !jsc_value_is_object(cache->buffers)) {
+    g_clear_object(&cache->buffers);
+    cache->buffers = jsc_value_new_object(context, NULL, NULL);
+    jsc_value_object_set_property(cache->manifest, "buffers", cache->buffers);
+  }
+  return cache;
+}
+
+// Ensures __memioSharedManifest.buffers[name] exists and records its length.
+// Touches JS only when the entry is new or its length changed.
+static void update_manifest(JSCContext *context, const char *name, guint64 length) {
+  ManifestCache *cache = manifest_cache(context);
+  ManifestEntry *entry = g_hash_table_lookup(cache->entries, name);
+  if (entry && entry->length == length) {
+    return;
+  }
+
+  if (!entry) {
+    entry = g_new0(ManifestEntry, 1);
+    entry->object = jsc_value_new_object(context, NULL, NULL);
+    jsc_value_object_set_property(cache->buffers, name, entry->object);
+    g_hash_table_insert(cache->entries, g_strdup(name), entry);
+  }
+  entry->length = length;
+  set_number(entry->object, "length", (double)length);
+}
+
+// Lists every mapped buffer and heap object in the manifest of `context`.
+static void sync_manifest(JSCContext *context) {
+  if (!shared_cache_map) {
+    return;
+  }
+  GHashTableIter iter;
+  gpointer key = NULL;
+  gpointer value = NULL;
+  g_hash_table_iter_init(&iter, shared_cache_map);
+  while (g_hash_table_iter_next(&iter, &key, &value)) {
+    SharedCache *cache = value;
+    if (cache->listed) {
+      update_manifest(context, key, cache->manifest_length);
+    }
+  }
+}
+
+static gboolean update_buffer(const char *name, const char *path, gboolean materialize);
+static gboolean update_heap(SharedCache *heap);
+
+static void staging_ref(StagingBlock *block) {
+  g_atomic_int_inc(&block->refs);
+}
+
+static void context_view_free(gpointer data) {
+  ContextView *view = data;
+  g_clear_object(&view->typed);
+  g_free(view);
+}
+
+// Returns `context`'s Uint8Array over the cache's block. Views are rebuilt
+// only after the block or the length changed; that costs an O(1) wrapper,
+// never a copy, however many contexts read the buffer.
+static JSCValue *context_view(JSCContext *context, SharedCache *cache, const char *name) {
+  if (!cache->block) {
+    return NULL;
+  }
+
+  GHashTable *views = g_object_get_data(G_OBJECT(context), "memio-views");
+  if (!views) {
+    views = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, context_view_free);
+    g_object_set_data_full(G_OBJECT(context), "memio-views", views,
+                           (GDestroyNotify)g_hash_table_destroy);
+  }
+  ContextView *view = g_hash_table_lookup(views, name);
+  if (view && view->typed && view->generation == cache->generation) {
+    return g_object_ref(view->typed);
+  }
+  if (!view) {
+    view = g_new0(ContextView, 1);
+    g_hash_table_insert(views, g_strdup(name), view);
+  }
+  g_clear_object(&view->typed);
+
+  StagingBlock *block = cache->block;
+  staging_ref(block);
+  JSCValue *buffer = jsc_value_new_array_buffer(context, block->data, block->capacity,
+                                                staging_unref, block);
+  if (!buffer) {
+    staging_unref(block);
+    return NULL;
+  }
+  view->typed = jsc_value_new_typed_array_with_buffer(
+      buffer, JSC_TYPED_ARRAY_UINT8, 0, (gssize)(MEMIO_HEADER_SIZE + cache->last_length));
+  view->generation = cache->generation;
+  g_object_unref(buffer);
+  return view->typed ? g_object_ref(view->typed) : NULL;
+}
+
+// Property getter of __memioSharedBuffers: maps and copies a buffer only
+// when JS first reads it, and refreshes it on every later read. The copy is
+// shared by every context; this context only gets its own view.
+static JSCValue *shared_buffers_get(JSCClass *klass,
+                                    JSCContext *context,
+                                    gpointer instance,
+                                    const char *name) {
+  SharedCache *cache = shared_cache_map ? g_hash_table_lookup(shared_cache_map, name) : NULL;
+  const char *path = registry_entries ? g_hash_table_lookup(registry_entries, name) : NULL;
+  if (!cache && !path) {
+    return NULL;
+  }
+  if (!cache) {
+    cache = get_cache(name);
+  }
+
+  // Idle objects were skipped by background scans; rescan to catch up.
+  gboolean was_active = cache_is_active(cache);
+  cache->last_access = g_get_monotonic_time();
+  if (cache->heap) {
+    if (!was_active) {
+      cache->heap->last_version = 0;
+    }
+    update_heap(cache->heap);
+  } else if (path && !cache->is_heap) {
+    update_buffer(name, path, TRUE);
+    if (cache->block) {
+      ack_version(cache, cache->last_version);
+    }
+  }
+
+  return context_view(context, cache, name);
+}
+
+// Lists every buffer, materialized or not, for Object.keys().
+static gchar **shared_buffers_enumerate(JSCClass *klass, JSCContext *context, gpointer instance) {
+  GPtrArray *names = g_ptr_array_new();
+  if (shared_cache_map) {
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+    g_hash_table_iter_init(&iter, shared_cache_map);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+      SharedCache *cache = value;
+      gboolean registered = registry_entries && g_hash_table_contains(registry_entries, key);
+      if ((registered && !cache->is_heap) || cache->heap) {
+        g_ptr_array_add(names, g_strdup(key));
+      }
+    }
+  }
+  g_ptr_array_add(names, NULL);
+  return (gchar **)g_ptr_array_free(names, FALSE);
+}
+
+static JSCClass *shared_buffers_class(JSCContext *context) {
+  static JSCClassVTable vtable = {
+    .get_property = shared_buffers_get,
+    .enumerate_properties = shared_buffers_enumerate,
+  };
+  JSCClass *klass = g_object_get_data(G_OBJECT(context), "memio-shared-buffers-class");
+  if (!klass) {
+    klass = jsc_context_register_class(context, "MemioSharedBuffers", NULL, &vtable, NULL);
+    g_object_set_data(G_OBJECT(context), "memio-shared-buffers-class", klass);
+  }
+  return klass;
+}
+
+// Always ensure __memioSharedBuffers exists in `context`.
+static void ensure_shared_buffers(JSCContext *context) {
+  static int instance;  // Stateless: buffers live in shared_cache_map
+  JSCValue *shared = jsc_context_get_value(context, "__memioSharedBuffers");
+
+  if (!shared || !jsc_value_is_object(shared)) {
+    JSCValue *object = jsc_value_new_object(context, &instance, shared_buffers_class(context));
+    jsc_context_set_value(context, "__memioSharedBuffers", object);
+    g_object_unref(object);
+  }
+  if (shared) {
+    g_object_unref(shared);
+  }
+}
+
+// Takes a block of at least `size` bytes from the pool, or allocates one
+// rounded up to a power of two so nearby sizes share blocks.
+static StagingBlock *staging_acquire(gsize size) {
+  g_mutex_lock(&staging_lock);
+  GSList *best = NULL;
+  for (GSList *l = staging_free; l; l = l->next) {
+    StagingBlock *block = l->data;
+    if (block->capacity >= size &&
+        (!best || block->capacity < ((StagingBlock *)best->data)->capacity)) {
+      best = l;
+    }
+  }
+  StagingBlock *block = NULL;
+  if (best) {
+    block = best->data;
+    staging_free = g_slist_delete_link(staging_free, best);
+    staging_free_len--;
+  }
+  g_mutex_unlock(&staging_lock);
+  if (!block) {
+    gsize capacity = 64 * 1024;
+    while (capacity < size) {
+      capacity *= 2;
+    }
+    block = g_new0(StagingBlock, 1);
+    block->data = g_malloc(capacity);
+    block->capacity = capacity;
+  }
+  block->refs = 1;
+  return block;
+}
+
+// Drops one reference; the last one returns the block to the pool. Also
+// the ArrayBuffer destroy notify, so it may run on a GC thread.
+static void staging_unref(gpointer data) {
+  StagingBlock *block = data;
+  if (!g_atomic_int_dec_and_test(&block->refs)) {
+    return;
+  }
+  g_mutex_lock(&staging_lock);
+  if (staging_free_len < MEMIO_STAGING_POOL_MAX) {
+    staging_free = g_slist_prepend(staging_free, block);
+    staging_free_len++;
+    block = NULL;
+  }
+  g_mutex_unlock(&staging_lock);
+  if (block) {
+    g_free(block->data);
+    g_free(block);
+  }
+}
+
+// Makes sure `cache` has pooled storage for `total` bytes. Capacity at
+// least doubles when it must grow, so a buffer that keeps growing
+// reallocates O(log n) times and steady versions allocate nothing.
+static gboolean ensure_block(SharedCache *cache, const char *name, gsize total) {
+  gsize capacity = cache->block ? cache->block->capacity : 0;
+  if (capacity >= total) {
+    return TRUE;
+  }
+
+  StagingBlock *block = staging_acquire(MAX(total, capacity * 2));
+  if (cache->block) {
+    staging_unref(cache->block);
+  }
+  cache->block = block;
+  cache->generation++;
+  g_message("memio-webkit-extension: __memioSharedBuffers[%s] capacity=%zu", name,
+            block->capacity);
+  return TRUE;
+}
+
+static gboolean finish_copy(gpointer data);
+
+// Worker thread: copies one version out of the mapping into staging memory.
+static void copy_worker(gpointer data, gpointer user_data) {
+  CopyJob *job = data;
+  const guint8 *base = (const guint8 *)g_mapped_file_get_contents(job->file);
+
+  memcpy(job->block->data, job->header, MEMIO_HEADER_SIZE);
+  memcpy(job->block->data + MEMIO_HEADER_SIZE, base + job->payload_offset, (gsize)job->length);
+  // Order the payload loads before the re-check (seqlock read side)
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  job->torn = __atomic_load_n((const guint64 *)(base + job->check_offset), __ATOMIC_RELAXED) !=
+              job->check_value;
+
+  g_idle_add_full(G_PRIORITY_DEFAULT, finish_copy, job, NULL);
+}
+
+// Main loop: swaps a finished copy in as the cache's block. O(1) - each
+// context rewraps it on its next access.
+static gboolean finish_copy(gpointer data) {
+  CopyJob *job = data;
+  SharedCache *cache = job->cache;
+  cache->pending = FALSE;
+
+  gboolean current = !job->torn &&
+                     (job->version != cache->last_version || job->length != cache->last_length);
+  StagingBlock *spare = job->block;
+  if (current) {
+    spare = cache->block;
+    cache->block = job->block;
+    cache->generation++;
+    cache->last_version = job->version;
+    cache->last_length = job->length;
+    stat_copies++;
+    stat_bytes_copied += MEMIO_HEADER_SIZE + (gsize)job->length;
+  }
+  // Stale or torn copies leave the new block unused; the next refresh
+  // starts over
+  if (cache->spare) {
+    staging_unref(cache->spare);
+  }
+  cache->spare = spare;
+
+  g_mapped_file_unref(job->file);
+  g_free(job->name);
+  g_free(job);
+  return G_SOURCE_REMOVE;
+}
+
+// Queues a worker copy of [header][payload] for an already materialized
+// buffer. `check` points at the writer's seqlock counter in the mapping: it
+// was even (`check_value`) before the copy and must still be afterwards.
+// The copy goes into the cache's spare block, so each cache holds at most
+// two: the one JS reads and the one being filled. Returns FALSE, and the
+// caller copies inline, while JS still references the spare.
+static gboolean start_copy(SharedCache *cache,
+                           const char *name,
+                           GMappedFile *file,
+                           const guint8 *header,
+                           const guint8 *payload,
+                           const guint8 *check,
+                           guint64 check_value,
+                           guint64 version,
+                           guint64 length) {
+  if (!copy_pool) {
+    copy_pool = g_thread_pool_new(copy_worker, NULL, 2, FALSE, NULL);
+    if (!copy_pool) {
+      return FALSE;
+    }
+  }
+
+  gsize total = MEMIO_HEADER_SIZE + (gsize)length;
+  StagingBlock *block = cache->spare;
+  if (block && g_atomic_int_get(&block->refs) > 1) {
+    return FALSE;  // Old ArrayBuffers not collected yet
+  }
+  cache->spare = NULL;
+  if (block && block->capacity < total) {
+    staging_unref(block);
+    block = NULL;
+  }
+  if (!block) {
+    block = staging_acquire(total);
+  }
+
+  const guint8 *base = (const guint8 *)g_mapped_file_get_contents(file);
+  CopyJob *job = g_new0(CopyJob, 1);
+  job->cache = cache;
+  job->name = g_strdup(name);
+  job->file = g_mapped_file_ref(file);
+  memcpy(job->header, header, MEMIO_HEADER_SIZE);
+  job->payload_offset = (gsize)(payload - base);
+  job->check_offset = (gsize)(check - base);
+  job->check_value = check_value;
+  job->version = version;
+  job->length = length;
+  job->block = block;
+
+  cache->pending = TRUE;
+  g_thread_pool_push(copy_pool, job, NULL);
+  return TRUE;
+}
+
+// Copies [header][payload] into the block served as
+// __memioSharedBuffers[name] in every context.
+// The header is passed separately so heap objects can use a synthesized one.
+// Large new versions of a buffer JS already holds are copied on a worker
+// thread (see start_copy); JS keeps the previous version until the swap.
+// Returns FALSE when a writer tore the inline copy: the block's magic is
+// cleared so JS rejects it, and the next refresh copies again.
+static gboolean publish_buffer(SharedCache *cache,
+                               const char *name,
+                               GMappedFile *file,
+                               const guint8 *header,
+                               const guint8 *payload,
+                               const guint8 *check,
+                               guint64 check_value,
+                               guint64 version,
+                               guint64 length) {
+  gsize total = MEMIO_HEADER_SIZE + (gsize)length;
+
+  // Already materialized at this version: nothing to copy
+  if (cache->block && version == cache->last_version && length == cache->last_length) {
+    return TRUE;
+  }
+
+  if (cache->pending) {
+    return TRUE;  // Picked up once the in-flight copy lands
+  }
+  if (total >= MEMIO_ASYNC_COPY_MIN && cache->block &&
+      start_copy(cache, name, file, header, payload, check, check_value, version, length)) {
+    return TRUE;
+  }
+
+  if (!ensure_block(cache, name, total)) {
+    return FALSE;
+  }
+
+  // Refill the pooled storage in place; every context's view sees it
+  memcpy(cache->block->data, header, MEMIO_HEADER_SIZE);
+  memcpy(cache->block->data + MEMIO_HEADER_SIZE, payload, (gsize)length);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if (__atomic_load_n((const guint64 *)check, __ATOMIC_RELAXED) != check_value) {
+    guint64 no_magic = 0;
+    memcpy(cache->block->data + MEMIO_MAGIC_OFFSET, &no_magic, 8);
+    cache->last_version = 0;
+    return FALSE;
+  }
+  stat_copies++;
+  stat_bytes_copied += total;
+
+  // Views are cheap; only the length changes between versions
+  if (length != cache->last_length) {
+    cache->generation++;
+  }
+  cache->last_version = version;
+  cache->last_length = length;
+  return TRUE;
+}
+
+// Exposes every live object of a multi-object heap as its own buffer.
+// One mapping serves all objects; the heap generation lets us skip the
+// directory scan entirely when nothing was published since the last tick.
+// Objects are listed in the manifest right away but only copied once JS
+// has read them.
+static gboolean update_heap(SharedCache *heap) {
+  const guint8 *base = (const guint8 *)g_mapped_file_get_contents(heap->file);
+
+  guint64 generation = __atomic_load_n(
+      (const guint64 *)(base + MEMIO_HEAP_GENERATION_OFFSET), __ATOMIC_ACQUIRE);
+  if (generation == heap->last_version) {
+    return TRUE;
+  }
+
+  guint64 dir_offset = 0;
+  guint64 dir_slots = 0;
+  memcpy(&dir_offset, base + MEMIO_HEAP_DIR_OFFSET_OFFSET, 8);
+  memcpy(&dir_slots, base + MEMIO_HEAP_DIR_SLOTS_OFFSET, 8);
+  if (dir_offset + dir_slots * MEMIO_HEAP_ENTRY_SIZE > heap->file_len) {
+    return FALSE;
+  }
+
+  gboolean complete = TRUE;
+  for (guint64 slot = 0; slot < dir_slots; slot++) {
+    const guint8 *entry = base + dir_offset + slot * MEMIO_HEAP_ENTRY_SIZE;
+    guint32 state = __atomic_load_n((const guint32 *)(entry + MEMIO_HEAP_ENTRY_STATE_OFFSET),
+                                    __ATOMIC_ACQUIRE);
+    if (state != 2) {
+      continue;
+    }
+
+    guint32 name_len = 0;
+    memcpy(&name_len, entry + MEMIO_HEAP_ENTRY_NAME_LEN_OFFSET, 4);
+    if (name_len == 0 || name_len > MEMIO_HEAP_NAME_MAX) {
+      continue;
+    }
+    gchar *name = g_strndup((const gchar *)(entry + MEMIO_HEAP_ENTRY_NAME_OFFSET), name_len);
+
+    const guint64 *seq_ptr = (const guint64 *)(entry + MEMIO_HEAP_ENTRY_SEQ_OFFSET);
+    guint64 seq = __atomic_load_n(seq_ptr, __ATOMIC_ACQUIRE);
+    guint64 offset = 0;
+    guint64 length = 0;
+    guint64 version = 0;
+    memcpy(&offset, entry + MEMIO_HEAP_ENTRY_OFFSET_OFFSET, 8);
+    memcpy(&length, entry + MEMIO_HEAP_ENTRY_LENGTH_OFFSET, 8);
+    memcpy(&version, entry + MEMIO_HEAP_ENTRY_VERSION_OFFSET, 8);
+
+    SharedCache *object = get_cache(name);
+    object->heap = heap;
+    if ((seq & 1) || offset + length > heap->file_len) {
+      // Writer is mid-publish; pick it up on the next tick.
+      complete = FALSE;
+    } else if (length > 0) {
+      object->listed = TRUE;
+      object->manifest_length = length;
+      if (recently_accessed(object) &&
+          (version != object->last_version || length != object->last_length)) {
+        guint8 header[MEMIO_HEADER_SIZE] = {0};
+        guint64 magic = MEMIO_MAGIC;
+        memcpy(header + MEMIO_MAGIC_OFFSET, &magic, 8);
+        memcpy(header + MEMIO_VERSION_OFFSET, &version, 8);
+        memcpy(header + MEMIO_LENGTH_OFFSET, &length, 8);
+        if (!publish_buffer(object, name, heap->file, header, base + offset,
+                            (const guint8 *)seq_ptr, seq, version, length)) {
+          // Torn read: re-copied next tick.
+          complete = FALSE;
+        }
+      }
+    }
+    g_free(name);
+  }
+
+  if (complete) {
+    heap->last_version = generation;
+  }
+  return TRUE;
+}
+
+// Maps a registry buffer, records its manifest length and, when
+// `materialize` is set, copies it into the block served to JS.
+// Independent of any JS context: each version is copied at most once.
+static gboolean update_buffer(const char *name, const char *path, gboolean materialize) {
   SharedCache *cache = get_cache(name);
   if (!ensure_cache(cache, path)) {
     return FALSE;
@@ -126,6 +848,10 @@ static gboolean update_buffer(JSCContext *context, const char *name, const char
     return FALSE;
   }
 
+  // Seqlock: the header and payload are consistent only if this word is
+  // even now and unchanged once the copy is done (see publish_buffer)
+  const guint8 *seq_ptr = (const guint8 *)data + MEMIO_SEQ_OFFSET;
+  guint64 seq = __atomic_load_n((const guint64 *)seq_ptr, __ATOMIC_ACQUIRE);
   guint64 magic = 0;
   guint64 version = 0;
   guint64 length = 0;
@@ -133,95 +859,42 @@ static gboolean update_buffer(JSCContext *context, const char *name, const char
   memcpy(&version, (guint8 *)data + 8, 8);
   memcpy(&length, (guint8 *)data + 16, 8);
 
+  cache->is_heap = magic == MEMIO_HEAP_MAGIC && cache->file_len >= MEMIO_HEAP_HEADER_SIZE;
+  if (cache->is_heap) {
+    return update_heap(cache);
+  }
+
   // Allow empty buffers, but reject invalid magic values.
   if (magic != 0 && magic != MEMIO_MAGIC) {
     return FALSE;
   }
 
-  if (length > (guint64)(cache->file_len - MEMIO_HEADER_SIZE)) {
-    length = cache->file_len - MEMIO_HEADER_SIZE;
+  // Writer mid-update: its doorbell ring brings us back once it is done
+  if (seq & 1) {
+    return TRUE;
   }
 
-  // Ensure manifest exists and update buffer metadata
-  JSCValue *manifest = jsc_context_get_value(context, "__memioSharedManifest");
-  if (!manifest || !jsc_value_is_object(manifest)) {
-    JSCValue *init = jsc_context_evaluate(
-        context,
-        "globalThis.__memioSharedManifest = { version: 1, buffers: {} };",
-        -1);
-    if (init) {
-      g_object_unref(init);
-    }
-    manifest = jsc_context_get_value(context, "__memioSharedManifest");
-  }
-  if (manifest && jsc_value_is_object(manifest)) {
-    JSCValue *buffers = jsc_value_object_get_property(manifest, "buffers");
-    if (!buffers || !jsc_value_is_object(buffers)) {
-      if (buffers) {
-        g_object_unref(buffers);
-      }
-      buffers = jsc_context_evaluate(context, "({})", -1);
-      jsc_value_object_set_property(manifest, "buffers", buffers);
-    }
-    JSCValue *entry = jsc_context_evaluate(context, "({})", -1);
-    JSCValue *length_val = jsc_value_new_number(context, (double)length);
-    jsc_value_object_set_property(entry, "length", length_val);
-    jsc_value_object_set_property(buffers, name, entry);
-    if (length_val) g_object_unref(length_val);
-    if (entry) g_object_unref(entry);
-    if (buffers) g_object_unref(buffers);
+  if (length > (guint64)(cache->file_len - MEMIO_HEADER_SIZE)) {
+    length = cache->file_len - MEMIO_HEADER_SIZE;
   }
 
-  // Always ensure __memioSharedBuffers exists in the current context
-  JSCValue *shared = jsc_context_get_value(context, "__memioSharedBuffers");
-  gboolean need_create = !shared || !jsc_value_is_object(shared);
-  
-  if (need_create) {
-    JSCValue *result = jsc_context_evaluate(context, "globalThis.__memioSharedBuffers = {};", -1);
-    if (result) {
-      g_object_unref(result);
-    }
-    shared = jsc_context_get_value(context, "__memioSharedBuffers");
-  }
+  // Manifests of every context pick this up in sync_manifest()
+  cache->listed = TRUE;
+  cache->manifest_length = length;
 
   // Buffer not ready yet (empty) - don't fail, just skip for now
   if (magic == 0 || length == 0) {
     return TRUE;  // Return TRUE = file mapped ok, but no data yet (will retry)
   }
 
-  gsize total = MEMIO_HEADER_SIZE + (gsize)length;
-  if (total > cache->file_len) {
-    total = cache->file_len;
-  }
-
-  // Check if we already have this buffer in THIS context with same version
-  if (!need_create && version == cache->last_version && length == cache->last_length) {
-    JSCValue *existing = jsc_value_object_get_property(shared, name);
-    if (existing && jsc_value_is_typed_array(existing)) {
-      // Buffer exists and version matches, just update the data
-      gsize out_len = 0;
-      gpointer out = jsc_value_typed_array_get_data(existing, &out_len);
-      if (out && out_len >= total) {
-        memcpy(out, data, total);
-        return TRUE;
-      }
-    }
-  }
-
-  // Create new typed array and copy data
-  JSCValue *typed = jsc_value_new_typed_array(context, JSC_TYPED_ARRAY_UINT8, total);
-  gsize out_len = 0;
-  gpointer out = jsc_value_typed_array_get_data(typed, &out_len);
-  if (!out || out_len < total) {
-    if (typed) g_object_unref(typed);
-    return FALSE;
+  // Not read by JS lately: leave the copy to the next access
+  if (!materialize) {
+    return TRUE;
   }
 
-  memcpy(out, data, total);
-  jsc_value_object_set_property(shared, name, typed);
-  cache->last_version = version;
-  cache->last_length = length;
-  g_message("memio-webkit-extension: set __memioSharedBuffers[%s] len=%zu", name, total);
+  // A copy torn by a concurrent write is redone on the next tick
+  publish_buffer(cache, name, cache->file, (const guint8 *)data,
+                 (const guint8 *)data + MEMIO_HEADER_SIZE, seq_ptr, seq, version, length);
   return TRUE;
 }
 
@@ -251,39 +924,69 @@ static gboolean load_registry(JSCContext *context) {
       registry_path = g_strdup(path);
     }
 
-    gchar *contents = NULL;
-    gsize length = 0;
-    if (!g_file_get_contents(path, &contents, &length, NULL)) {
-      g_message("memio-webkit-extension: failed to read registry file %s", path);
-      g_free(owned);
-      return FALSE;
-    }
+    // Doorbell wake-ups can arrive at the write rate; only re-parse the
+    // registry when the file itself changed.
+    static struct timespec parsed_mtime;
+    static off_t parsed_size = -1;
+    struct stat st;
+    gboolean unchanged = registry_entries && stat(path, &st) == 0 &&
+                         st.st_size == parsed_size &&
+                         st.st_mtim.tv_sec == parsed_mtime.tv_sec &&
+                         st.st_mtim.tv_nsec == parsed_mtime.tv_nsec;
+
+    if (!unchanged) {
+      gchar *contents = NULL;
+      gsize length = 0;
+      if (!g_file_get_contents(path, &contents, &length, NULL)) {
+        g_message("memio-webkit-extension: failed to read registry file %s", path);
+        g_free(owned);
+        return FALSE;
+      }
+      if (stat(path, &st) == 0) {
+        parsed_mtime = st.st_mtim;
+        parsed_size = st.st_size;
+      }
 
-    gchar **lines = g_strsplit(contents, "\n", -1);
-    for (gchar **line = lines; line && *line; line++) {
-      gchar *trimmed = g_strstrip(*line);
-      if (trimmed[0] == '\0') {
-        continue;
+      if (!registry_entries) {
+        registry_entries = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
       }
-      gchar **parts = g_strsplit(trimmed, "=", 2);
-      if (parts[0] && parts[1]) {
-        gchar *name = g_strstrip(parts[0]);
-        gchar *buf_path = g_strstrip(parts[1]);
-        if (name[0] != '\0' && buf_path[0] != '\0') {
-          SharedCache *cache = get_cache(name);
-          if (!update_buffer(context, name, buf_path)) {
-            // Only log first failure for each buffer
-            if (!cache->failed) {
-              g_message("memio-webkit-extension: failed to map %s=%s", name, buf_path);
-              cache->failed = TRUE;
-            }
+      g_hash_table_remove_all(registry_entries);
+
+      gchar **lines = g_strsplit(contents, "\n", -1);
+      for (gchar **line = lines; line && *line; line++) {
+        gchar *trimmed = g_strstrip(*line);
+        if (trimmed[0] == '\0') {
+          continue;
+        }
+        gchar **parts = g_strsplit(trimmed, "=", 2);
+        if (parts[0] && parts[1]) {
+          gchar *name = g_strstrip(parts[0]);
+          gchar *buf_path = g_strstrip(parts[1]);
+          if (name[0] != '\0' && buf_path[0] != '\0') {
+            g_hash_table_replace(registry_entries, g_strdup(name), g_strdup(buf_path));
           }
         }
+        g_strfreev(parts);
+      }
+      g_strfreev(lines);
+      g_free(contents);
+    }
+
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+    g_hash_table_iter_init(&iter, registry_entries);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+      SharedCache *cache = get_cache(key);
+      if (!update_buffer(key, value, cache_is_active(cache))) {
+        // Only log first failure for each buffer
+        if (!cache->failed) {
+          g_message("memio-webkit-extension: failed to map %s=%s", (const char *)key,
+                    (const char *)value);
+          cache->failed = TRUE;
+        }
       }
-      g_strfreev(parts);
     }
-    g_strfreev(lines);
-    g_free(contents);
     g_free(owned);
     return TRUE;
   }
@@ -293,7 +996,11 @@ static gboolean load_registry(JSCContext *context) {
     if (val && jsc_value_is_string(val)) {
       gchar *direct_path = jsc_value_to_string(val);
       if (direct_path && direct_path[0] != '\0') {
-        if (!update_buffer(context, "state", direct_path)) {
+        if (!registry_entries) {
+          registry_entries = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+        }
+        g_hash_table_replace(registry_entries, g_strdup("state"), g_strdup(direct_path));
+        if (!update_buffer("state", direct_path, cache_is_active(get_cache("state")))) {
           g_message("memio-webkit-extension: failed to map direct state path %s", direct_path);
         }
       }
@@ -307,67 +1014,27 @@ static gboolean load_registry(JSCContext *context) {
   return FALSE;
 }
 
-static gboolean install_memio_bindings(gpointer user_data) {
-  WebKitWebPage *page = WEBKIT_WEB_PAGE(user_data);
-  WebKitFrame *frame = webkit_web_page_get_main_frame(page);
-  if (!frame) {
-    return G_SOURCE_REMOVE;
+// Wakes every process sleeping on the doorbell, including our own waiter.
+static void doorbell_ring(void) {
+  if (!doorbell_sequence) {
+    return;
   }
+  __atomic_add_fetch(doorbell_sequence, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(doorbell_waiters, __ATOMIC_SEQ_CST) > 0) {
+    syscall(SYS_futex, doorbell_sequence, FUTEX_WAKE, G_MAXINT, NULL, NULL, 0);
+  }
+}
 
-  JSCContext *context = webkit_frame_get_js_context_for_script_world(
-      frame, webkit_script_world_get_default());
-  if (!context) {
-    return G_SOURCE_REMOVE;
+// JavaScript callback: memioWriteSharedBuffer(name, uint8Array)
+// Writes data from JavaScript directly to the memio region (no caching)
+static JSCValue *js_write_shared_buffer(GPtrArray *args) {
+  if (args->len < 2) {
+    g_warning("memioWriteSharedBuffer requires 2 arguments: name and data");
+    return jsc_value_new_boolean(jsc_context_get_current(), FALSE);
   }
 
-  load_registry(context);
-
-  // Inject core helpers (with guards to prevent re-injection)
-  gchar *js1 = g_strdup_printf("if (!globalThis.memioSharedBuffer) { %s }", JS_MEMIO_SHARED_BUFFER);
-  JSCValue *r1 = jsc_context_evaluate(context, js1, -1);
-  g_free(js1);
-  if (r1) g_object_unref(r1);
-  
-  gchar *js2 = g_strdup_printf("if (!globalThis.memioListBuffers) { %s }", JS_MEMIO_LIST_BUFFERS);
-  JSCValue *r2 = jsc_context_evaluate(context, js2, -1);
-  g_free(js2);
-  if (r2) g_object_unref(r2);
-  
-  JSCValue *r3 = jsc_context_evaluate(context, JS_MEMIO_SHARED_DEBUG, -1);
-  if (r3) g_object_unref(r3);
-
-  g_message("memio-webkit-extension injected memioSharedBuffer");
-  return G_SOURCE_REMOVE;
-}
-
-static gboolean refresh_shared_buffers(gpointer user_data) {
-  WebKitWebPage *page = WEBKIT_WEB_PAGE(user_data);
-  WebKitFrame *frame = webkit_web_page_get_main_frame(page);
-  if (!frame) {
-    return G_SOURCE_CONTINUE;
-  }
-
-  JSCContext *context = webkit_frame_get_js_context_for_script_world(
-      frame, webkit_script_world_get_default());
-  if (!context) {
-    return G_SOURCE_CONTINUE;
-  }
-
-  load_registry(context);
-
-  return G_SOURCE_CONTINUE;
-}
-
-// JavaScript callback: memioWriteSharedBuffer(name, uint8Array)
-// Writes data from JavaScript directly to the memio region (no caching)
-static JSCValue *js_write_shared_buffer(GPtrArray *args) {
-  if (args->len < 2) {
-    g_warning("memioWriteSharedBuffer requires 2 arguments: name and data");
-    return jsc_value_new_boolean(jsc_context_get_current(), FALSE);
-  }
-
-  JSCValue *name_val = g_ptr_array_index(args, 0);
-  JSCValue *data_val = g_ptr_array_index(args, 1);
+  JSCValue *name_val = g_ptr_array_index(args, 0);
+  JSCValue *data_val = g_ptr_array_index(args, 1);
 
   if (!jsc_value_is_string(name_val)) {
     g_warning("memioWriteSharedBuffer: first argument must be a string");
@@ -463,9 +1130,17 @@ static JSCValue *js_write_shared_buffer(GPtrArray *args) {
     return jsc_value_new_boolean(jsc_context_get_current(), FALSE);
   }
 
-  // Verify we have enough space
-  if (file_len < MEMIO_HEADER_SIZE + data_len) {
-    g_warning("memioWriteSharedBuffer: buffer too small (%zu) for data (%zu)", file_len, data_len);
+  // Verify we have enough space (payload ends where the history area starts)
+  gsize payload_end = file_len;
+  if (file_len >= MEMIO_HEADER_SIZE) {
+    guint64 history_offset = 0;
+    memcpy(&history_offset, file_data + MEMIO_HISTORY_OFFSET, 8);
+    if (history_offset >= MEMIO_HEADER_SIZE && history_offset < file_len) {
+      payload_end = (gsize)history_offset;
+    }
+  }
+  if (payload_end < MEMIO_HEADER_SIZE + data_len) {
+    g_warning("memioWriteSharedBuffer: buffer too small (%zu) for data (%zu)", payload_end, data_len);
     munmap(file_data, file_len);
     close(fd);
     g_free(buffer_path);
@@ -477,6 +1152,12 @@ static JSCValue *js_write_shared_buffer(GPtrArray *args) {
   guint64 current_version = 0;
   memcpy(&current_version, file_data + MEMIO_VERSION_OFFSET, 8);
 
+  // Seqlock: odd while the payload and header are being rewritten
+  guint64 *seq = (guint64 *)(file_data + MEMIO_SEQ_OFFSET);
+  guint64 seq_odd = __atomic_load_n(seq, __ATOMIC_RELAXED) | 1;
+  __atomic_store_n(seq, seq_odd, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
   // Write data AFTER header
   memcpy(file_data + MEMIO_HEADER_SIZE, data, data_len);
 
@@ -485,8 +1166,10 @@ static JSCValue *js_write_shared_buffer(GPtrArray *args) {
   guint64 new_length = data_len;
   memcpy(file_data + MEMIO_VERSION_OFFSET, &new_version, 8);
   memcpy(file_data + MEMIO_LENGTH_OFFSET, &new_length, 8);
+  __atomic_store_n(seq, seq_odd + 1, __ATOMIC_RELEASE);
 
   g_message("memioWriteSharedBuffer: wrote %zu bytes to '%s' (version %lu)", data_len, name, new_version);
+  doorbell_ring();
 
   munmap(file_data, file_len);
   close(fd);
@@ -496,6 +1179,801 @@ static JSCValue *js_write_shared_buffer(GPtrArray *args) {
   return jsc_value_new_boolean(jsc_context_get_current(), TRUE);
 }
 
+// Current payload of a buffer or heap object, straight from the mapping.
+typedef struct {
+  const guint8 *payload;
+  const guint64 *check;  // Writer seqlock counter (buffer header or heap entry)
+  guint64 check_value;   // Odd while the writer is mid-publish: retry later
+  guint64 version;
+  guint64 length;
+} SourceView;
+
+// Finds `name` in a heap directory. While the writer is mid-publish only
+// `check`/`check_value` (odd) are filled in.
+static gboolean resolve_heap_object(SharedCache *heap, const char *name, SourceView *out) {
+  const guint8 *base = (const guint8 *)g_mapped_file_get_contents(heap->file);
+  guint64 dir_offset = 0;
+  guint64 dir_slots = 0;
+  memcpy(&dir_offset, base + MEMIO_HEAP_DIR_OFFSET_OFFSET, 8);
+  memcpy(&dir_slots, base + MEMIO_HEAP_DIR_SLOTS_OFFSET, 8);
+  if (dir_offset + dir_slots * MEMIO_HEAP_ENTRY_SIZE > heap->file_len) {
+    return FALSE;
+  }
+
+  gsize name_len = strlen(name);
+  for (guint64 slot = 0; slot < dir_slots; slot++) {
+    const guint8 *entry = base + dir_offset + slot * MEMIO_HEAP_ENTRY_SIZE;
+    guint32 state = __atomic_load_n((const guint32 *)(entry + MEMIO_HEAP_ENTRY_STATE_OFFSET),
+                                    __ATOMIC_ACQUIRE);
+    guint32 entry_name_len = 0;
+    memcpy(&entry_name_len, entry + MEMIO_HEAP_ENTRY_NAME_LEN_OFFSET, 4);
+    if (state != 2 || entry_name_len != name_len ||
+        memcmp(entry + MEMIO_HEAP_ENTRY_NAME_OFFSET, name, name_len) != 0) {
+      continue;
+    }
+
+    const guint64 *seq_ptr = (const guint64 *)(entry + MEMIO_HEAP_ENTRY_SEQ_OFFSET);
+    guint64 seq = __atomic_load_n(seq_ptr, __ATOMIC_ACQUIRE);
+    out->check = seq_ptr;
+    out->check_value = seq;
+    if (seq & 1) {
+      return TRUE;
+    }
+    guint64 offset = 0;
+    memcpy(&offset, entry + MEMIO_HEAP_ENTRY_OFFSET_OFFSET, 8);
+    memcpy(&out->length, entry + MEMIO_HEAP_ENTRY_LENGTH_OFFSET, 8);
+    memcpy(&out->version, entry + MEMIO_HEAP_ENTRY_VERSION_OFFSET, 8);
+    if (offset + out->length > heap->file_len) {
+      return FALSE;
+    }
+    out->payload = base + offset;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+// Resolves a registry buffer or a heap object by name, mapping it if needed.
+static gboolean resolve_source(const char *name, SourceView *out) {
+  SharedCache *cache = shared_cache_map ? g_hash_table_lookup(shared_cache_map, name) : NULL;
+  if (cache && cache->heap) {
+    return cache->heap->file && resolve_heap_object(cache->heap, name, out);
+  }
+
+  const char *path = registry_entries ? g_hash_table_lookup(registry_entries, name) : NULL;
+  if (!path) {
+    return FALSE;
+  }
+  cache = get_cache(name);
+  if (!ensure_cache(cache, path) || cache->file_len < MEMIO_HEADER_SIZE) {
+    return FALSE;
+  }
+
+  const guint8 *data = (const guint8 *)g_mapped_file_get_contents(cache->file);
+  out->check = (const guint64 *)(data + MEMIO_SEQ_OFFSET);
+  out->check_value = __atomic_load_n(out->check, __ATOMIC_ACQUIRE);
+  guint64 magic = 0;
+  memcpy(&magic, data + MEMIO_MAGIC_OFFSET, 8);
+  if (magic != MEMIO_MAGIC) {
+    return FALSE;
+  }
+  if (out->check_value & 1) {
+    return TRUE;
+  }
+  memcpy(&out->version, data + MEMIO_VERSION_OFFSET, 8);
+  memcpy(&out->length, data + MEMIO_LENGTH_OFFSET, 8);
+  if (out->length > (guint64)(cache->file_len - MEMIO_HEADER_SIZE)) {
+    out->length = cache->file_len - MEMIO_HEADER_SIZE;
+  }
+  out->payload = data + MEMIO_HEADER_SIZE;
+  return TRUE;
+}
+
+static JSCValue *read_into_result(JSCContext *context, guint64 version, guint64 length,
+                                  gsize copied) {
+  JSCValue *result = jsc_value_new_object(context, NULL, NULL);
+  set_number(result, "version", (double)version);
+  set_number(result, "length", (double)length);
+  set_number(result, "copied", (double)copied);
+  return result;
+}
+
+// JavaScript callback:
+//   memioReadInto(name, target, offset, srcOffset?, srcLength?, lastVersion?)
+// Copies payload bytes [srcOffset, srcOffset + srcLength) straight from the
+// mapping into `target` (a typed array or ArrayBuffer, e.g. wasm memory) at
+// byte `offset`. No intermediate JS copy is made.
+// Returns { version, length, copied }; copied is 0 when the version is not
+// newer than lastVersion. Returns null on bad arguments or unknown buffers,
+// and when every attempt raced a writer: the bytes of a torn copy are then
+// zeroed so `target` never holds a mix of two versions.
+static JSCValue *js_read_into(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  if (args->len < 2) {
+    g_warning("memioReadInto requires at least 2 arguments: name and target");
+    return jsc_value_new_null(context);
+  }
+
+  JSCValue *name_val = g_ptr_array_index(args, 0);
+  JSCValue *target_val = g_ptr_array_index(args, 1);
+  double offset_arg = args->len > 2 ? jsc_value_to_double(g_ptr_array_index(args, 2)) : 0;
+  JSCValue *src_offset_val = args->len > 3 ? g_ptr_array_index(args, 3) : NULL;
+  JSCValue *src_length_val = args->len > 4 ? g_ptr_array_index(args, 4) : NULL;
+  JSCValue *last_version_val = args->len > 5 ? g_ptr_array_index(args, 5) : NULL;
+
+  guint8 *target = NULL;
+  gsize target_len = 0;
+  if (jsc_value_is_typed_array(target_val)) {
+    target = jsc_value_typed_array_get_data(target_val, NULL);
+    target_len = jsc_value_typed_array_get_size(target_val);
+  } else if (jsc_value_is_array_buffer(target_val)) {
+    target = jsc_value_array_buffer_get_data(target_val, &target_len);
+  }
+  if (!jsc_value_is_string(name_val) || !target || !(offset_arg >= 0) ||
+      offset_arg > (double)target_len) {
+    g_warning("memioReadInto: expected (name, typed array or ArrayBuffer, offset in range)");
+    return jsc_value_new_null(context);
+  }
+  gsize offset = (gsize)offset_arg;
+
+  double src_offset_arg = src_offset_val && jsc_value_is_number(src_offset_val)
+                              ? jsc_value_to_double(src_offset_val)
+                              : 0;
+  double src_length_arg = src_length_val && jsc_value_is_number(src_length_val)
+                              ? jsc_value_to_double(src_length_val)
+                              : -1;
+  gboolean has_last = last_version_val && jsc_value_is_number(last_version_val);
+  double last_version = has_last ? jsc_value_to_double(last_version_val) : 0;
+  if (!(src_offset_arg >= 0)) {
+    return jsc_value_new_null(context);
+  }
+
+  char *name = jsc_value_to_string(name_val);
+  SourceView src = {0};
+  JSCValue *result = NULL;
+  gsize torn = 0;
+  // A writer may publish mid-copy (seqlock odd or moved); retry a few times
+  // before giving up.
+  for (int attempt = 0; attempt < MEMIO_READ_INTO_ATTEMPTS && !result; attempt++) {
+    if (attempt > 0) {
+      g_thread_yield();
+    }
+    if (!resolve_source(name, &src)) {
+      break;
+    }
+    if (src.check_value & 1) {
+      continue;
+    }
+    if (has_last && (double)src.version <= last_version) {
+      result = read_into_result(context, src.version, src.length, 0);
+      break;
+    }
+
+    gsize src_offset = (gsize)MIN(src_offset_arg, (double)src.length);
+    gsize n = (gsize)src.length - src_offset;
+    if (src_length_arg >= 0 && src_length_arg < (double)n) {
+      n = (gsize)src_length_arg;
+    }
+    n = MIN(n, target_len - offset);
+    memcpy(target + offset, src.payload + src_offset, n);
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    torn = n;
+    if (__atomic_load_n(src.check, __ATOMIC_RELAXED) == src.check_value) {
+      torn = 0;
+      result = read_into_result(context, src.version, src.length, n);
+      SharedCache *cache = g_hash_table_lookup(shared_cache_map, name);
+      if (cache) {
+        ack_version(cache, src.version);
+      }
+    }
+  }
+  g_free(name);
+  if (torn) {
+    memset(target + offset, 0, torn);
+  }
+
+  return result ? result : jsc_value_new_null(context);
+}
+
+// Shared rings (RPC transport). Single producer, single consumer: this
+// process writes request rings and reads response rings. Mappings are
+// cached per path until memioRingClose, or until the context that used
+// them goes away (page reload).
+typedef struct {
+  guint8 *base;
+  gsize size;
+  guint64 capacity;
+} RingMap;
+
+static GHashTable *ring_maps = NULL;
+
+static void ring_map_free(gpointer data) {
+  RingMap *ring = data;
+  munmap(ring->base, ring->size);
+  g_free(ring);
+}
+
+// Maps a ring created by the backend. Only memio ring files in /dev/shm
+// are accepted, so page script cannot map arbitrary files.
+static RingMap *ring_map(const char *path) {
+  if (!ring_maps) {
+    ring_maps = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, ring_map_free);
+  }
+  RingMap *ring = g_hash_table_lookup(ring_maps, path);
+  if (ring) {
+    return ring;
+  }
+  if (!g_str_has_prefix(path, "/dev/shm/memio_ring_") || strchr(path + 9, '/')) {
+    return NULL;
+  }
+
+  int fd = open(path, O_RDWR);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= MEMIO_RING_HEADER_SIZE) {
+    close(fd);
+    return NULL;
+  }
+  guint8 *base = mmap(NULL, (gsize)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return NULL;
+  }
+
+  guint64 magic = 0;
+  guint64 capacity = 0;
+  memcpy(&magic, base, 8);
+  memcpy(&capacity, base + MEMIO_RING_CAPACITY_OFFSET, 8);
+  if (magic != MEMIO_RING_MAGIC || capacity != (guint64)st.st_size - MEMIO_RING_HEADER_SIZE) {
+    munmap(base, (gsize)st.st_size);
+    return NULL;
+  }
+
+  ring = g_new0(RingMap, 1);
+  ring->base = base;
+  ring->size = (gsize)st.st_size;
+  ring->capacity = capacity;
+  g_hash_table_insert(ring_maps, g_strdup(path), ring);
+  return ring;
+}
+
+static guint64 *ring_word(RingMap *ring, gsize offset) {
+  return (guint64 *)(ring->base + offset);
+}
+
+// Copies between the ring data area at stream position `pos` and `bytes`,
+// wrapping at the end.
+static void ring_copy(RingMap *ring, guint64 pos, guint8 *bytes, gsize len, gboolean into_ring) {
+  guint8 *data = ring->base + MEMIO_RING_HEADER_SIZE;
+  gsize at = (gsize)(pos % ring->capacity);
+  gsize first = MIN(len, (gsize)ring->capacity - at);
+  if (into_ring) {
+    memcpy(data + at, bytes, first);
+    memcpy(data, bytes + first, len - first);
+  } else {
+    memcpy(bytes, data + at, first);
+    memcpy(bytes + first, data, len - first);
+  }
+}
+
+// Unmaps the rings a context used; destroy notify of its "memio-rings" set.
+static void context_rings_free(gpointer data) {
+  GHashTable *paths = data;
+  GHashTableIter iter;
+  gpointer path;
+  g_hash_table_iter_init(&iter, paths);
+  while (ring_maps && g_hash_table_iter_next(&iter, &path, NULL)) {
+    g_hash_table_remove(ring_maps, path);
+  }
+  g_hash_table_destroy(paths);
+}
+
+// Remembers that `context` uses the ring at `path`.
+static void context_track_ring(JSCContext *context, const char *path) {
+  GHashTable *paths = g_object_get_data(G_OBJECT(context), "memio-rings");
+  if (!paths) {
+    paths = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    g_object_set_data_full(G_OBJECT(context), "memio-rings", paths, context_rings_free);
+  }
+  if (!g_hash_table_contains(paths, path)) {
+    g_hash_table_add(paths, g_strdup(path));
+  }
+}
+
+static gboolean ring_resolve(GPtrArray *args, const char *fn, RingMap **ring, guint8 **bytes,
+                             gsize *len) {
+  if (args->len < 2 || !jsc_value_is_string(g_ptr_array_index(args, 0))) {
+    g_warning("%s: expected (ringPath, typed array or ArrayBuffer)", fn);
+    return FALSE;
+  }
+  JSCValue *target = g_ptr_array_index(args, 1);
+  if (jsc_value_is_typed_array(target)) {
+    *bytes = jsc_value_typed_array_get_data(target, NULL);
+    *len = jsc_value_typed_array_get_size(target);
+  } else if (jsc_value_is_array_buffer(target)) {
+    *bytes = jsc_value_array_buffer_get_data(target, len);
+  } else {
+    g_warning("%s: expected (ringPath, typed array or ArrayBuffer)", fn);
+    return FALSE;
+  }
+
+  char *path = jsc_value_to_string(g_ptr_array_index(args, 0));
+  *ring = ring_map(path);
+  if (*ring) {
+    context_track_ring(jsc_context_get_current(), path);
+  } else {
+    g_warning("%s: cannot map ring %s", fn, path);
+  }
+  g_free(path);
+  return *ring != NULL;
+}
+
+// JavaScript callback: memioRingClose(ringPath) -> boolean
+// Unmaps a ring once its channel is closed; false if it was not mapped.
+static JSCValue *js_ring_close(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  if (args->len < 1 || !jsc_value_is_string(g_ptr_array_index(args, 0))) {
+    g_warning("memioRingClose: expected (ringPath)");
+    return jsc_value_new_boolean(context, FALSE);
+  }
+  char *path = jsc_value_to_string(g_ptr_array_index(args, 0));
+  GHashTable *paths = g_object_get_data(G_OBJECT(context), "memio-rings");
+  if (paths) {
+    g_hash_table_remove(paths, path);
+  }
+  gboolean removed = ring_maps && g_hash_table_remove(ring_maps, path);
+  g_free(path);
+  return jsc_value_new_boolean(context, removed);
+}
+
+// JavaScript callback: memioRingWrite(ringPath, bytes) -> boolean
+// Appends `bytes` (a batch of whole RPC frames) to a request ring, all or
+// nothing, then rings the doorbell so the backend wakes up.
+static JSCValue *js_ring_write(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  RingMap *ring = NULL;
+  guint8 *bytes = NULL;
+  gsize len = 0;
+  if (!ring_resolve(args, "memioRingWrite", &ring, &bytes, &len)) {
+    return jsc_value_new_boolean(context, FALSE);
+  }
+
+  guint64 head = __atomic_load_n(ring_word(ring, MEMIO_RING_HEAD_OFFSET), __ATOMIC_ACQUIRE);
+  guint64 tail = __atomic_load_n(ring_word(ring, MEMIO_RING_TAIL_OFFSET), __ATOMIC_ACQUIRE);
+  if (len > ring->capacity - (head - tail)) {
+    return jsc_value_new_boolean(context, FALSE);
+  }
+  if (len > 0) {
+    ring_copy(ring, head, bytes, len, TRUE);
+    __atomic_store_n(ring_word(ring, MEMIO_RING_HEAD_OFFSET), head + len, __ATOMIC_RELEASE);
+    doorbell_ring();
+  }
+  return jsc_value_new_boolean(context, TRUE);
+}
+
+// JavaScript callback: memioRingRead(ringPath, target) -> number
+// Moves as many whole RPC frames as fit from a response ring into
+// `target` and returns the byte count (0 when none are waiting).
+static JSCValue *js_ring_read(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  RingMap *ring = NULL;
+  guint8 *bytes = NULL;
+  gsize len = 0;
+  if (!ring_resolve(args, "memioRingRead", &ring, &bytes, &len)) {
+    return jsc_value_new_number(context, -1);
+  }
+
+  guint64 head = __atomic_load_n(ring_word(ring, MEMIO_RING_HEAD_OFFSET), __ATOMIC_ACQUIRE);
+  guint64 tail = __atomic_load_n(ring_word(ring, MEMIO_RING_TAIL_OFFSET), __ATOMIC_ACQUIRE);
+  guint64 available = head - tail;
+  gsize taken = 0;
+  while (taken + MEMIO_RPC_FRAME_HEADER_SIZE <= available) {
+    guint32 payload = 0;
+    ring_copy(ring, tail + taken + MEMIO_RPC_FRAME_LENGTH_OFFSET, (guint8 *)&payload, 4, FALSE);
+    gsize frame = MEMIO_RPC_FRAME_HEADER_SIZE + (gsize)payload;
+    if (taken + frame > available || taken + frame > len) {
+      break;
+    }
+    taken += frame;
+  }
+  if (taken > 0) {
+    ring_copy(ring, tail, bytes, taken, FALSE);
+    __atomic_store_n(ring_word(ring, MEMIO_RING_TAIL_OFFSET), tail + taken, __ATOMIC_RELEASE);
+  }
+  return jsc_value_new_number(context, (double)taken);
+}
+
+// Broadcast rings (one writer, many readers). Each attach claims a reader
+// slot in the ring's table; the slot's cursor and heartbeat are advanced on
+// every read. Slots this process claimed are remembered so page script can
+// only read and release its own.
+typedef struct {
+  guint8 *base;
+  gsize size;
+  guint64 capacity;
+  guint64 slots;
+  guint64 data_offset;
+  guint64 *owners;  // Token per slot claimed here, 0 otherwise
+} BroadcastMap;
+
+static GHashTable *broadcast_maps = NULL;
+static guint64 broadcast_tokens = 0;
+
+static void broadcast_map_free(gpointer data) {
+  BroadcastMap *ring = data;
+  munmap(ring->base, ring->size);
+  g_free(ring->owners);
+  g_free(ring);
+}
+
+// Maps a broadcast ring created by the backend (memio_bcast_* in /dev/shm).
+static BroadcastMap *broadcast_map(const char *path) {
+  if (!broadcast_maps) {
+    broadcast_maps =
+        g_hash_table_new_full(g_str_hash, g_str_equal, g_free, broadcast_map_free);
+  }
+  BroadcastMap *ring = g_hash_table_lookup(broadcast_maps, path);
+  if (ring) {
+    return ring;
+  }
+  if (!g_str_has_prefix(path, "/dev/shm/memio_bcast_") || strchr(path + 9, '/')) {
+    return NULL;
+  }
+
+  int fd = open(path, O_RDWR);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= MEMIO_BCAST_HEADER_SIZE) {
+    close(fd);
+    return NULL;
+  }
+  guint8 *base = mmap(NULL, (gsize)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return NULL;
+  }
+
+  guint64 magic = 0, capacity = 0, slots = 0, data_offset = 0;
+  memcpy(&magic, base, 8);
+  memcpy(&capacity, base + MEMIO_BCAST_CAPACITY_OFFSET, 8);
+  memcpy(&slots, base + MEMIO_BCAST_SLOTS_OFFSET, 8);
+  memcpy(&data_offset, base + MEMIO_BCAST_DATA_OFFSET, 8);
+  if (magic != MEMIO_BCAST_MAGIC || slots == 0 || slots > 4096 ||
+      data_offset != MEMIO_BCAST_HEADER_SIZE + slots * MEMIO_BCAST_SLOT_SIZE ||
+      data_offset + capacity != (guint64)st.st_size) {
+    munmap(base, (gsize)st.st_size);
+    return NULL;
+  }
+
+  ring = g_new0(BroadcastMap, 1);
+  ring->base = base;
+  ring->size = (gsize)st.st_size;
+  ring->capacity = capacity;
+  ring->slots = slots;
+  ring->data_offset = data_offset;
+  ring->owners = g_new0(guint64, slots);
+  g_hash_table_insert(broadcast_maps, g_strdup(path), ring);
+  return ring;
+}
+
+static guint64 *broadcast_slot_word(BroadcastMap *ring, guint64 slot, gsize field) {
+  return (guint64 *)(ring->base + MEMIO_BCAST_HEADER_SIZE + slot * MEMIO_BCAST_SLOT_SIZE + field);
+}
+
+static void broadcast_copy_out(BroadcastMap *ring, guint64 pos, guint8 *bytes, gsize len) {
+  guint8 *data = ring->base + ring->data_offset;
+  gsize at = (gsize)(pos % ring->capacity);
+  gsize first = MIN(len, (gsize)ring->capacity - at);
+  memcpy(bytes, data + at, first);
+  memcpy(bytes + first, data, len - first);
+}
+
+static guint64 monotonic_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  // Never zero: a zero heartbeat marks a slot being released
+  return MAX((guint64)ts.tv_sec * 1000 + (guint64)ts.tv_nsec / 1000000, 1);
+}
+
+// Resolves (ringPath, slot) to a slot this process still owns.
+static BroadcastMap *broadcast_resolve(GPtrArray *args, const char *fn, guint64 *slot) {
+  if (args->len < 2 || !jsc_value_is_string(g_ptr_array_index(args, 0)) ||
+      !jsc_value_is_number(g_ptr_array_index(args, 1))) {
+    g_warning("%s: expected (ringPath, slot, ...)", fn);
+    return NULL;
+  }
+  char *path = jsc_value_to_string(g_ptr_array_index(args, 0));
+  BroadcastMap *ring = broadcast_maps ? g_hash_table_lookup(broadcast_maps, path) : NULL;
+  g_free(path);
+  double index = jsc_value_to_double(g_ptr_array_index(args, 1));
+  if (!ring || !(index >= 0) || index >= (double)ring->slots || ring->owners[(gsize)index] == 0) {
+    return NULL;
+  }
+  *slot = (guint64)index;
+  guint64 owner =
+      __atomic_load_n(broadcast_slot_word(ring, *slot, MEMIO_BCAST_SLOT_OWNER_OFFSET),
+                      __ATOMIC_ACQUIRE);
+  if (owner != ring->owners[*slot]) {
+    ring->owners[*slot] = 0;  // Evicted by the writer
+    return NULL;
+  }
+  return ring;
+}
+
+// JavaScript callback: memioBroadcastAttach(ringPath) -> number
+// Claims a reader slot and returns its index (-1 if none is free). The
+// reader sees records published from now on and must read (or call again)
+// more often than the writer's eviction timeout.
+static JSCValue *js_broadcast_attach(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  if (args->len < 1 || !jsc_value_is_string(g_ptr_array_index(args, 0))) {
+    g_warning("memioBroadcastAttach: expected (ringPath)");
+    return jsc_value_new_number(context, -1);
+  }
+  char *path = jsc_value_to_string(g_ptr_array_index(args, 0));
+  BroadcastMap *ring = broadcast_map(path);
+  if (!ring) {
+    g_warning("memioBroadcastAttach: cannot map ring %s", path);
+  }
+  g_free(path);
+  if (!ring) {
+    return jsc_value_new_number(context, -1);
+  }
+
+  guint64 token = ((guint64)getpid() << 32) | ((++broadcast_tokens << 1) & 0xFFFFFFFFULL) | 1;
+  for (guint64 slot = 0; slot < ring->slots; slot++) {
+    guint64 expected = 0;
+    if (__atomic_compare_exchange_n(broadcast_slot_word(ring, slot, MEMIO_BCAST_SLOT_OWNER_OFFSET),
+                                    &expected, token, FALSE, __ATOMIC_ACQ_REL,
+                                    __ATOMIC_ACQUIRE)) {
+      // Heartbeat before cursor, as BroadcastReader::attach does
+      __atomic_store_n(broadcast_slot_word(ring, slot, MEMIO_BCAST_SLOT_HEARTBEAT_OFFSET),
+                       monotonic_ms(), __ATOMIC_RELEASE);
+      guint64 head = __atomic_load_n((guint64 *)(ring->base + MEMIO_BCAST_HEAD_OFFSET),
+                                     __ATOMIC_ACQUIRE);
+      __atomic_store_n(broadcast_slot_word(ring, slot, MEMIO_BCAST_SLOT_CURSOR_OFFSET), head,
+                       __ATOMIC_RELEASE);
+      ring->owners[slot] = token;
+      return jsc_value_new_number(context, (double)slot);
+    }
+  }
+  return jsc_value_new_number(context, -1);
+}
+
+// JavaScript callback: memioBroadcastRead(ringPath, slot, target) -> number
+// Copies as many whole records ([length u32][bytes]) as fit into `target`,
+// advances the slot's cursor past them and refreshes its heartbeat. Returns
+// the byte count, or -1 if the slot was evicted (attach again).
+static JSCValue *js_broadcast_read(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  guint64 slot = 0;
+  BroadcastMap *ring = broadcast_resolve(args, "memioBroadcastRead", &slot);
+  JSCValue *target = args->len > 2 ? g_ptr_array_index(args, 2) : NULL;
+  guint8 *bytes = NULL;
+  gsize len = 0;
+  if (target && jsc_value_is_typed_array(target)) {
+    bytes = jsc_value_typed_array_get_data(target, NULL);
+    len = jsc_value_typed_array_get_size(target);
+  } else if (target && jsc_value_is_array_buffer(target)) {
+    bytes = jsc_value_array_buffer_get_data(target, &len);
+  }
+  if (!ring || !bytes) {
+    return jsc_value_new_number(context, -1);
+  }
+
+  __atomic_store_n(broadcast_slot_word(ring, slot, MEMIO_BCAST_SLOT_HEARTBEAT_OFFSET),
+                   monotonic_ms(), __ATOMIC_RELEASE);
+  guint64 *cursor_word = broadcast_slot_word(ring, slot, MEMIO_BCAST_SLOT_CURSOR_OFFSET);
+  guint64 cursor = __atomic_load_n(cursor_word, __ATOMIC_ACQUIRE);
+  guint64 head =
+      __atomic_load_n((guint64 *)(ring->base + MEMIO_BCAST_HEAD_OFFSET), __ATOMIC_ACQUIRE);
+  guint64 available = head - cursor;
+  gsize taken = 0;
+  while (taken + MEMIO_BCAST_RECORD_HEADER_SIZE <= available) {
+    guint32 length = 0;
+    broadcast_copy_out(ring, cursor + taken, (guint8 *)&length, 4);
+    gsize record = MEMIO_BCAST_RECORD_HEADER_SIZE + (gsize)length;
+    if (taken + record > available || taken + record > len) {
+      break;
+    }
+    taken += record;
+  }
+  if (taken > 0) {
+    broadcast_copy_out(ring, cursor, bytes, taken);
+    // Still ours, so the writer did not reuse the space we copied from, and
+    // the cursor moves only if no new owner of the slot has reset it since
+    guint64 owner =
+        __atomic_load_n(broadcast_slot_word(ring, slot, MEMIO_BCAST_SLOT_OWNER_OFFSET),
+                        __ATOMIC_ACQUIRE);
+    if (owner != ring->owners[slot] ||
+        !__atomic_compare_exchange_n(cursor_word, &cursor, cursor + taken, FALSE,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      ring->owners[slot] = 0;  // Evicted by the writer
+      return jsc_value_new_number(context, -1);
+    }
+  }
+  return jsc_value_new_number(context, (double)taken);
+}
+
+// JavaScript callback: memioBroadcastDetach(ringPath, slot)
+// Releases a slot claimed with memioBroadcastAttach.
+static JSCValue *js_broadcast_detach(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  guint64 slot = 0;
+  BroadcastMap *ring = broadcast_resolve(args, "memioBroadcastDetach", &slot);
+  if (!ring) {
+    return jsc_value_new_boolean(context, FALSE);
+  }
+  // Heartbeat first so the writer ignores the slot while it is released
+  __atomic_store_n(broadcast_slot_word(ring, slot, MEMIO_BCAST_SLOT_HEARTBEAT_OFFSET), 0,
+                   __ATOMIC_RELEASE);
+  guint64 expected = ring->owners[slot];
+  __atomic_compare_exchange_n(broadcast_slot_word(ring, slot, MEMIO_BCAST_SLOT_OWNER_OFFSET),
+                              &expected, 0, FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+  ring->owners[slot] = 0;
+  return jsc_value_new_boolean(context, TRUE);
+}
+
+// Doorbell callbacks registered by page script, per context.
+typedef struct {
+  guint handle;
+  JSCValue *callback;
+} DoorbellCallback;
+
+static guint doorbell_handles = 0;
+
+static void doorbell_callback_free(gpointer data) {
+  DoorbellCallback *entry = data;
+  g_object_unref(entry->callback);
+  g_free(entry);
+}
+
+// JavaScript callback: memioOnDoorbell(callback) -> number
+// Calls `callback` on the main thread after every doorbell ring (new
+// buffer versions, RPC responses). Every registration gets its own handle
+// for memioOffDoorbell, so several clients in one context can listen.
+// Returns 0 if `callback` is not a function.
+static JSCValue *js_on_doorbell(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  JSCValue *callback = args->len > 0 ? g_ptr_array_index(args, 0) : NULL;
+  if (!callback || !jsc_value_is_function(callback)) {
+    g_warning("memioOnDoorbell: expected (callback)");
+    return jsc_value_new_number(context, 0);
+  }
+
+  GPtrArray *callbacks = g_object_get_data(G_OBJECT(context), "memio-doorbell");
+  if (!callbacks) {
+    callbacks = g_ptr_array_new_with_free_func(doorbell_callback_free);
+    g_object_set_data_full(G_OBJECT(context), "memio-doorbell", callbacks,
+                           (GDestroyNotify)g_ptr_array_unref);
+  }
+  DoorbellCallback *entry = g_new0(DoorbellCallback, 1);
+  entry->handle = ++doorbell_handles;
+  entry->callback = g_object_ref(callback);
+  g_ptr_array_add(callbacks, entry);
+  return jsc_value_new_number(context, (double)entry->handle);
+}
+
+// JavaScript callback: memioOffDoorbell(handle) -> boolean
+// Removes one registration made with memioOnDoorbell.
+static JSCValue *js_off_doorbell(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  JSCValue *arg = args->len > 0 ? g_ptr_array_index(args, 0) : NULL;
+  GPtrArray *callbacks = g_object_get_data(G_OBJECT(context), "memio-doorbell");
+  if (!arg || !jsc_value_is_number(arg) || !callbacks) {
+    return jsc_value_new_boolean(context, FALSE);
+  }
+  guint handle = (guint)jsc_value_to_double(arg);
+  for (guint i = 0; i < callbacks->len; i++) {
+    DoorbellCallback *entry = g_ptr_array_index(callbacks, i);
+    if (entry->handle == handle) {
+      g_ptr_array_remove_index(callbacks, i);
+      return jsc_value_new_boolean(context, TRUE);
+    }
+  }
+  return jsc_value_new_boolean(context, FALSE);
+}
+
+// JavaScript callback: __memioExtensionStats()
+static JSCValue *js_extension_stats(GPtrArray *args) {
+  JSCContext *context = jsc_context_get_current();
+  JSCValue *stats = jsc_value_new_object(context, NULL, NULL);
+  set_number(stats, "evaluations", (double)stat_evaluations);
+  set_number(stats, "copies", (double)stat_copies);
+  set_number(stats, "bytesCopied", (double)stat_bytes_copied);
+  return stats;
+}
+
+static void install_function(JSCContext *context, JSCValue *global, const char *name,
+                             GCallback callback) {
+  JSCValue *func = jsc_value_new_function_variadic(context, name, callback, NULL, NULL,
+                                                   JSC_TYPE_VALUE);
+  jsc_value_object_set_property(global, name, func);
+  g_object_unref(func);
+}
+
+static void context_binding_free(gpointer data) {
+  ContextBinding *binding = data;
+  // Manifest and view wrappers reference the context; drop them with it
+  g_object_set_data(G_OBJECT(binding->context), "memio-manifest", NULL);
+  g_object_set_data(G_OBJECT(binding->context), "memio-views", NULL);
+  g_object_set_data(G_OBJECT(binding->context), "memio-doorbell", NULL);
+  g_object_set_data(G_OBJECT(binding->context), "memio-rings", NULL);
+  g_object_unref(binding->context);
+  g_weak_ref_clear(&binding->frame);
+  g_free(binding);
+}
+
+// Serves `context` (frame `frame` in `world`) from now on: injects the
+// helpers and native functions and registers it for manifest refreshes.
+// Replaces any earlier context of the same frame and world.
+static void bind_context(WebKitScriptWorld *world, WebKitFrame *frame, JSCContext *context) {
+  if (!bindings) {
+    bindings = g_ptr_array_new_with_free_func(context_binding_free);
+  }
+  for (guint i = bindings->len; i > 0; i--) {
+    ContextBinding *binding = g_ptr_array_index(bindings, i - 1);
+    WebKitFrame *bound = g_weak_ref_get(&binding->frame);
+    gboolean replaced = binding->context == context || (bound == frame && binding->world == world);
+    if (bound) {
+      g_object_unref(bound);
+    }
+    if (replaced) {
+      g_ptr_array_remove_index_fast(bindings, i - 1);
+    }
+  }
+
+  ContextBinding *binding = g_new0(ContextBinding, 1);
+  g_weak_ref_init(&binding->frame, frame);
+  binding->world = world;
+  binding->context = g_object_ref(context);
+  g_ptr_array_add(bindings, binding);
+
+  load_registry(context);
+  ensure_shared_buffers(context);
+  sync_manifest(context);
+
+  // Inject core helpers (with guards to prevent re-injection)
+  gchar *js1 = g_strdup_printf("if (!globalThis.memioSharedBuffer) { %s }", JS_MEMIO_SHARED_BUFFER);
+  JSCValue *r1 = memio_evaluate(context, js1);
+  g_free(js1);
+  if (r1) g_object_unref(r1);
+
+  gchar *js2 = g_strdup_printf("if (!globalThis.memioListBuffers) { %s }", JS_MEMIO_LIST_BUFFERS);
+  JSCValue *r2 = memio_evaluate(context, js2);
+  g_free(js2);
+  if (r2) g_object_unref(r2);
+
+  JSCValue *r3 = memio_evaluate(context, JS_MEMIO_SHARED_DEBUG);
+  if (r3) g_object_unref(r3);
+
+  // Expose native functions to JavaScript
+  JSCValue *global = jsc_context_get_global_object(context);
+  install_function(context, global, "memioWriteSharedBuffer", G_CALLBACK(js_write_shared_buffer));
+  install_function(context, global, "memioReadInto", G_CALLBACK(js_read_into));
+  install_function(context, global, "memioRingWrite", G_CALLBACK(js_ring_write));
+  install_function(context, global, "memioRingRead", G_CALLBACK(js_ring_read));
+  install_function(context, global, "memioRingClose", G_CALLBACK(js_ring_close));
+  install_function(context, global, "memioOnDoorbell", G_CALLBACK(js_on_doorbell));
+  install_function(context, global, "memioOffDoorbell", G_CALLBACK(js_off_doorbell));
+  install_function(context, global, "memioBroadcastAttach", G_CALLBACK(js_broadcast_attach));
+  install_function(context, global, "memioBroadcastRead", G_CALLBACK(js_broadcast_read));
+  install_function(context, global, "memioBroadcastDetach", G_CALLBACK(js_broadcast_detach));
+  install_function(context, global, "__memioExtensionStats", G_CALLBACK(js_extension_stats));
+  g_object_unref(global);
+
+  const char *world_name = webkit_script_world_get_name(world);
+  g_message("memio-webkit-extension: bindings injected (%s frame, world %s, %u contexts)",
+            webkit_frame_is_main_frame(frame) ? "main" : "sub",
+            world_name ? world_name : "default", bindings->len);
+}
+
+// Fires for every frame (main and iframes) of every page in each world we
+// connected to.
 static void on_window_object_cleared(WebKitScriptWorld *world,
                                      WebKitWebPage *page,
                                      WebKitFrame *frame,
@@ -504,47 +1982,204 @@ static void on_window_object_cleared(WebKitScriptWorld *world,
   if (!context) {
     return;
   }
+  bind_context(world, frame, context);
+  g_object_unref(context);
+}
 
-  g_message("memio-webkit-extension: window object cleared, injecting bindings");
-  load_registry(context);
+static gboolean context_is_bound(JSCContext *context) {
+  for (guint i = 0; bindings && i < bindings->len; i++) {
+    if (((ContextBinding *)g_ptr_array_index(bindings, i))->context == context) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
 
-  // Inject core helpers
-  JSCValue *r1 = jsc_context_evaluate(context, JS_MEMIO_SHARED_BUFFER, -1);
-  if (r1) g_object_unref(r1);
-  
-  JSCValue *r2 = jsc_context_evaluate(context, JS_MEMIO_LIST_BUFFERS, -1);
-  if (r2) g_object_unref(r2);
-  
-  JSCValue *r3 = jsc_context_evaluate(context, JS_MEMIO_SHARED_DEBUG, -1);
-  if (r3) g_object_unref(r3);
+// Binds a main frame that was already loaded when the page was created.
+static gboolean install_memio_bindings(gpointer user_data) {
+  WebKitWebPage *page = WEBKIT_WEB_PAGE(user_data);
+  WebKitFrame *frame = webkit_web_page_get_main_frame(page);
+  if (!frame) {
+    return G_SOURCE_REMOVE;
+  }
 
-  // Expose write function to JavaScript
-  JSCValue *global = jsc_context_get_global_object(context);
-  JSCValue *write_func = jsc_value_new_function_variadic(context,
-                                                          "memioWriteSharedBuffer",
-                                                          G_CALLBACK(js_write_shared_buffer),
-                                                          NULL,
-                                                          NULL,
-                                                          JSC_TYPE_VALUE);
-  jsc_value_object_set_property(global, "memioWriteSharedBuffer", write_func);
-  g_object_unref(write_func);
-  g_object_unref(global);
+  for (guint i = 0; i < script_worlds->len; i++) {
+    WebKitScriptWorld *world = g_ptr_array_index(script_worlds, i);
+    JSCContext *context = webkit_frame_get_js_context_for_script_world(frame, world);
+    if (context && !context_is_bound(context)) {
+      bind_context(world, frame, context);
+    }
+    if (context) {
+      g_object_unref(context);
+    }
+  }
+  return G_SOURCE_REMOVE;
+}
+
+// One process-wide tick: re-reads the registry and copies active buffers
+// once, then brings every live context's manifest up to date. Contexts
+// rewrap changed buffers lazily on access, so N frames cost one copy.
+static gboolean refresh_shared_buffers(gpointer user_data) {
+  if (!bindings) {
+    return G_SOURCE_CONTINUE;
+  }
+
+  // Forget contexts whose frame went away. The registry path fallback is
+  // read from a main frame in the default world when there is one.
+  JSCContext *registry_context = NULL;
+  for (guint i = bindings->len; i > 0; i--) {
+    ContextBinding *binding = g_ptr_array_index(bindings, i - 1);
+    WebKitFrame *frame = g_weak_ref_get(&binding->frame);
+    if (!frame) {
+      g_ptr_array_remove_index_fast(bindings, i - 1);
+      continue;
+    }
+    if (!registry_context || (binding->world == webkit_script_world_get_default() &&
+                              webkit_frame_is_main_frame(frame))) {
+      registry_context = binding->context;
+    }
+    g_object_unref(frame);
+  }
+  if (!registry_context) {
+    return G_SOURCE_CONTINUE;
+  }
+
+  load_registry(registry_context);
+
+  for (guint i = 0; i < bindings->len; i++) {
+    ContextBinding *binding = g_ptr_array_index(bindings, i);
+    ensure_shared_buffers(binding->context);
+    sync_manifest(binding->context);
+  }
+  return G_SOURCE_CONTINUE;
+}
 
-  g_message("memio-webkit-extension: bindings injected via window-object-cleared");
+// Main loop side of a doorbell wake-up. Rings that arrive while this is
+// queued collapse into one refresh.
+static gboolean on_doorbell(gpointer user_data) {
+  g_atomic_int_set(&doorbell_pending, 0);
+  refresh_shared_buffers(NULL);
+
+  // Page callbacks registered with memioOnDoorbell (e.g. RPC clients). A
+  // callback may register or remove callbacks, so call a snapshot.
+  GPtrArray *calls = g_ptr_array_new_with_free_func(g_object_unref);
+  for (guint i = 0; bindings && i < bindings->len; i++) {
+    ContextBinding *binding = g_ptr_array_index(bindings, i);
+    GPtrArray *callbacks = g_object_get_data(G_OBJECT(binding->context), "memio-doorbell");
+    for (guint j = 0; callbacks && j < callbacks->len; j++) {
+      DoorbellCallback *entry = g_ptr_array_index(callbacks, j);
+      g_ptr_array_add(calls, g_object_ref(entry->callback));
+    }
+  }
+  for (guint i = 0; i < calls->len; i++) {
+    JSCValue *result = jsc_value_function_call(g_ptr_array_index(calls, i), G_TYPE_NONE);
+    if (result) g_object_unref(result);
+  }
+  g_ptr_array_unref(calls);
+  return G_SOURCE_REMOVE;
+}
+
+// Sleeps on the doorbell futex and schedules a refresh per change, so a
+// publish becomes visible without waiting for the next poll tick. Every
+// web process sleeps on the same word; the backend wakes all of them with
+// one FUTEX_WAKE.
+static gpointer doorbell_thread(gpointer data) {
+  guint32 seen = __atomic_load_n(doorbell_sequence, __ATOMIC_SEQ_CST);
+  for (;;) {
+    // Register before the kernel re-checks `seen` so a concurrent ring
+    // either sees us waiting or makes FUTEX_WAIT return immediately.
+    __atomic_add_fetch(doorbell_waiters, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(doorbell_sequence, __ATOMIC_SEQ_CST) == seen) {
+      struct timespec timeout = { .tv_sec = 1, .tv_nsec = 0 };
+      syscall(SYS_futex, doorbell_sequence, FUTEX_WAIT, seen, &timeout, NULL, 0);
+    }
+    __atomic_sub_fetch(doorbell_waiters, 1, __ATOMIC_SEQ_CST);
+
+    guint32 current = __atomic_load_n(doorbell_sequence, __ATOMIC_SEQ_CST);
+    if (current != seen) {
+      seen = current;
+      if (g_atomic_int_compare_and_exchange(&doorbell_pending, 0, 1)) {
+        g_idle_add_full(G_PRIORITY_HIGH_IDLE, on_doorbell, NULL, NULL);
+      }
+    }
+  }
+  return NULL;
+}
+
+// Maps the doorbell advertised by the backend and starts its waiter.
+// Returns FALSE if there is none; the extension then polls.
+static gboolean init_doorbell(void) {
+  const char *path = g_getenv("MEMIO_SHARED_DOORBELL");
+  if (!path || path[0] == '\0') {
+    return FALSE;
+  }
+
+  int fd = open(path, O_RDWR);
+  if (fd < 0) {
+    g_message("memio-webkit-extension: failed to open doorbell %s: %s", path, strerror(errno));
+    return FALSE;
+  }
+  guint8 *base = mmap(NULL, MEMIO_DOORBELL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return FALSE;
+  }
+
+  guint64 magic = 0;
+  memcpy(&magic, base, 8);
+  if (magic != MEMIO_DOORBELL_MAGIC) {
+    munmap(base, MEMIO_DOORBELL_SIZE);
+    return FALSE;
+  }
+
+  doorbell_sequence = (guint32 *)(base + MEMIO_DOORBELL_SEQUENCE_OFFSET);
+  doorbell_waiters = (guint32 *)(base + MEMIO_DOORBELL_WAITERS_OFFSET);
+  g_thread_unref(g_thread_new("memio-doorbell", doorbell_thread, NULL));
+  g_message("memio-webkit-extension: waiting on doorbell %s", path);
+  return TRUE;
+}
+
+// The default world plus any isolated worlds named in MEMIO_SCRIPT_WORLDS
+// (comma-separated), so user scripts running in those worlds see the same
+// buffers.
+static void init_script_worlds(void) {
+  script_worlds = g_ptr_array_new();
+  g_ptr_array_add(script_worlds, webkit_script_world_get_default());
+
+  const char *names = g_getenv("MEMIO_SCRIPT_WORLDS");
+  gchar **parts = g_strsplit(names ? names : "", ",", -1);
+  for (gchar **part = parts; part && *part; part++) {
+    gchar *name = g_strstrip(*part);
+    if (name[0] != '\0') {
+      g_ptr_array_add(script_worlds, webkit_script_world_new_with_name(name));
+      g_message("memio-webkit-extension: serving script world %s", name);
+    }
+  }
+  g_strfreev(parts);
+
+  for (guint i = 0; i < script_worlds->len; i++) {
+    g_signal_connect(g_ptr_array_index(script_worlds, i), "window-object-cleared",
+                     G_CALLBACK(on_window_object_cleared), NULL);
+  }
 }
 
 static void page_created(WebKitWebExtension *extension,
                          WebKitWebPage *page,
                          gpointer user_data) {
   g_message("memio-webkit-extension loaded (v3)");
-  
-  // Connect to window-object-cleared signal on the default script world
-  WebKitScriptWorld *world = webkit_script_world_get_default();
-  g_signal_connect(world, "window-object-cleared", G_CALLBACK(on_window_object_cleared), NULL);
-  
+
+  // window-object-cleared is per world, not per page: connect once
+  if (!script_worlds) {
+    init_script_worlds();
+  }
+
   // Also try immediate injection for pages already loaded
   g_idle_add_full(G_PRIORITY_DEFAULT, install_memio_bindings, g_object_ref(page), g_object_unref);
-  g_timeout_add_full(G_PRIORITY_DEFAULT, 100, refresh_shared_buffers, g_object_ref(page), g_object_unref);
+  if (!refresh_source) {
+    // With a doorbell the timer is only a safety net for missed wake-ups
+    guint interval = init_doorbell() ? MEMIO_DOORBELL_POLL_INTERVAL_MS : MEMIO_POLL_INTERVAL_MS;
+    refresh_source = g_timeout_add(interval, refresh_shared_buffers, NULL);
+  }
 }
 
 G_MODULE_EXPORT void webkit_web_extension_initialize(WebKitWebExtension *extension) {
@@ -11,6 +11,53 @@
 #define MEMIO_MAGIC_OFFSET 0
 #define MEMIO_VERSION_OFFSET 8
 #define MEMIO_LENGTH_OFFSET 16
+#define MEMIO_HISTORY_OFFSET 24
+#define MEMIO_ACK_OFFSET 32
+#define MEMIO_SEQ_OFFSET 40
+
+// Multi-object heap layout (shared/shared_heap_spec.json)
+#define MEMIO_HEAP_MAGIC 0x545552424F484550ULL
+#define MEMIO_HEAP_HEADER_SIZE 64
+#define MEMIO_HEAP_GENERATION_OFFSET 16
+#define MEMIO_HEAP_DIR_OFFSET_OFFSET 32
+#define MEMIO_HEAP_DIR_SLOTS_OFFSET 40
+#define MEMIO_HEAP_ENTRY_SIZE 128
+#define MEMIO_HEAP_ENTRY_STATE_OFFSET 0
+#define MEMIO_HEAP_ENTRY_NAME_LEN_OFFSET 4
+#define MEMIO_HEAP_ENTRY_OFFSET_OFFSET 8
+#define MEMIO_HEAP_ENTRY_LENGTH_OFFSET 16
+#define MEMIO_HEAP_ENTRY_VERSION_OFFSET 32
+#define MEMIO_HEAP_ENTRY_SEQ_OFFSET 40
+#define MEMIO_HEAP_ENTRY_NAME_OFFSET 64
+#define MEMIO_HEAP_NAME_MAX 64
+
+// Change-notification doorbell (shared/shared_doorbell_spec.json)
+#define MEMIO_DOORBELL_MAGIC 0x545552424F44424CULL
+#define MEMIO_DOORBELL_SIZE 64
+#define MEMIO_DOORBELL_SEQUENCE_OFFSET 8
+#define MEMIO_DOORBELL_WAITERS_OFFSET 12
+
+// Shared rings and RPC frames (shared/shared_rpc_spec.json)
+#define MEMIO_RING_MAGIC 0x545552424F52494EULL
+#define MEMIO_RING_HEADER_SIZE 64
+#define MEMIO_RING_CAPACITY_OFFSET 8
+#define MEMIO_RING_HEAD_OFFSET 16
+#define MEMIO_RING_TAIL_OFFSET 24
+#define MEMIO_RPC_FRAME_HEADER_SIZE 16
+#define MEMIO_RPC_FRAME_LENGTH_OFFSET 0
+
+// Multi-consumer broadcast rings (shared/shared_broadcast_spec.json)
+#define MEMIO_BCAST_MAGIC 0x545552424F424353ULL
+#define MEMIO_BCAST_HEADER_SIZE 64
+#define MEMIO_BCAST_CAPACITY_OFFSET 8
+#define MEMIO_BCAST_HEAD_OFFSET 16
+#define MEMIO_BCAST_SLOTS_OFFSET 32
+#define MEMIO_BCAST_DATA_OFFSET 40
+#define MEMIO_BCAST_SLOT_SIZE 32
+#define MEMIO_BCAST_SLOT_OWNER_OFFSET 0
+#define MEMIO_BCAST_SLOT_CURSOR_OFFSET 8
+#define MEMIO_BCAST_SLOT_HEARTBEAT_OFFSET 16
+#define MEMIO_BCAST_RECORD_HEADER_SIZE 4
 
 // Endianness: little
 // Multi-byte values are stored in little-endian format
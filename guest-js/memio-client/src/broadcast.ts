@@ -0,0 +1,167 @@
+/**
+ * MemioBroadcastReader - one consumer of a backend broadcast ring (Linux).
+ *
+ * The backend publishes an event stream once with
+ * `MemioManager::create_broadcast`; every webview (and a recorder) attaches
+ * its own reader slot and receives every record. The writer holds back while
+ * the slowest reader is a full ring behind and evicts readers that stop
+ * reading, so a reader must keep polling - the poll doubles as its heartbeat.
+ *
+ * @example
+ * ```typescript
+ * const events = await MemioBroadcastReader.open('events', record => {
+ *   handle(record);
+ * });
+ * // ...
+ * events.close();
+ * ```
+ */
+
+import { invoke } from '@tauri-apps/api/core';
+import { BROADCAST_RECORD_HEADER_SIZE } from './shared-broadcast-spec';
+import type { MemioLinuxGlobals } from './shared-types';
+
+/** Default poll interval; must stay well below the writer's eviction timeout. */
+const BROADCAST_POLL_MS = 16;
+
+export interface MemioBroadcastOptions {
+  /** Poll interval in milliseconds (default 16) */
+  pollMs?: number;
+}
+
+interface OpenResult {
+  path: string;
+  capacity: number;
+  slots: number;
+}
+
+type BroadcastGlobals = Required<
+  Pick<MemioLinuxGlobals, 'memioBroadcastAttach' | 'memioBroadcastRead' | 'memioBroadcastDetach'>
+>;
+
+/**
+ * Returns true if the WebKit extension exposes broadcast rings.
+ */
+export function hasBroadcastRings(): boolean {
+  const global = globalThis as unknown as MemioLinuxGlobals;
+  return (
+    typeof global.memioBroadcastAttach === 'function' &&
+    typeof global.memioBroadcastRead === 'function' &&
+    typeof global.memioBroadcastDetach === 'function'
+  );
+}
+
+export class MemioBroadcastReader {
+  private readonly global: BroadcastGlobals;
+  private readonly path: string;
+  private readonly buffer: Uint8Array;
+  private readonly onRecord: (record: Uint8Array) => void;
+  private slot: number;
+  private timer: ReturnType<typeof setInterval> | null;
+
+  private constructor(
+    global: BroadcastGlobals,
+    path: string,
+    capacity: number,
+    slot: number,
+    onRecord: (record: Uint8Array) => void,
+    pollMs: number
+  ) {
+    this.global = global;
+    this.path = path;
+    this.buffer = new Uint8Array(capacity);
+    this.slot = slot;
+    this.onRecord = onRecord;
+    this.timer = setInterval(() => this.poll(), pollMs);
+  }
+
+  /**
+   * Attaches to the broadcast ring `name` and calls `onRecord` for every
+   * record published from now on. Record views are only valid during the
+   * callback; copy them to keep them.
+   */
+  static async open(
+    name: string,
+    onRecord: (record: Uint8Array) => void,
+    options: MemioBroadcastOptions = {}
+  ): Promise<MemioBroadcastReader> {
+    if (!hasBroadcastRings()) {
+      throw new Error('Broadcast rings are not available in this webview.');
+    }
+    const result = await invoke<OpenResult>('plugin:memio|memio_broadcast_open', { name });
+    const global = globalThis as unknown as BroadcastGlobals;
+    const slot = global.memioBroadcastAttach(result.path);
+    if (slot < 0) {
+      throw new Error(`No free reader slot in broadcast '${name}' (${result.slots} slots).`);
+    }
+    return new MemioBroadcastReader(
+      global,
+      result.path,
+      result.capacity,
+      slot,
+      onRecord,
+      options.pollMs ?? BROADCAST_POLL_MS
+    );
+  }
+
+  /**
+   * Returns true while the reader holds its slot.
+   */
+  get attached(): boolean {
+    return this.slot >= 0;
+  }
+
+  /**
+   * Delivers every waiting record. Called by the poll timer; call it directly
+   * after a doorbell to cut latency.
+   */
+  poll(): void {
+    if (this.slot < 0) {
+      return;
+    }
+    for (;;) {
+      const length = this.global.memioBroadcastRead(this.path, this.slot, this.buffer);
+      if (length < 0) {
+        // Evicted after falling silent (e.g. a suspended page): rejoin at the head
+        this.slot = this.global.memioBroadcastAttach(this.path);
+        if (this.slot < 0) {
+          this.stop();
+        }
+        return;
+      }
+      if (length === 0) {
+        return;
+      }
+      this.dispatch(length);
+    }
+  }
+
+  /**
+   * Releases the reader slot and stops polling.
+   */
+  close(): void {
+    if (this.slot >= 0) {
+      this.global.memioBroadcastDetach(this.path, this.slot);
+      this.slot = -1;
+    }
+    this.stop();
+  }
+
+  private dispatch(length: number): void {
+    const view = new DataView(this.buffer.buffer, this.buffer.byteOffset, length);
+    let offset = 0;
+    while (offset + BROADCAST_RECORD_HEADER_SIZE <= length) {
+      const size = view.getUint32(offset, true);
+      const start = offset + BROADCAST_RECORD_HEADER_SIZE;
+      offset = start + size;
+      this.onRecord(this.buffer.subarray(start, offset));
+    }
+  }
+
+  private stop(): void {
+    if (this.timer) {
+      clearInterval(this.timer);
+      this.timer = null;
+    }
+  }
+}
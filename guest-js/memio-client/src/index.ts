@@ -64,7 +64,59 @@ export type { SharedStateManifest, SharedStateSnapshot, SharedStateWriteResult,
 // =============================================================================
 // UNIFIED API - Use these for cross-platform experience
 // =============================================================================
-export { memioRead, memioWrite, memioUpload, memioUploadFile } from './unified';
-export type { MemioReadResult, MemioWriteResult } from './unified';
+export { memioRead, memioInfoMany, memioWrite, memioUpload, memioUploadFile } from './unified';
+export type { MemioReadResult, MemioWriteResult, MemioBufferInfo } from './unified';
+// Linux direct copy into caller memory (e.g. wasm linear memory)
+export { readLinuxSharedBufferInto, hasLinuxReadInto } from './platform/linux';
+export type { MemioReadIntoResult } from './shared-types';
+// Linux memio:// scheme - ranged, ETag-aware reads straight from the region
+export {
+  readSharedStateLinuxMemioProtocol,
+  readMemioRange,
+  streamMemioInto,
+  LINUX_MEMIO_PROTOCOL_BASE,
+} from './platform/linux-memio-protocol';
+export type { MemioRangeResult } from './platform/linux-memio-protocol';
+// Binary IPC channel fallback for webviews without direct memory access
+export { ChannelStreamReader, readSharedStateChannelStream, hasChannelStream } from './platform/channel-stream';
 // Windows bootstrap helper (call early on startup to wire SharedBuffer listener)
 export { bootstrapWindowsSharedBuffer } from './platform/windows';
+// SharedArrayBuffer mirror for worker-side decoding (cross-origin isolated contexts)
+export {
+  SharedStateMirror,
+  SharedStateWorkerView,
+  attachSharedState,
+  waitForSharedWord,
+  hasSharedArrayBufferSupport,
+  hasAtomicsWaitAsync,
+} from './worker';
+export type { SharedStateHandle, SharedStateWorkerSnapshot, SharedWaitResult } from './worker';
+// Worker pool for decoding/transforming buffers off the UI thread
+export {
+  MemioWorkerPool,
+  registerMemioTransform,
+  serveMemioTransforms,
+  memioColumnsTransform,
+  memioColumnViews,
+  MEMIO_COLUMNS_TRANSFORM,
+} from './worker-pool';
+export type {
+  MemioTransform,
+  MemioTransformOutput,
+  MemioWorkerResult,
+  MemioWorkerPoolOptions,
+  MemioWorkerScope,
+  MemioColumnType,
+  MemioColumnsParams,
+} from './worker-pool';
+// Binary RPC to the backend (shared rings on Linux, raw IPC batches elsewhere)
+export { MemioRpcClient, benchmarkMemioRpc, hasRpcRings, RPC_METHOD_ECHO } from './rpc';
+export type {
+  MemioRpcOptions,
+  MemioRpcTransport,
+  MemioRpcBenchmarkOptions,
+  MemioRpcBenchmarkResult,
+} from './rpc';
+// Multi-consumer event streams from the backend (Linux)
+export { MemioBroadcastReader, hasBroadcastRings } from './broadcast';
+export type { MemioBroadcastOptions } from './broadcast';
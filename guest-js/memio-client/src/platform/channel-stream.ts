@@ -0,0 +1,221 @@
+/**
+ * Channel streaming fallback - raw binary IPC, no JSON, no Base64.
+ *
+ * Used when the webview has no direct memory access (e.g. the Linux WebKit
+ * extension failed to load). The `memio_stream` command pushes the region
+ * through a Tauri `Channel` as raw binary messages:
+ *
+ * ```
+ * [header: 64 bytes (magic, version, length)] [chunk] [chunk] ... [chunk]
+ * ```
+ *
+ * Chunks are copied into reusable `ArrayBuffer`s that grow geometrically,
+ * so steady-state reads allocate nothing on the JS side. Each region has two:
+ * one backs the last snapshot returned, the other receives the next stream
+ * and is swapped in only once it completed.
+ */
+
+import { Channel, invoke } from '@tauri-apps/api/core';
+import { StateView } from '../state-view';
+import type { SharedStateSnapshot } from '../shared-types';
+import {
+  SHARED_STATE_HEADER_SIZE,
+  SHARED_STATE_LENGTH_OFFSET,
+  SHARED_STATE_MAGIC,
+  SHARED_STATE_MAGIC_OFFSET,
+  SHARED_STATE_VERSION_OFFSET,
+} from '../shared-state-spec';
+
+/** Reusable storage of one region. */
+interface RegionStorage {
+  /** Backs the last snapshot returned. */
+  front: ArrayBuffer | null;
+  /** Receives the next stream. */
+  spare: ArrayBuffer | null;
+}
+
+interface StreamResult {
+  success: boolean;
+  version: number;
+  length: number;
+  chunks: number;
+}
+
+/** Returns true if Tauri IPC is available in this webview. */
+export function hasChannelStream(): boolean {
+  return typeof (globalThis as any).__TAURI_INTERNALS__?.invoke === 'function';
+}
+
+/**
+ * Reads memio regions through the `memio_stream` command.
+ *
+ * The returned snapshot views the reader's reusable storage. A failed or
+ * unchanged read leaves it intact; a successful one swaps in the other
+ * buffer, so a snapshot stays valid until the second `read` of the same
+ * region after it starts. Copy it if it must outlive that.
+ */
+export class ChannelStreamReader {
+  private storage: Map<string, RegionStorage> = new Map();
+  /** Read in flight per region: reads of one region run one at a time. */
+  private inflight: Map<string, Promise<SharedStateSnapshot | null>> = new Map();
+
+  /**
+   * @param chunkSize Optional - bytes per channel message (backend default 1 MiB)
+   */
+  constructor(private readonly chunkSize?: number) {}
+
+  /**
+   * Stream a region into reusable storage.
+   *
+   * @param name The name of the memio region
+   * @param lastVersion Optional - skip read if version hasn't changed
+   * @returns SharedStateSnapshot or null on error/no change
+   */
+  async read(name: string = 'state', lastVersion?: bigint): Promise<SharedStateSnapshot | null> {
+    // Overlapping reads would stream into the same spare buffer
+    const previous = this.inflight.get(name);
+    const current = (previous ?? Promise.resolve(null))
+      .catch(() => null)
+      .then(() => this.stream(name, lastVersion));
+    this.inflight.set(name, current);
+    try {
+      return await current;
+    } finally {
+      if (this.inflight.get(name) === current) {
+        this.inflight.delete(name);
+      }
+    }
+  }
+
+  private async stream(name: string, lastVersion?: bigint): Promise<SharedStateSnapshot | null> {
+    let target: Uint8Array | null = null;
+    let version = BigInt(0);
+    let length = 0;
+    let received = 0;
+    let failed = false;
+    // Set once this read returns: late chunks must not land in a buffer a
+    // later read streams into
+    let closed = false;
+
+    let allReceived!: () => void;
+    const done = new Promise<void>((resolve) => {
+      allReceived = resolve;
+    });
+
+    const channel = new Channel<ArrayBuffer>();
+    channel.onmessage = (message) => {
+      if (closed) {
+        return;
+      }
+      const bytes = new Uint8Array(message);
+      if (!target) {
+        const header = new DataView(message);
+        if (
+          bytes.length < SHARED_STATE_HEADER_SIZE ||
+          header.getBigUint64(SHARED_STATE_MAGIC_OFFSET, true) !== SHARED_STATE_MAGIC
+        ) {
+          failed = true;
+          allReceived();
+          return;
+        }
+        version = header.getBigUint64(SHARED_STATE_VERSION_OFFSET, true);
+        length = Number(header.getBigUint64(SHARED_STATE_LENGTH_OFFSET, true));
+        target = new Uint8Array(this.reserve(name, length), 0, length);
+        if (length === 0) {
+          allReceived();
+        }
+        return;
+      }
+
+      if (received + bytes.length > length) {
+        failed = true;
+        allReceived();
+        return;
+      }
+      target.set(bytes, received);
+      received += bytes.length;
+      if (received >= length) {
+        allReceived();
+      }
+    };
+
+    try {
+      const result = await invoke<StreamResult>('plugin:memio|memio_stream', {
+        bufferName: name,
+        lastVersion: lastVersion !== undefined ? Number(lastVersion) : undefined,
+        chunkSize: this.chunkSize,
+        onChunk: channel,
+      });
+      if (!result.success) {
+        return null; // No change
+      }
+      // Large channel messages are fetched asynchronously and may land
+      // after the command itself resolves.
+      await done;
+    } catch (error) {
+      console.error('[Memio] Error reading via channel stream:', error);
+      return null;
+    } finally {
+      closed = true;
+    }
+
+    if (failed || !target) {
+      console.error('[Memio] Channel stream returned an invalid header or payload');
+      return null;
+    }
+    this.commit(name, target);
+
+    return {
+      version,
+      length,
+      view: new StateView(target),
+    };
+  }
+
+  /**
+   * Drop the reusable storage of one region, or of all regions. Snapshots
+   * already returned keep their buffers alive.
+   */
+  release(name?: string): void {
+    if (name === undefined) {
+      this.storage.clear();
+    } else {
+      this.storage.delete(name);
+    }
+  }
+
+  /** Returns the spare buffer of `name`, grown to hold `length` bytes. */
+  private reserve(name: string, length: number): ArrayBuffer {
+    const slots = this.storage.get(name);
+    const spare = slots?.spare;
+    if (spare && spare.byteLength >= length) {
+      return spare;
+    }
+    let capacity = Math.max(spare?.byteLength ?? 0, slots?.front?.byteLength ?? 0, 64 * 1024);
+    while (capacity < length) {
+      capacity *= 2;
+    }
+    return new ArrayBuffer(capacity);
+  }
+
+  /** Makes the buffer behind `target`, fully streamed, the front buffer of `name`. */
+  private commit(name: string, target: Uint8Array): void {
+    const slots = this.storage.get(name);
+    this.storage.set(name, { front: target.buffer as ArrayBuffer, spare: slots?.front ?? null });
+  }
+}
+
+let defaultReader: ChannelStreamReader | null = null;
+
+/**
+ * Read shared state through the channel stream fallback.
+ *
+ * Shares one reader (and its storage) across calls.
+ */
+export async function readSharedStateChannelStream(
+  name: string = 'state',
+  lastVersion?: bigint
+): Promise<SharedStateSnapshot | null> {
+  defaultReader ??= new ChannelStreamReader();
+  return defaultReader.read(name, lastVersion);
+}
@@ -0,0 +1,176 @@
+/**
+ * Linux memio:// protocol implementation - ranged reads, no full copies.
+ *
+ * The plugin registers a `memio://` URI scheme on Linux that serves region
+ * payloads straight from shared memory:
+ *
+ * ```
+ * fetch("memio://buffer/name", { headers: { Range: "bytes=0-4095" } })
+ *   → 206 Partial Content, X-Memio-Version / X-Memio-Length headers
+ * ```
+ *
+ * `ETag` is the region version, so `If-None-Match` answers `304 Not Modified`
+ * without copying anything when the region did not change.
+ */
+
+import { StateView } from '../state-view';
+import type { SharedStateSnapshot } from '../shared-types';
+
+/** Base URL of the Linux memio:// scheme. */
+export const LINUX_MEMIO_PROTOCOL_BASE = 'memio://buffer/';
+
+/** Result of a ranged read. */
+export interface MemioRangeResult {
+  /** Region version the bytes belong to */
+  version: bigint;
+  /** Full payload length of the region */
+  length: number;
+  /** Offset of `data` inside the payload */
+  offset: number;
+  /** The requested bytes */
+  data: Uint8Array;
+}
+
+function memioUrl(name: string): string {
+  return `${LINUX_MEMIO_PROTOCOL_BASE}${encodeURIComponent(name)}`;
+}
+
+function requestHeaders(lastVersion?: bigint, range?: { start: number; end?: number }): HeadersInit {
+  const headers: Record<string, string> = {};
+  if (lastVersion !== undefined && lastVersion >= 0) {
+    headers['If-None-Match'] = `"${lastVersion}"`;
+  }
+  if (range) {
+    headers['Range'] = `bytes=${range.start}-${range.end !== undefined ? range.end - 1 : ''}`;
+  }
+  return headers;
+}
+
+function parseMeta(response: Response): { version: bigint; length: number } {
+  const versionStr = response.headers.get('X-Memio-Version');
+  const lengthStr = response.headers.get('X-Memio-Length');
+  return {
+    version: versionStr ? BigInt(versionStr) : BigInt(0),
+    length: lengthStr ? parseInt(lengthStr, 10) : 0,
+  };
+}
+
+/**
+ * Read shared state using the Linux memio:// protocol.
+ *
+ * @param name The name of the memio region
+ * @param lastVersion Optional - skip read if version hasn't changed (304)
+ * @returns SharedStateSnapshot or null on error/no change
+ */
+export async function readSharedStateLinuxMemioProtocol(
+  name: string = 'state',
+  lastVersion?: bigint
+): Promise<SharedStateSnapshot | null> {
+  try {
+    const response = await fetch(memioUrl(name), { headers: requestHeaders(lastVersion) });
+    if (response.status === 304) {
+      return null; // No change
+    }
+    if (!response.ok) {
+      throw new Error(`HTTP ${response.status}: ${response.statusText}`);
+    }
+
+    const { version, length } = parseMeta(response);
+    const bytes = new Uint8Array(await response.arrayBuffer());
+    return {
+      version,
+      length,
+      view: new StateView(bytes),
+    };
+  } catch (error) {
+    console.error('[MemioLinux] Error reading via memio:// protocol:', error);
+    return null;
+  }
+}
+
+/**
+ * Fetch a byte range `[start, end)` of a region.
+ *
+ * Only the requested slice is copied by the backend. Omit `end` to read to
+ * the end of the payload.
+ *
+ * @returns MemioRangeResult, or null on error/no change/unsatisfiable range
+ */
+export async function readMemioRange(
+  name: string,
+  start: number,
+  end?: number,
+  lastVersion?: bigint
+): Promise<MemioRangeResult | null> {
+  try {
+    const response = await fetch(memioUrl(name), {
+      headers: requestHeaders(lastVersion, { start, end }),
+    });
+    if (response.status === 304 || response.status === 416) {
+      return null;
+    }
+    if (!response.ok) {
+      throw new Error(`HTTP ${response.status}: ${response.statusText}`);
+    }
+
+    const { version, length } = parseMeta(response);
+    const data = new Uint8Array(await response.arrayBuffer());
+    // A 200 means the backend ignored the range and sent everything.
+    const offset = response.status === 206 ? start : 0;
+    return { version, length, offset, data };
+  } catch (error) {
+    console.error('[MemioLinux] Error reading range via memio:// protocol:', error);
+    return null;
+  }
+}
+
+/**
+ * Stream a region (or a range of it) into `target` as the body arrives.
+ *
+ * Uses the response `ReadableStream`, so no intermediate `ArrayBuffer` of
+ * the full payload is allocated. Bytes beyond `target` are dropped.
+ *
+ * @returns version and number of bytes written, or null on error/no change
+ */
+export async function streamMemioInto(
+  name: string,
+  target: Uint8Array,
+  options: { start?: number; end?: number; lastVersion?: bigint } = {}
+): Promise<{ version: bigint; length: number; written: number } | null> {
+  const range = options.start !== undefined || options.end !== undefined
+    ? { start: options.start ?? 0, end: options.end }
+    : undefined;
+
+  try {
+    const response = await fetch(memioUrl(name), {
+      headers: requestHeaders(options.lastVersion, range),
+    });
+    if (response.status === 304 || response.status === 416) {
+      return null;
+    }
+    if (!response.ok || !response.body) {
+      throw new Error(`HTTP ${response.status}: ${response.statusText}`);
+    }
+
+    const { version, length } = parseMeta(response);
+    const reader = response.body.getReader();
+    let written = 0;
+    for (;;) {
+      const { done, value } = await reader.read();
+      if (done) {
+        break;
+      }
+      const n = Math.min(value.length, target.length - written);
+      target.set(value.subarray(0, n), written);
+      written += n;
+      if (written === target.length) {
+        await reader.cancel();
+        break;
+      }
+    }
+    return { version, length, written };
+  } catch (error) {
+    console.error('[MemioLinux] Error streaming via memio:// protocol:', error);
+    return null;
+  }
+}
@@ -1,4 +1,4 @@
-import type { MemioLinuxGlobals } from '../shared-types';
+import type { MemioLinuxGlobals, MemioReadIntoResult } from '../shared-types';
 
 export function hasLinuxSharedMemory(): boolean {
   const global = globalThis as unknown as MemioLinuxGlobals;
@@ -28,3 +28,42 @@ export function getLinuxSharedBuffer(name?: string): ArrayBuffer | Uint8Array |
 
   return null;
 }
+
+/** Returns true if the extension provides direct `memioReadInto` copies. */
+export function hasLinuxReadInto(): boolean {
+  const global = globalThis as unknown as MemioLinuxGlobals;
+  return typeof global.memioReadInto === 'function';
+}
+
+/**
+ * Copy region payload bytes straight from shared memory into `target`.
+ *
+ * `target` may be any typed array or ArrayBuffer, including a view of
+ * `WebAssembly.Memory.buffer`, so wasm modules get the data with a single
+ * copy instead of going through `__memioSharedBuffers`.
+ *
+ * @param name Region name
+ * @param target Destination memory
+ * @param offset Byte offset into `target`
+ * @param options Optional source range and version check
+ * @returns Copy result, or null if unavailable or the region is unknown
+ */
+export function readLinuxSharedBufferInto(
+  name: string,
+  target: ArrayBufferView | ArrayBuffer,
+  offset: number = 0,
+  options: { srcOffset?: number; srcLength?: number; lastVersion?: bigint } = {}
+): MemioReadIntoResult | null {
+  const global = globalThis as unknown as MemioLinuxGlobals;
+  if (typeof global.memioReadInto !== 'function') {
+    return null;
+  }
+  return global.memioReadInto(
+    name,
+    target,
+    offset,
+    options.srcOffset,
+    options.srcLength,
+    options.lastVersion !== undefined ? Number(options.lastVersion) : undefined
+  );
+}
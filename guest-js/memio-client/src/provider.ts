@@ -12,10 +12,11 @@ import {
   downloadViaSharedBuffer,
   uploadViaSharedBuffer,
 } from './platform/windows';
+import { ChannelStreamReader, hasChannelStream } from './platform/channel-stream';
 import type { SharedStateSnapshot, SharedStateWriteResult, MemioPlatform } from './shared-types';
 import type { SharedStateManifest } from './shared-types';
 import { readSharedState, writeSharedStateBuffer } from './shared-state';
-import { getSharedManifest } from './shared-state';
+import { detectPlatform, getSharedManifest } from './shared-state';
 import { StateView } from './state-view';
 
 export interface SharedStateProvider {
@@ -208,6 +209,58 @@ class WindowsProvider implements SharedStateProvider {
   }
 }
 
+/**
+ * Fallback for webviews without direct memory access: streams regions
+ * through the `memio_stream` IPC channel into reusable storage.
+ *
+ * Read-only. Synchronous reads return the last streamed snapshot.
+ */
+class ChannelStreamProvider implements SharedStateProvider {
+  private reader = new ChannelStreamReader();
+  private cache: Map<string, SharedStateSnapshot> = new Map();
+
+  platform(): MemioPlatform {
+    return detectPlatform();
+  }
+
+  isAvailable(): boolean {
+    return hasChannelStream();
+  }
+
+  sharedManifest(): SharedStateManifest | null {
+    return getSharedManifest();
+  }
+
+  getSharedBuffer(name?: string): ArrayBuffer | Uint8Array | null {
+    return this.cache.get(name ?? 'state')?.view.bytes ?? null;
+  }
+
+  readSharedState(name?: string, lastVersion?: bigint): SharedStateSnapshot | null {
+    const cached = this.cache.get(name ?? 'state');
+    if (!cached || (lastVersion !== undefined && cached.version <= lastVersion)) {
+      return null;
+    }
+    return cached;
+  }
+
+  async readSharedStateAsync(name?: string, lastVersion?: bigint): Promise<SharedStateSnapshot | null> {
+    const stateName = name ?? 'state';
+    const snapshot = await this.reader.read(stateName, lastVersion);
+    if (snapshot) {
+      this.cache.set(stateName, snapshot);
+    }
+    return snapshot;
+  }
+
+  writeSharedState(): SharedStateWriteResult | null {
+    return null;
+  }
+
+  async prepareCache(name: string): Promise<boolean> {
+    return (await this.readSharedStateAsync(name)) !== null;
+  }
+}
+
 class UnknownProvider implements SharedStateProvider {
   platform(): MemioPlatform {
     return 'unknown';
@@ -245,5 +298,9 @@ export function createSharedStateProvider(): SharedStateProvider {
   if (hasLinuxSharedMemory()) {
     return new LinuxProvider();
   }
+  if (hasChannelStream()) {
+    console.debug('[MemioClient] No direct memory access, using channel stream provider');
+    return new ChannelStreamProvider();
+  }
   return new UnknownProvider();
 }
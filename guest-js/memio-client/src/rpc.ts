@@ -0,0 +1,432 @@
+/**
+ * MemioRpcClient - binary request/response calls into the Rust backend.
+ *
+ * Calls are encoded as length-prefixed frames (see `shared_rpc_spec.json`)
+ * and every call made in the same microtask goes out as one batch:
+ *
+ * ```
+ * [length u32][correlation u32][method u32][flags u32][payload] ...
+ * ```
+ *
+ * Transports:
+ * - **Linux** (WebKit extension loaded): a request ring and a response ring
+ *   in `/dev/shm`, opened with `memio_rpc_open`. Writes ring the doorbell;
+ *   the backend's reply rings it back and `memioOnDoorbell` drains the
+ *   response ring. No JSON, no IPC round trip.
+ * - **Elsewhere**: each batch is one raw-body `memio_rpc_batch` invoke that
+ *   returns the response frames as an ArrayBuffer.
+ *
+ * @example
+ * ```typescript
+ * const rpc = await MemioRpcClient.open();
+ * const reply = await rpc.call(METHOD_ADD, new Uint8Array([...]));
+ * ```
+ */
+
+import { invoke } from '@tauri-apps/api/core';
+import {
+  RPC_FLAG_ERROR,
+  RPC_FRAME_CORRELATION_OFFSET,
+  RPC_FRAME_FLAGS_OFFSET,
+  RPC_FRAME_HEADER_SIZE,
+  RPC_FRAME_LENGTH_OFFSET,
+  RPC_FRAME_METHOD_OFFSET,
+} from './shared-rpc-spec';
+import type { MemioLinuxGlobals } from './shared-types';
+
+/** Built-in method: replies with the request payload. */
+export const RPC_METHOD_ECHO = 0;
+
+/** Response ring poll interval while calls are pending (missed doorbells). */
+const RING_POLL_MS = 5;
+/** Retry delay when the request ring is full. */
+const RING_RETRY_MS = 1;
+/** Default time a call may wait for its response. */
+const CALL_TIMEOUT_MS = 30000;
+
+export type MemioRpcTransport = 'ring' | 'ipc';
+
+export interface MemioRpcOptions {
+  /** Ring size per direction in bytes (Linux only, default 1 MiB) */
+  capacity?: number;
+  /** Force a transport; defaults to rings where the extension provides them */
+  transport?: MemioRpcTransport;
+  /** Reject calls unanswered after this many milliseconds (default 30000, 0 = never) */
+  timeoutMs?: number;
+}
+
+interface OpenResult {
+  requestRing: string;
+  responseRing: string;
+  capacity: number;
+}
+
+interface PendingCall {
+  method: number;
+  payload: Uint8Array;
+  correlation: number;
+  resolve: (payload: Uint8Array) => void;
+  reject: (error: Error) => void;
+  timer: ReturnType<typeof setTimeout> | null;
+}
+
+interface RingState {
+  global: Required<
+    Pick<
+      MemioLinuxGlobals,
+      'memioRingWrite' | 'memioRingRead' | 'memioRingClose' | 'memioOnDoorbell' | 'memioOffDoorbell'
+    >
+  >;
+  requestRing: string;
+  responseRing: string;
+  capacity: number;
+  readBuffer: Uint8Array;
+}
+
+/**
+ * Returns true if the WebKit extension exposes the shared RPC rings.
+ */
+export function hasRpcRings(): boolean {
+  const global = globalThis as unknown as MemioLinuxGlobals;
+  return (
+    typeof global.memioRingWrite === 'function' &&
+    typeof global.memioRingRead === 'function' &&
+    typeof global.memioRingClose === 'function' &&
+    typeof global.memioOnDoorbell === 'function' &&
+    typeof global.memioOffDoorbell === 'function'
+  );
+}
+
+/**
+ * Appends one frame to `out` at `offset`; returns the offset after it.
+ */
+function encodeFrame(out: Uint8Array, offset: number, call: PendingCall): number {
+  const view = new DataView(out.buffer, out.byteOffset + offset, RPC_FRAME_HEADER_SIZE);
+  view.setUint32(RPC_FRAME_LENGTH_OFFSET, call.payload.byteLength, true);
+  view.setUint32(RPC_FRAME_CORRELATION_OFFSET, call.correlation, true);
+  view.setUint32(RPC_FRAME_METHOD_OFFSET, call.method, true);
+  view.setUint32(RPC_FRAME_FLAGS_OFFSET, 0, true);
+  out.set(call.payload, offset + RPC_FRAME_HEADER_SIZE);
+  return offset + RPC_FRAME_HEADER_SIZE + call.payload.byteLength;
+}
+
+export class MemioRpcClient {
+  private readonly ring: RingState | null;
+  private readonly timeoutMs: number;
+  private readonly queue: PendingCall[] = [];
+  private readonly inFlight = new Map<number, PendingCall>();
+  private readonly decoder = new TextDecoder();
+  private nextCorrelation = 1;
+  private flushScheduled = false;
+  private pollTimer: ReturnType<typeof setInterval> | null = null;
+  private closed = false;
+  private doorbell = 0;
+
+  private constructor(ring: RingState | null, timeoutMs: number) {
+    this.ring = ring;
+    this.timeoutMs = timeoutMs;
+    if (ring) {
+      this.doorbell = ring.global.memioOnDoorbell(() => this.drain());
+    }
+  }
+
+  /**
+   * Opens a client on the fastest transport available.
+   */
+  static async open(options: MemioRpcOptions = {}): Promise<MemioRpcClient> {
+    const timeoutMs = options.timeoutMs ?? CALL_TIMEOUT_MS;
+    const useRing = options.transport ? options.transport === 'ring' : hasRpcRings();
+    if (!useRing) {
+      return new MemioRpcClient(null, timeoutMs);
+    }
+    if (!hasRpcRings()) {
+      throw new Error('Shared RPC rings are not available in this webview.');
+    }
+
+    const result = await invoke<OpenResult>('plugin:memio|memio_rpc_open', {
+      capacity: options.capacity ?? null,
+    });
+    const global = globalThis as unknown as RingState['global'];
+    const ring: RingState = {
+      global,
+      requestRing: result.requestRing,
+      responseRing: result.responseRing,
+      capacity: result.capacity,
+      readBuffer: new Uint8Array(result.capacity),
+    };
+    return new MemioRpcClient(ring, timeoutMs);
+  }
+
+  /**
+   * Returns the transport in use.
+   */
+  get transport(): MemioRpcTransport {
+    return this.ring ? 'ring' : 'ipc';
+  }
+
+  /**
+   * Calls `method` with a binary payload and resolves with the reply payload.
+   *
+   * Rejects with the handler's message if the backend returns an error frame,
+   * and after `timeoutMs` without a response (e.g. a request the backend
+   * had to drop).
+   */
+  call(method: number, payload: Uint8Array = new Uint8Array(0)): Promise<Uint8Array> {
+    if (this.closed) {
+      return Promise.reject(new Error('MemioRpcClient is closed.'));
+    }
+    if (this.ring && RPC_FRAME_HEADER_SIZE + payload.byteLength > this.ring.capacity) {
+      return Promise.reject(new RangeError('RPC payload exceeds the ring capacity.'));
+    }
+
+    return new Promise((resolve, reject) => {
+      const correlation = this.nextCorrelation;
+      this.nextCorrelation = (this.nextCorrelation + 1) >>> 0 || 1;
+      const call: PendingCall = { method, payload, correlation, resolve, reject, timer: null };
+      if (this.timeoutMs > 0) {
+        call.timer = setTimeout(() => this.expire(call), this.timeoutMs);
+      }
+      this.queue.push(call);
+      if (!this.flushScheduled) {
+        this.flushScheduled = true;
+        queueMicrotask(() => this.flush());
+      }
+    });
+  }
+
+  /**
+   * Rejects outstanding calls, detaches this client from the doorbell and
+   * unmaps its rings.
+   */
+  close(): void {
+    if (this.closed) {
+      return;
+    }
+    this.closed = true;
+    if (this.ring) {
+      this.ring.global.memioOffDoorbell(this.doorbell);
+      this.ring.global.memioRingClose(this.ring.requestRing);
+      this.ring.global.memioRingClose(this.ring.responseRing);
+    }
+    this.stopPolling();
+    const error = new Error('MemioRpcClient is closed.');
+    for (const call of [...this.queue, ...this.inFlight.values()]) {
+      this.clearTimer(call);
+      call.reject(error);
+    }
+    this.queue.length = 0;
+    this.inFlight.clear();
+  }
+
+  /**
+   * Sends queued calls as one batch (as many as fit, for rings).
+   */
+  private flush(): void {
+    this.flushScheduled = false;
+    if (this.closed || this.queue.length === 0) {
+      return;
+    }
+
+    const limit = this.ring ? this.ring.capacity : Infinity;
+    let size = 0;
+    let count = 0;
+    for (const call of this.queue) {
+      const frameSize = RPC_FRAME_HEADER_SIZE + call.payload.byteLength;
+      if (size + frameSize > limit) {
+        break;
+      }
+      size += frameSize;
+      count++;
+    }
+
+    const frames = new Uint8Array(size);
+    let offset = 0;
+    for (let i = 0; i < count; i++) {
+      offset = encodeFrame(frames, offset, this.queue[i]);
+    }
+
+    if (this.ring) {
+      if (!this.ring.global.memioRingWrite(this.ring.requestRing, frames)) {
+        // Ring full: the backend is still draining, retry shortly
+        this.flushScheduled = true;
+        setTimeout(() => this.flush(), RING_RETRY_MS);
+        return;
+      }
+      for (const call of this.queue.splice(0, count)) {
+        this.inFlight.set(call.correlation, call);
+      }
+      this.startPolling();
+      if (this.queue.length > 0) {
+        this.flushScheduled = true;
+        queueMicrotask(() => this.flush());
+      }
+      return;
+    }
+
+    const batch = this.queue.splice(0, count);
+    for (const call of batch) {
+      this.inFlight.set(call.correlation, call);
+    }
+    invoke<ArrayBuffer>('plugin:memio|memio_rpc_batch', frames).then(
+      response => this.settle(new Uint8Array(response)),
+      error => {
+        const failure = error instanceof Error ? error : new Error(String(error));
+        for (const call of batch) {
+          if (this.inFlight.delete(call.correlation)) {
+            this.clearTimer(call);
+            call.reject(failure);
+          }
+        }
+      }
+    );
+  }
+
+  /**
+   * Reads every response frame waiting in the response ring.
+   */
+  private drain(): void {
+    const ring = this.ring;
+    if (!ring || this.closed) {
+      return;
+    }
+    for (;;) {
+      const length = ring.global.memioRingRead(ring.responseRing, ring.readBuffer);
+      if (length <= 0) {
+        break;
+      }
+      this.settle(ring.readBuffer.subarray(0, length));
+    }
+    if (this.inFlight.size === 0) {
+      this.stopPolling();
+    }
+  }
+
+  /**
+   * Resolves the calls answered by a buffer of response frames.
+   */
+  private settle(frames: Uint8Array): void {
+    const view = new DataView(frames.buffer, frames.byteOffset, frames.byteLength);
+    let offset = 0;
+    while (offset + RPC_FRAME_HEADER_SIZE <= frames.byteLength) {
+      const length = view.getUint32(offset + RPC_FRAME_LENGTH_OFFSET, true);
+      const correlation = view.getUint32(offset + RPC_FRAME_CORRELATION_OFFSET, true);
+      const flags = view.getUint32(offset + RPC_FRAME_FLAGS_OFFSET, true);
+      const start = offset + RPC_FRAME_HEADER_SIZE;
+      offset = start + length;
+      if (offset > frames.byteLength) {
+        break;
+      }
+
+      const call = this.inFlight.get(correlation);
+      if (!call) {
+        continue;
+      }
+      this.inFlight.delete(correlation);
+      this.clearTimer(call);
+      // Copy out: ring read buffers are reused on the next drain
+      const payload = frames.slice(start, offset);
+      if (flags & RPC_FLAG_ERROR) {
+        call.reject(new Error(this.decoder.decode(payload)));
+      } else {
+        call.resolve(payload);
+      }
+    }
+  }
+
+  /**
+   * Rejects a call that got no response in time. A late response for it is
+   * ignored, like any unknown correlation id.
+   */
+  private expire(call: PendingCall): void {
+    call.timer = null;
+    const queued = this.queue.indexOf(call);
+    if (queued >= 0) {
+      this.queue.splice(queued, 1);
+    } else if (!this.inFlight.delete(call.correlation)) {
+      return;
+    }
+    if (this.inFlight.size === 0) {
+      this.stopPolling();
+    }
+    call.reject(new Error(`RPC call to method ${call.method} timed out after ${this.timeoutMs} ms.`));
+  }
+
+  private clearTimer(call: PendingCall): void {
+    if (call.timer) {
+      clearTimeout(call.timer);
+      call.timer = null;
+    }
+  }
+
+  private startPolling(): void {
+    if (!this.pollTimer) {
+      this.pollTimer = setInterval(() => this.drain(), RING_POLL_MS);
+    }
+  }
+
+  private stopPolling(): void {
+    if (this.pollTimer) {
+      clearInterval(this.pollTimer);
+      this.pollTimer = null;
+    }
+  }
+}
+
+export interface MemioRpcBenchmarkOptions {
+  /** Total echo calls (default 10000) */
+  calls?: number;
+  /** Calls issued concurrently, i.e. per batch (default 64) */
+  batch?: number;
+  /** Echo payload size in bytes (default 64) */
+  payloadBytes?: number;
+  /** Also time `memio_read` JSON invokes against this buffer */
+  baselineBuffer?: string;
+}
+
+export interface MemioRpcBenchmarkResult {
+  transport: MemioRpcTransport;
+  calls: number;
+  callsPerSecond: number;
+  /** JSON `invoke('plugin:memio|memio_read')` rate, if a baseline ran */
+  baselineCallsPerSecond?: number;
+}
+
+async function timeCalls(calls: number, batch: number, call: () => Promise<unknown>): Promise<number> {
+  const start = performance.now();
+  for (let done = 0; done < calls; ) {
+    const n = Math.min(batch, calls - done);
+    const window: Promise<unknown>[] = [];
+    for (let i = 0; i < n; i++) {
+      window.push(call());
+    }
+    await Promise.all(window);
+    done += n;
+  }
+  const seconds = (performance.now() - start) / 1000;
+  return seconds > 0 ? calls / seconds : Infinity;
+}
+
+/**
+ * Measures echo round trips per second, optionally against JSON invoke.
+ */
+export async function benchmarkMemioRpc(
+  client: MemioRpcClient,
+  options: MemioRpcBenchmarkOptions = {}
+): Promise<MemioRpcBenchmarkResult> {
+  const calls = options.calls ?? 10000;
+  const batch = Math.max(1, options.batch ?? 64);
+  const payload = new Uint8Array(options.payloadBytes ?? 64);
+
+  const result: MemioRpcBenchmarkResult = {
+    transport: client.transport,
+    calls,
+    callsPerSecond: await timeCalls(calls, batch, () => client.call(RPC_METHOD_ECHO, payload)),
+  };
+  if (options.baselineBuffer !== undefined) {
+    const bufferName = options.baselineBuffer;
+    result.baselineCallsPerSecond = await timeCalls(calls, batch, () =>
+      invoke('plugin:memio|memio_read', { bufferName, lastVersion: null })
+    );
+  }
+  return result;
+}
@@ -0,0 +1,2 @@
+// Generated from shared/shared_broadcast_spec.json. Do not edit by hand.
+export const BROADCAST_RECORD_HEADER_SIZE = 4;
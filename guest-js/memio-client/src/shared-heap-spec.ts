@@ -0,0 +1,14 @@
+// Generated from shared/shared_heap_spec.json. Do not edit by hand.
+export const SHARED_HEAP_MAGIC = 0x545552424F484550n;
+export const SHARED_HEAP_HEADER_SIZE = 64;
+export const SHARED_HEAP_GENERATION_OFFSET = 16;
+export const SHARED_HEAP_DIR_OFFSET_OFFSET = 32;
+export const SHARED_HEAP_DIR_SLOTS_OFFSET = 40;
+export const SHARED_HEAP_ENTRY_SIZE = 128;
+export const SHARED_HEAP_ENTRY_STATE_OFFSET = 0;
+export const SHARED_HEAP_ENTRY_NAME_LEN_OFFSET = 4;
+export const SHARED_HEAP_ENTRY_OFFSET_OFFSET = 8;
+export const SHARED_HEAP_ENTRY_LENGTH_OFFSET = 16;
+export const SHARED_HEAP_ENTRY_VERSION_OFFSET = 32;
+export const SHARED_HEAP_ENTRY_SEQ_OFFSET = 40;
+export const SHARED_HEAP_ENTRY_NAME_OFFSET = 64;
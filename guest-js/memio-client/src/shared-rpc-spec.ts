@@ -0,0 +1,8 @@
+// Generated from shared/shared_rpc_spec.json. Do not edit by hand.
+export const RPC_FRAME_HEADER_SIZE = 16;
+export const RPC_FRAME_LENGTH_OFFSET = 0;
+export const RPC_FRAME_CORRELATION_OFFSET = 4;
+export const RPC_FRAME_METHOD_OFFSET = 8;
+export const RPC_FRAME_FLAGS_OFFSET = 12;
+export const RPC_FLAG_RESPONSE = 1;
+export const RPC_FLAG_ERROR = 2;
@@ -4,4 +4,7 @@ export const SHARED_STATE_HEADER_SIZE = 64;
 export const SHARED_STATE_MAGIC_OFFSET = 0;
 export const SHARED_STATE_VERSION_OFFSET = 8;
 export const SHARED_STATE_LENGTH_OFFSET = 16;
+export const SHARED_STATE_HISTORY_OFFSET = 24;
+export const SHARED_STATE_ACK_OFFSET = 32;
+export const SHARED_STATE_SEQ_OFFSET = 40;
 export const SHARED_STATE_ENDIANNESS = "little" as const;
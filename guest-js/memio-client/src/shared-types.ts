@@ -55,9 +55,47 @@ export interface MemioAndroidGlobals extends MemioGlobalBase {
   __memioAndroidReady?: boolean;
 }
 
+/** Result of a direct copy from a memio region into caller memory. */
+export interface MemioReadIntoResult {
+  /** Region version the bytes belong to */
+  version: number;
+  /** Full payload length of the region */
+  length: number;
+  /** Bytes copied; 0 when the version is not newer than lastVersion */
+  copied: number;
+}
+
 export interface MemioLinuxGlobals extends MemioGlobalBase {
   memioSharedBuffer?: (name?: string) => ArrayBuffer | Uint8Array | null;
   memioWriteSharedBuffer?: (name: string, data: Uint8Array) => boolean;
+  /**
+   * Copies payload bytes straight into `target`. Null on unknown buffers or
+   * when every attempt raced a writer; a torn range is zeroed, never left mixed.
+   */
+  memioReadInto?: (
+    name: string,
+    target: ArrayBufferView | ArrayBuffer,
+    offset: number,
+    srcOffset?: number,
+    srcLength?: number,
+    lastVersion?: number
+  ) => MemioReadIntoResult | null;
+  /** Appends whole RPC frames to a request ring; false if it lacks room */
+  memioRingWrite?: (ringPath: string, frames: Uint8Array) => boolean;
+  /** Moves whole RPC frames from a response ring into `target`; returns bytes */
+  memioRingRead?: (ringPath: string, target: Uint8Array) => number;
+  /** Unmaps a ring of a closed channel; false if it was not mapped */
+  memioRingClose?: (ringPath: string) => boolean;
+  /** Registers a callback run after every doorbell ring; returns its handle (0 on error) */
+  memioOnDoorbell?: (callback: () => void) => number;
+  /** Removes the callback registered under `handle` */
+  memioOffDoorbell?: (handle: number) => boolean;
+  /** Claims a reader slot in a broadcast ring; returns its index or -1 */
+  memioBroadcastAttach?: (ringPath: string) => number;
+  /** Moves whole broadcast records into `target`; returns bytes, -1 if evicted */
+  memioBroadcastRead?: (ringPath: string, slot: number, target: Uint8Array) => number;
+  /** Releases a slot claimed with memioBroadcastAttach */
+  memioBroadcastDetach?: (ringPath: string, slot: number) => boolean;
   __memioSharedBuffers?: Record<string, ArrayBuffer | Uint8Array>;
   __memioSharedPath?: string;
   __memioSharedRegistryPath?: string;
@@ -19,7 +19,7 @@
  * ```
  */
 export class StateView {
-  private readonly buffer: ArrayBuffer;
+  private readonly buffer: ArrayBufferLike;
   private readonly dataView: DataView;
   private readonly uint8View: Uint8Array;
   private readonly offset: number;
@@ -27,21 +27,21 @@ export class StateView {
 
   /**
    * Creates a new StateView from raw bytes.
+   *
+   * `SharedArrayBuffer`-backed data is viewed in place, so one decoded
+   * buffer can be read by several workers without per-worker copies.
    */
-  constructor(data: ArrayBuffer | Uint8Array) {
-    if (data instanceof ArrayBuffer) {
+  constructor(data: ArrayBuffer | SharedArrayBuffer | Uint8Array) {
+    if (data instanceof ArrayBuffer || isSharedArrayBuffer(data)) {
       this.buffer = data;
       this.offset = 0;
       this.length = data.byteLength;
     } else if (data instanceof Uint8Array) {
-      if (typeof SharedArrayBuffer !== 'undefined' && data.buffer instanceof SharedArrayBuffer) {
-        throw new TypeError("SharedArrayBuffer is not supported.");
-      }
-      this.buffer = data.buffer as ArrayBuffer;
+      this.buffer = data.buffer;
       this.offset = data.byteOffset;
       this.length = data.byteLength;
     } else {
-      throw new TypeError("Invalid data type. Expected ArrayBuffer or Uint8Array.");
+      throw new TypeError("Invalid data type. Expected ArrayBuffer, SharedArrayBuffer or Uint8Array.");
     }
     this.dataView = new DataView(this.buffer, this.offset, this.length);
     this.uint8View = new Uint8Array(this.buffer, this.offset, this.length);
@@ -54,6 +54,16 @@ export class StateView {
     return this.length;
   }
 
+  /**
+   * Returns true if the view is backed by a SharedArrayBuffer.
+   *
+   * Shared bytes can change under the view; see `SharedStateWorkerView`
+   * for how workers validate a read.
+   */
+  get isShared(): boolean {
+    return isSharedArrayBuffer(this.buffer);
+  }
+
   /**
    * Returns the underlying bytes as Uint8Array.
    */
@@ -63,9 +73,14 @@ export class StateView {
 
   /**
    * Returns the underlying ArrayBuffer.
+   *
+   * Always a private copy, also when the view is shared.
    */
   get rawBuffer(): ArrayBuffer {
-    return this.buffer.slice(this.offset, this.offset + this.length);
+    if (this.buffer instanceof ArrayBuffer) {
+      return this.buffer.slice(this.offset, this.offset + this.length);
+    }
+    return this.uint8View.slice().buffer as ArrayBuffer;
   }
 
   // ===== Unsigned Integer Readers =====
@@ -159,6 +174,7 @@ export class StateView {
    *
    * Note: This creates a new string object (GC pressure).
    * For frequent reads, consider caching or using typed arrays.
+   * The bytes are copied first since `TextDecoder` rejects shared views.
    */
   readString(offset: number, length: number): string {
     const bytes = this.uint8View.slice(offset, offset + length);
@@ -220,3 +236,7 @@ export class StateView {
     return this.resolveRelativePtr(offset);
   }
 }
+
+function isSharedArrayBuffer(value: unknown): value is SharedArrayBuffer {
+  return typeof SharedArrayBuffer !== 'undefined' && value instanceof SharedArrayBuffer;
+}
@@ -23,6 +23,7 @@
 import { invoke } from '@tauri-apps/api/core';
 import { detectPlatform, writeMemioSharedBuffer } from './shared-state';
 import { readSharedStateAndroidMemioProtocol } from './platform/android-memio-protocol';
+import { readSharedStateChannelStream } from './platform/channel-stream';
 import { StateView } from './state-view';
 
 /**
@@ -53,6 +54,22 @@ export interface MemioWriteResult {
   durationMs: number;
 }
 
+/**
+ * Header-only status of one memio buffer (see `memioInfoMany`).
+ */
+export interface MemioBufferInfo {
+  name: string;
+  /** False if no buffer of that name exists */
+  exists: boolean;
+  /** True if the version is newer than the `lastVersion` passed in */
+  changed: boolean;
+  version: bigint;
+  /** Payload length in bytes */
+  length: number;
+  /** Buffer capacity in bytes */
+  capacity: number;
+}
+
 declare global {
   interface Window {
     memioSharedBuffer?: (name: string) => ArrayBuffer | null;
@@ -64,7 +81,8 @@ declare global {
  * Read data from memio buffer.
  * 
  * This is the unified read API that works on all platforms:
- * - **Linux**: Uses WebKit extension (mmap, direct)
+ * - **Linux**: Uses WebKit extension (mmap, direct), falling back to
+ *   binary IPC channel streaming when the extension is not loaded
  * - **Android**: Uses memio:// protocol
  * - **Windows**: Uses SharedBuffer API
  * 
@@ -91,6 +109,31 @@ export async function memioRead(
   }
 }
 
+/**
+ * Get version/length of many buffers in one IPC round trip.
+ *
+ * Reads headers only, so polling a status bar over many buffers costs one
+ * invoke and no payload copies on every platform. Missing buffers come back
+ * with `exists: false`.
+ *
+ * @param bufferNames - Names of the memio buffers
+ * @param lastVersions - Optional: per-name version; sets `changed`
+ * @returns One MemioBufferInfo per name, in order
+ */
+export async function memioInfoMany(
+  bufferNames: string[],
+  lastVersions?: (bigint | undefined)[]
+): Promise<MemioBufferInfo[]> {
+  const results = await invoke<
+    { name: string; exists: boolean; changed: boolean; version: number; length: number; capacity: number }[]
+  >('plugin:memio|memio_info_many', {
+    bufferNames,
+    lastVersions: lastVersions?.map(v => (v === undefined ? null : Number(v))) ?? null,
+  });
+
+  return results.map(result => ({ ...result, version: BigInt(result.version) }));
+}
+
 /**
  * Write data to memio buffer.
  * 
@@ -217,8 +260,8 @@ export async function memioUploadFile(
 async function readLinux(bufferName: string, lastVersion?: bigint): Promise<MemioReadResult | null> {
   // Linux uses WebKit extension injected memioSharedBuffer
   if (typeof window.memioSharedBuffer !== 'function') {
-    console.error('[Memio] Linux: memioSharedBuffer not available');
-    return null;
+    console.warn('[Memio] Linux: memioSharedBuffer not available, streaming over IPC');
+    return readChannelStream(bufferName, lastVersion);
   }
   
   const buffer = window.memioSharedBuffer(bufferName);
@@ -250,6 +293,21 @@ async function readLinux(bufferName: string, lastVersion?: bigint): Promise<Memi
   };
 }
 
+async function readChannelStream(bufferName: string, lastVersion?: bigint): Promise<MemioReadResult | null> {
+  // Fallback: raw binary chunks over a Tauri channel into reusable storage
+  const result = await readSharedStateChannelStream(bufferName, lastVersion);
+  if (!result) {
+    return null;
+  }
+
+  return {
+    data: result.view.bytes,
+    version: result.version,
+    length: result.length,
+    view: result.view,
+  };
+}
+
 async function readAndroid(bufferName: string, lastVersion?: bigint): Promise<MemioReadResult | null> {
   // Android uses memio:// protocol
   const result = await readSharedStateAndroidMemioProtocol(bufferName, lastVersion);
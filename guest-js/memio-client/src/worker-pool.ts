@@ -0,0 +1,458 @@
+/**
+ * MemioWorkerPool - decode/transform memio buffers off the UI thread.
+ *
+ * Transforms are registered by name inside the worker script (functions
+ * cannot cross `postMessage`); the pool only sends a name and params:
+ *
+ * ```typescript
+ * // decode.worker.ts
+ * import { registerMemioTransform, serveMemioTransforms } from 'memio-client';
+ * registerMemioTransform('sum', (view, scratch) => { ... });
+ * serveMemioTransforms();
+ *
+ * // main thread
+ * const pool = new MemioWorkerPool({
+ *   createWorker: () => new Worker(new URL('./decode.worker.ts', import.meta.url), { type: 'module' }),
+ * });
+ * const result = await pool.run('state', 'sum');
+ * use(result.bytes());
+ * result.release();
+ * ```
+ *
+ * Buffers only ever move, never copy, between threads:
+ *
+ * ```
+ * main:   region ──copy──▶ input ──transfer──▶ worker
+ * worker: transform(input, scratch) ──▶ output
+ * worker: input + output ──transfer──▶ main
+ * main:   input → pool; output → caller; release() → pool → next scratch
+ * ```
+ *
+ * Each worker has at most two inputs and two outputs in flight or idle
+ * (double buffering), so steady state allocates no ArrayBuffers. On Linux
+ * the region is copied straight from shared memory into the pooled input
+ * via `memioReadInto`.
+ */
+
+import { StateView } from './state-view';
+import { memioRead } from './unified';
+import { hasLinuxReadInto, readLinuxSharedBufferInto } from './platform/linux';
+
+const MESSAGE_TYPE = 'memio-transform';
+/** Smallest pooled buffer; sizes grow in powers of two from here. */
+const MIN_POOLED_BYTES = 64 * 1024;
+/** Idle buffers kept per worker, per direction. */
+const BUFFERS_PER_WORKER = 2;
+
+/** Output of a transform: `byteLength` bytes at the start of `buffer`. */
+export interface MemioTransformOutput {
+  buffer: ArrayBuffer;
+  byteLength: number;
+}
+
+/**
+ * A transform run inside a worker.
+ *
+ * `scratch` is a recycled output buffer (or null); reuse it when it is large
+ * enough. Must not return `input`'s own buffer.
+ */
+export type MemioTransform<P = unknown> = (
+  input: StateView,
+  scratch: ArrayBuffer | null,
+  params: P
+) => MemioTransformOutput;
+
+/** Result of `MemioWorkerPool.run`. */
+export interface MemioWorkerResult {
+  /** Region version the transform ran on */
+  version: bigint;
+  /** Transform output; owned by the caller until `release()` */
+  buffer: ArrayBuffer;
+  /** Valid bytes at the start of `buffer` */
+  byteLength: number;
+  /** Returns `buffer` trimmed to `byteLength` (no copy). */
+  bytes(): Uint8Array;
+  /** Hands `buffer` back to the pool; do not use it afterwards. */
+  release(): void;
+}
+
+export interface MemioWorkerPoolOptions {
+  /** Creates one worker running `serveMemioTransforms()` */
+  createWorker: () => Worker;
+  /** Number of workers (default: min(4, hardwareConcurrency - 1), at least 1) */
+  size?: number;
+}
+
+interface TransformRequest {
+  type: typeof MESSAGE_TYPE;
+  id: number;
+  transform: string;
+  params: unknown;
+  length: number;
+  input: ArrayBuffer;
+  scratch: ArrayBuffer | null;
+}
+
+interface TransformResponse {
+  type: typeof MESSAGE_TYPE;
+  id: number;
+  input: ArrayBuffer;
+  output: ArrayBuffer | null;
+  byteLength: number;
+  /** Scratch buffer the transform did not use */
+  spare: ArrayBuffer | null;
+  error?: string;
+}
+
+interface PendingRun {
+  slot: WorkerSlot;
+  version: bigint;
+  resolve: (result: MemioWorkerResult) => void;
+  reject: (error: Error) => void;
+}
+
+interface WorkerSlot {
+  worker: Worker;
+  inFlight: number;
+}
+
+// ===== Worker side =====
+
+const transforms = new Map<string, MemioTransform<any>>();
+
+/**
+ * Registers a transform by name. Call in the worker script.
+ */
+export function registerMemioTransform<P>(name: string, transform: MemioTransform<P>): void {
+  transforms.set(name, transform);
+}
+
+/** Minimal view of `DedicatedWorkerGlobalScope` (not part of the DOM lib). */
+export interface MemioWorkerScope {
+  addEventListener(type: 'message', listener: (event: MessageEvent) => void): void;
+  postMessage(message: unknown, transfer: Transferable[]): void;
+}
+
+/**
+ * Answers `MemioWorkerPool` requests. Call once in the worker script, after
+ * registering transforms.
+ */
+export function serveMemioTransforms(
+  scope: MemioWorkerScope = globalThis as unknown as MemioWorkerScope
+): void {
+  scope.addEventListener('message', (event: MessageEvent) => {
+    const request = event.data as TransformRequest;
+    if (!request || request.type !== MESSAGE_TYPE) {
+      return;
+    }
+
+    const response: TransformResponse = {
+      type: MESSAGE_TYPE,
+      id: request.id,
+      input: request.input,
+      output: null,
+      byteLength: 0,
+      spare: request.scratch,
+    };
+    try {
+      const transform = transforms.get(request.transform);
+      if (!transform) {
+        throw new Error(`Unknown memio transform: ${request.transform}`);
+      }
+      const view = new StateView(new Uint8Array(request.input, 0, request.length));
+      const output = transform(view, request.scratch, request.params);
+      if (output.buffer === request.input) {
+        throw new Error(`Transform ${request.transform} returned its input buffer`);
+      }
+      response.output = output.buffer;
+      response.byteLength = output.byteLength;
+      if (output.buffer === request.scratch) {
+        response.spare = null;
+      }
+    } catch (e) {
+      response.error = e instanceof Error ? e.message : String(e);
+    }
+
+    const transfer: Transferable[] = [response.input];
+    if (response.output) transfer.push(response.output);
+    if (response.spare) transfer.push(response.spare);
+    scope.postMessage(response, transfer);
+  });
+}
+
+// ===== Main-thread side =====
+
+/**
+ * Pool of workers running registered transforms on memio buffers.
+ */
+export class MemioWorkerPool {
+  private readonly slots: WorkerSlot[] = [];
+  private readonly pending = new Map<number, PendingRun>();
+  private readonly freeInputs: ArrayBuffer[] = [];
+  private readonly freeOutputs: ArrayBuffer[] = [];
+  private nextId = 1;
+
+  constructor(options: MemioWorkerPoolOptions) {
+    const cores = typeof navigator !== 'undefined' ? navigator.hardwareConcurrency ?? 2 : 2;
+    const size = Math.max(1, options.size ?? Math.min(4, cores - 1));
+    for (let i = 0; i < size; i++) {
+      const slot: WorkerSlot = { worker: options.createWorker(), inFlight: 0 };
+      slot.worker.addEventListener('message', event => this.onMessage(event));
+      slot.worker.addEventListener('error', event => this.onWorkerError(slot, event));
+      this.slots.push(slot);
+    }
+  }
+
+  /**
+   * Reads `bufferName` and runs `transform` on it in the least busy worker.
+   *
+   * Resolves null if the region is unavailable or its version still equals
+   * `lastVersion`. Call `release()` on the result once done with it.
+   */
+  async run<P = unknown>(
+    bufferName: string,
+    transform: string,
+    params?: P,
+    lastVersion?: bigint
+  ): Promise<MemioWorkerResult | null> {
+    const staged = await this.stage(bufferName, lastVersion);
+    if (!staged) {
+      return null;
+    }
+
+    const slot = this.slots.reduce((a, b) => (b.inFlight < a.inFlight ? b : a));
+    const id = this.nextId++;
+    const scratch = this.freeOutputs.pop() ?? null;
+    const request: TransformRequest = {
+      type: MESSAGE_TYPE,
+      id,
+      transform,
+      params,
+      length: staged.length,
+      input: staged.input,
+      scratch,
+    };
+
+    return new Promise((resolve, reject) => {
+      this.pending.set(id, { slot, version: staged.version, resolve, reject });
+      slot.inFlight++;
+      slot.worker.postMessage(request, scratch ? [staged.input, scratch] : [staged.input]);
+    });
+  }
+
+  /**
+   * Terminates all workers and rejects runs still in flight.
+   */
+  terminate(): void {
+    for (const slot of this.slots) {
+      slot.worker.terminate();
+    }
+    for (const run of this.pending.values()) {
+      run.reject(new Error('MemioWorkerPool terminated'));
+    }
+    this.pending.clear();
+    this.slots.length = 0;
+    this.freeInputs.length = 0;
+    this.freeOutputs.length = 0;
+  }
+
+  /** Copies the region into a pooled input buffer. */
+  private async stage(
+    bufferName: string,
+    lastVersion?: bigint
+  ): Promise<{ input: ArrayBuffer; length: number; version: bigint } | null> {
+    if (hasLinuxReadInto()) {
+      let input = this.takeInput(0);
+      for (let attempt = 0; attempt < 2; attempt++) {
+        const result = readLinuxSharedBufferInto(bufferName, input, 0, { lastVersion });
+        if (!result || result.copied < result.length) {
+          this.recycle(this.freeInputs, input);
+          if (!result || (result.copied === 0 && lastVersion !== undefined)) {
+            return null;
+          }
+          // Too small: retry once with a buffer that fits
+          input = this.takeInput(result.length);
+          continue;
+        }
+        return { input, length: result.length, version: BigInt(result.version) };
+      }
+      this.recycle(this.freeInputs, input);
+      return null;
+    }
+
+    const result = await memioRead(bufferName, lastVersion);
+    if (!result) {
+      return null;
+    }
+    const input = this.takeInput(result.length);
+    new Uint8Array(input, 0, result.length).set(result.data.subarray(0, result.length));
+    return { input, length: result.length, version: result.version };
+  }
+
+  /** Smallest idle input of at least `size` bytes, or a new power-of-two one. */
+  private takeInput(size: number): ArrayBuffer {
+    let best = -1;
+    for (let i = 0; i < this.freeInputs.length; i++) {
+      const length = this.freeInputs[i].byteLength;
+      if (length >= size && (best < 0 || length < this.freeInputs[best].byteLength)) {
+        best = i;
+      }
+    }
+    if (best >= 0) {
+      return this.freeInputs.splice(best, 1)[0];
+    }
+    let capacity = MIN_POOLED_BYTES;
+    while (capacity < size) {
+      capacity *= 2;
+    }
+    return new ArrayBuffer(capacity);
+  }
+
+  /** Returns a buffer to a free list, keeping the largest ones. */
+  private recycle(list: ArrayBuffer[], buffer: ArrayBuffer): void {
+    if (buffer.byteLength === 0) {
+      return; // detached
+    }
+    list.push(buffer);
+    if (list.length > this.slots.length * BUFFERS_PER_WORKER) {
+      let smallest = 0;
+      for (let i = 1; i < list.length; i++) {
+        if (list[i].byteLength < list[smallest].byteLength) {
+          smallest = i;
+        }
+      }
+      list.splice(smallest, 1);
+    }
+  }
+
+  private onMessage(event: MessageEvent): void {
+    const response = event.data as TransformResponse;
+    if (!response || response.type !== MESSAGE_TYPE) {
+      return;
+    }
+    const run = this.pending.get(response.id);
+    if (!run) {
+      return;
+    }
+    this.pending.delete(response.id);
+    run.slot.inFlight--;
+
+    this.recycle(this.freeInputs, response.input);
+    if (response.spare) {
+      this.recycle(this.freeOutputs, response.spare);
+    }
+    if (response.error || !response.output) {
+      run.reject(new Error(response.error ?? 'Transform returned no output'));
+      return;
+    }
+
+    const output = response.output;
+    let released = false;
+    run.resolve({
+      version: run.version,
+      buffer: output,
+      byteLength: response.byteLength,
+      bytes: () => new Uint8Array(output, 0, response.byteLength),
+      release: () => {
+        if (!released) {
+          released = true;
+          this.recycle(this.freeOutputs, output);
+        }
+      },
+    });
+  }
+
+  private onWorkerError(slot: WorkerSlot, event: ErrorEvent): void {
+    // Runs already posted to a crashed worker never answer
+    for (const [id, run] of this.pending) {
+      if (run.slot === slot) {
+        this.pending.delete(id);
+        run.reject(new Error(`Memio worker failed: ${event.message}`));
+      }
+    }
+    slot.inFlight = 0;
+  }
+}
+
+// ===== Built-in transforms =====
+
+/** Name of the built-in schema-driven column extraction transform. */
+export const MEMIO_COLUMNS_TRANSFORM = 'memio.columns';
+
+export type MemioColumnType = 'u8' | 'i8' | 'u16' | 'i16' | 'u32' | 'i32' | 'f32' | 'f64';
+
+/** Fixed-size record schema for `memio.columns`. */
+export interface MemioColumnsParams {
+  /** Byte offset of the first record (default 0) */
+  start?: number;
+  /** Bytes per record */
+  recordSize: number;
+  /** Records to read (default: as many as fit) */
+  count?: number;
+  /** Fields to extract, each into its own packed column */
+  columns: { offset: number; type: MemioColumnType }[];
+}
+
+const COLUMN_SIZES: Record<MemioColumnType, number> = {
+  u8: 1, i8: 1, u16: 2, i16: 2, u32: 4, i32: 4, f32: 4, f64: 8,
+};
+
+/** Column offsets in a `memio.columns` output; each column is 8-byte aligned. */
+function columnLayout(params: MemioColumnsParams, count: number): { offsets: number[]; byteLength: number } {
+  const offsets: number[] = [];
+  let cursor = 8; // [count u32][reserved u32]
+  for (const column of params.columns) {
+    offsets.push(cursor);
+    cursor += Math.ceil((count * COLUMN_SIZES[column.type]) / 8) * 8;
+  }
+  return { offsets, byteLength: cursor };
+}
+
+/**
+ * Extracts fields of fixed-size records into packed little-endian columns.
+ *
+ * Output: `[count u32][reserved u32]` followed by one 8-byte aligned column
+ * per entry of `params.columns`; read it with `memioColumnViews`.
+ */
+export const memioColumnsTransform: MemioTransform<MemioColumnsParams> = (input, scratch, params) => {
+  const start = params.start ?? 0;
+  const fit = Math.max(0, Math.floor((input.byteLength - start) / params.recordSize));
+  const count = Math.min(params.count ?? fit, fit);
+  const layout = columnLayout(params, count);
+  const buffer = scratch && scratch.byteLength >= layout.byteLength ? scratch : new ArrayBuffer(layout.byteLength);
+  const out = new DataView(buffer);
+  out.setUint32(0, count, true);
+  out.setUint32(4, 0, true);
+
+  params.columns.forEach((column, c) => {
+    let src = start + column.offset;
+    let dst = layout.offsets[c];
+    const size = COLUMN_SIZES[column.type];
+    for (let i = 0; i < count; i++, src += params.recordSize, dst += size) {
+      switch (column.type) {
+        case 'u8': out.setUint8(dst, input.readU8(src)); break;
+        case 'i8': out.setInt8(dst, input.readI8(src)); break;
+        case 'u16': out.setUint16(dst, input.readU16(src), true); break;
+        case 'i16': out.setInt16(dst, input.readI16(src), true); break;
+        case 'u32': out.setUint32(dst, input.readU32(src), true); break;
+        case 'i32': out.setInt32(dst, input.readI32(src), true); break;
+        case 'f32': out.setFloat32(dst, input.readF32(src), true); break;
+        case 'f64': out.setFloat64(dst, input.readF64(src), true); break;
+      }
+    }
+  });
+  return { buffer, byteLength: layout.byteLength };
+};
+
+registerMemioTransform(MEMIO_COLUMNS_TRANSFORM, memioColumnsTransform);
+
+/**
+ * Returns a `StateView` per column of a `memio.columns` result (no copy).
+ */
+export function memioColumnViews(result: MemioWorkerResult, params: MemioColumnsParams): StateView[] {
+  const count = new DataView(result.buffer).getUint32(0, true);
+  const layout = columnLayout(params, count);
+  return params.columns.map(
+    (column, c) => new StateView(new Uint8Array(result.buffer, layout.offsets[c], count * COLUMN_SIZES[column.type]))
+  );
+}
@@ -0,0 +1,273 @@
+/**
+ * Worker-side consumers - one SharedArrayBuffer mirror shared by many workers.
+ *
+ * The main thread reads a region once and republishes it into a
+ * `SharedStateMirror`. Workers attach to its `handle` (posted with
+ * `postMessage`, which shares rather than copies) and decode straight from
+ * the shared bytes. Requires a cross-origin isolated context
+ * (`crossOriginIsolated === true`); check `hasSharedArrayBufferSupport()`.
+ *
+ * Layout:
+ *
+ * ```
+ * control: Int32Array [sequence]         even = stable, odd = publish in progress
+ * data:    [header: 64 bytes (magic, version, length)] [payload]
+ * ```
+ *
+ * `data` uses the regular region header, so `readSharedState` and
+ * `StateView` work on it unchanged. `sequence` is a seqlock and doubles as
+ * the word workers sleep on with `Atomics.waitAsync`.
+ */
+
+import { readSharedState, writeSharedStateBuffer } from './shared-state';
+import { SHARED_STATE_HEADER_SIZE } from './shared-state-spec';
+import type { SharedStateSnapshot } from './shared-types';
+
+const SEQUENCE_INDEX = 0;
+const CONTROL_WORDS = 1;
+/** Re-read attempts when a publish races a read. */
+const READ_RETRIES = 8;
+/** Poll interval when `Atomics.waitAsync` is unavailable. */
+const FALLBACK_POLL_MS = 4;
+
+/** Structured-cloneable pair of buffers a worker attaches to. */
+export interface SharedStateHandle {
+  control: SharedArrayBuffer;
+  data: SharedArrayBuffer;
+}
+
+/** Snapshot read from a mirror; valid while `isCurrent()` holds. */
+export interface SharedStateWorkerSnapshot extends SharedStateSnapshot {
+  /** Mirror sequence the bytes were read under */
+  sequence: number;
+}
+
+export type SharedWaitResult = 'ok' | 'not-equal' | 'timed-out';
+
+type WaitAsyncResult =
+  | { async: false; value: 'not-equal' | 'timed-out' }
+  | { async: true; value: Promise<'ok' | 'timed-out'> };
+
+type AtomicsWithWaitAsync = typeof Atomics & {
+  waitAsync?: (
+    typedArray: Int32Array,
+    index: number,
+    value: number,
+    timeout?: number
+  ) => WaitAsyncResult;
+};
+
+/**
+ * Returns true if SharedArrayBuffer can be created and shared with workers.
+ */
+export function hasSharedArrayBufferSupport(): boolean {
+  if (typeof SharedArrayBuffer === 'undefined' || typeof Atomics === 'undefined') {
+    return false;
+  }
+  const isolated = (globalThis as unknown as { crossOriginIsolated?: boolean }).crossOriginIsolated;
+  return isolated !== false;
+}
+
+/**
+ * Returns true if `Atomics.waitAsync` is available (no polling fallback).
+ */
+export function hasAtomicsWaitAsync(): boolean {
+  return typeof (Atomics as AtomicsWithWaitAsync).waitAsync === 'function';
+}
+
+/**
+ * Waits until `words[index]` differs from `expected` or the timeout elapses.
+ *
+ * Uses `Atomics.waitAsync`, so it is safe on the main thread and never
+ * blocks a worker's event loop. Falls back to polling where it is missing.
+ */
+export async function waitForSharedWord(
+  words: Int32Array,
+  index: number,
+  expected: number,
+  timeoutMs?: number
+): Promise<SharedWaitResult> {
+  const atomics = Atomics as AtomicsWithWaitAsync;
+  if (atomics.waitAsync) {
+    const result = atomics.waitAsync(words, index, expected, timeoutMs ?? Infinity);
+    return result.async ? await result.value : result.value;
+  }
+
+  const deadline = timeoutMs === undefined ? Infinity : Date.now() + timeoutMs;
+  while (Atomics.load(words, index) === expected) {
+    if (Date.now() >= deadline) {
+      return 'timed-out';
+    }
+    await new Promise(resolve => setTimeout(resolve, FALLBACK_POLL_MS));
+  }
+  return 'ok';
+}
+
+/**
+ * Main-thread owner of a SharedArrayBuffer copy of one region.
+ *
+ * @example
+ * ```typescript
+ * const mirror = new SharedStateMirror(1024 * 1024);
+ * worker.postMessage(mirror.handle);
+ *
+ * const snapshot = memio.shared(lastVersion);
+ * if (snapshot) mirror.publishSnapshot(snapshot); // one copy, all workers
+ * ```
+ */
+export class SharedStateMirror {
+  private readonly control: Int32Array;
+  private readonly bytes: Uint8Array;
+  readonly handle: SharedStateHandle;
+
+  /**
+   * Allocates a mirror for payloads up to `capacity` bytes.
+   */
+  constructor(capacity: number) {
+    if (typeof SharedArrayBuffer === 'undefined') {
+      throw new TypeError("SharedArrayBuffer is not available (cross-origin isolation required).");
+    }
+    const control = new SharedArrayBuffer(CONTROL_WORDS * Int32Array.BYTES_PER_ELEMENT);
+    const data = new SharedArrayBuffer(SHARED_STATE_HEADER_SIZE + capacity);
+    this.control = new Int32Array(control);
+    this.bytes = new Uint8Array(data);
+    this.handle = { control, data };
+  }
+
+  /**
+   * Returns the payload capacity in bytes.
+   */
+  get capacity(): number {
+    return this.bytes.byteLength - SHARED_STATE_HEADER_SIZE;
+  }
+
+  /**
+   * Copies `data` into the mirror and wakes every waiting worker.
+   *
+   * Returns false if the payload exceeds the capacity.
+   */
+  publish(data: ArrayBuffer | Uint8Array, version: bigint): boolean {
+    const length = data.byteLength;
+    if (length > this.capacity) {
+      return false;
+    }
+
+    // Odd sequence: readers that overlap this copy retry
+    Atomics.add(this.control, SEQUENCE_INDEX, 1);
+    writeSharedStateBuffer(this.bytes, data, version);
+    Atomics.add(this.control, SEQUENCE_INDEX, 1);
+    Atomics.notify(this.control, SEQUENCE_INDEX);
+    return true;
+  }
+
+  /**
+   * Publishes a snapshot read from any platform backend.
+   */
+  publishSnapshot(snapshot: SharedStateSnapshot): boolean {
+    return this.publish(snapshot.view.bytes, snapshot.version);
+  }
+}
+
+/**
+ * Worker-side view of a `SharedStateMirror`.
+ *
+ * Snapshots are zero-copy `StateView`s over the shared bytes. A publish can
+ * overwrite them while a worker decodes, so check `isCurrent(snapshot)`
+ * after decoding and discard the result if it returns false.
+ *
+ * @example
+ * ```typescript
+ * self.onmessage = async (event) => {
+ *   const view = attachSharedState(event.data);
+ *   let last: bigint | undefined;
+ *   for (;;) {
+ *     const snapshot = await view.next(last);
+ *     if (!snapshot) continue;
+ *     const decoded = decode(snapshot.view);
+ *     if (view.isCurrent(snapshot)) postMessage(decoded);
+ *     last = snapshot.version;
+ *   }
+ * };
+ * ```
+ */
+export class SharedStateWorkerView {
+  private readonly control: Int32Array;
+  private readonly bytes: Uint8Array;
+
+  constructor(handle: SharedStateHandle) {
+    this.control = new Int32Array(handle.control);
+    this.bytes = new Uint8Array(handle.data);
+  }
+
+  /**
+   * Returns the current mirror sequence (changes on every publish).
+   */
+  get sequence(): number {
+    return Atomics.load(this.control, SEQUENCE_INDEX);
+  }
+
+  /**
+   * Reads the current snapshot.
+   *
+   * Returns null if nothing was published yet, the version still equals
+   * `lastVersion`, or a publish kept racing the read.
+   */
+  read(lastVersion?: bigint): SharedStateWorkerSnapshot | null {
+    for (let attempt = 0; attempt < READ_RETRIES; attempt++) {
+      const sequence = Atomics.load(this.control, SEQUENCE_INDEX);
+      if (sequence & 1) {
+        continue;
+      }
+      const snapshot = readSharedState(this.bytes, lastVersion);
+      if (Atomics.load(this.control, SEQUENCE_INDEX) === sequence) {
+        return snapshot ? { ...snapshot, sequence } : null;
+      }
+    }
+    return null;
+  }
+
+  /**
+   * Returns true if no publish happened since `snapshot` was read.
+   */
+  isCurrent(snapshot: SharedStateWorkerSnapshot): boolean {
+    return Atomics.load(this.control, SEQUENCE_INDEX) === snapshot.sequence;
+  }
+
+  /**
+   * Resolves with the first snapshot whose version differs from `lastVersion`.
+   *
+   * Sleeps on the sequence word via `Atomics.waitAsync` between publishes.
+   * Resolves null once `timeoutMs` elapses without a new version.
+   */
+  async next(lastVersion?: bigint, timeoutMs?: number): Promise<SharedStateWorkerSnapshot | null> {
+    const deadline = timeoutMs === undefined ? Infinity : Date.now() + timeoutMs;
+    for (;;) {
+      const seen = Atomics.load(this.control, SEQUENCE_INDEX);
+      const snapshot = this.read(lastVersion);
+      if (snapshot) {
+        return snapshot;
+      }
+
+      const remaining = deadline - Date.now();
+      if (remaining <= 0) {
+        return null;
+      }
+      const result = await waitForSharedWord(
+        this.control,
+        SEQUENCE_INDEX,
+        seen,
+        remaining === Infinity ? undefined : remaining
+      );
+      if (result === 'timed-out') {
+        return null;
+      }
+    }
+  }
+}
+
+/**
+ * Attaches a worker to a mirror handle received via `postMessage`.
+ */
+export function attachSharedState(handle: SharedStateHandle): SharedStateWorkerView {
+  return new SharedStateWorkerView(handle);
+}
@@ -4,6 +4,14 @@ const { resolve } = require("node:path");
 const root = resolve(__dirname, "..");
 const specPath = resolve(root, "shared", "shared_state_spec.json");
 const spec = JSON.parse(readFileSync(specPath, "utf-8"));
+const heapSpecPath = resolve(root, "shared", "shared_heap_spec.json");
+const heapSpec = JSON.parse(readFileSync(heapSpecPath, "utf-8"));
+const doorbellSpecPath = resolve(root, "shared", "shared_doorbell_spec.json");
+const doorbellSpec = JSON.parse(readFileSync(doorbellSpecPath, "utf-8"));
+const rpcSpecPath = resolve(root, "shared", "shared_rpc_spec.json");
+const rpcSpec = JSON.parse(readFileSync(rpcSpecPath, "utf-8"));
+const broadcastSpecPath = resolve(root, "shared", "shared_broadcast_spec.json");
+const broadcastSpec = JSON.parse(readFileSync(broadcastSpecPath, "utf-8"));
 
 // Rust module (also generated by memio-core/build.rs at compile time)
 const rustModule = `// Generated from shared/shared_state_spec.json. Do not edit by hand.
@@ -12,6 +20,9 @@ pub const SHARED_STATE_HEADER_SIZE: usize = ${spec.header_size};
 pub const SHARED_STATE_MAGIC_OFFSET: usize = ${spec.offsets.magic};
 pub const SHARED_STATE_VERSION_OFFSET: usize = ${spec.offsets.version};
 pub const SHARED_STATE_LENGTH_OFFSET: usize = ${spec.offsets.length};
+pub const SHARED_STATE_HISTORY_OFFSET: usize = ${spec.offsets.history};
+pub const SHARED_STATE_ACK_OFFSET: usize = ${spec.offsets.ack};
+pub const SHARED_STATE_SEQ_OFFSET: usize = ${spec.offsets.seq};
 pub const SHARED_STATE_ENDIANNESS: &str = "${spec.endianness}";
 `;
 
@@ -22,9 +33,113 @@ export const SHARED_STATE_HEADER_SIZE = ${spec.header_size};
 export const SHARED_STATE_MAGIC_OFFSET = ${spec.offsets.magic};
 export const SHARED_STATE_VERSION_OFFSET = ${spec.offsets.version};
 export const SHARED_STATE_LENGTH_OFFSET = ${spec.offsets.length};
+export const SHARED_STATE_HISTORY_OFFSET = ${spec.offsets.history};
+export const SHARED_STATE_ACK_OFFSET = ${spec.offsets.ack};
+export const SHARED_STATE_SEQ_OFFSET = ${spec.offsets.seq};
 export const SHARED_STATE_ENDIANNESS = "${spec.endianness}" as const;
 `;
 
+// Rust module for the multi-object heap layout
+const rustHeapModule = `// Generated from shared/shared_heap_spec.json. Do not edit by hand.
+pub const SHARED_HEAP_MAGIC: u64 = ${heapSpec.magic_hex};
+pub const SHARED_HEAP_HEADER_SIZE: usize = ${heapSpec.header_size};
+pub const SHARED_HEAP_CAPACITY_OFFSET: usize = ${heapSpec.offsets.capacity};
+pub const SHARED_HEAP_GENERATION_OFFSET: usize = ${heapSpec.offsets.generation};
+pub const SHARED_HEAP_BUMP_OFFSET: usize = ${heapSpec.offsets.bump};
+pub const SHARED_HEAP_DIR_OFFSET_OFFSET: usize = ${heapSpec.offsets.dir_offset};
+pub const SHARED_HEAP_DIR_SLOTS_OFFSET: usize = ${heapSpec.offsets.dir_slots};
+pub const SHARED_HEAP_FREE_OFFSET_OFFSET: usize = ${heapSpec.offsets.free_offset};
+pub const SHARED_HEAP_ARENA_OFFSET_OFFSET: usize = ${heapSpec.offsets.arena_offset};
+pub const SHARED_HEAP_ENTRY_SIZE: usize = ${heapSpec.entry_size};
+pub const SHARED_HEAP_ENTRY_STATE_OFFSET: usize = ${heapSpec.entry_offsets.state};
+pub const SHARED_HEAP_ENTRY_NAME_LEN_OFFSET: usize = ${heapSpec.entry_offsets.name_len};
+pub const SHARED_HEAP_ENTRY_OFFSET_OFFSET: usize = ${heapSpec.entry_offsets.offset};
+pub const SHARED_HEAP_ENTRY_LENGTH_OFFSET: usize = ${heapSpec.entry_offsets.length};
+pub const SHARED_HEAP_ENTRY_CAPACITY_OFFSET: usize = ${heapSpec.entry_offsets.capacity};
+pub const SHARED_HEAP_ENTRY_VERSION_OFFSET: usize = ${heapSpec.entry_offsets.version};
+pub const SHARED_HEAP_ENTRY_SEQ_OFFSET: usize = ${heapSpec.entry_offsets.seq};
+pub const SHARED_HEAP_ENTRY_NAME_OFFSET: usize = ${heapSpec.entry_offsets.name};
+pub const SHARED_HEAP_NAME_MAX: usize = ${heapSpec.name_max};
+pub const SHARED_HEAP_MIN_BLOCK: usize = ${heapSpec.min_block};
+pub const SHARED_HEAP_SIZE_CLASSES: usize = ${heapSpec.size_classes};
+`;
+
+// TypeScript module for the multi-object heap layout
+const tsHeapModule = `// Generated from shared/shared_heap_spec.json. Do not edit by hand.
+export const SHARED_HEAP_MAGIC = ${heapSpec.magic_hex}n;
+export const SHARED_HEAP_HEADER_SIZE = ${heapSpec.header_size};
+export const SHARED_HEAP_GENERATION_OFFSET = ${heapSpec.offsets.generation};
+export const SHARED_HEAP_DIR_OFFSET_OFFSET = ${heapSpec.offsets.dir_offset};
+export const SHARED_HEAP_DIR_SLOTS_OFFSET = ${heapSpec.offsets.dir_slots};
+export const SHARED_HEAP_ENTRY_SIZE = ${heapSpec.entry_size};
+export const SHARED_HEAP_ENTRY_STATE_OFFSET = ${heapSpec.entry_offsets.state};
+export const SHARED_HEAP_ENTRY_NAME_LEN_OFFSET = ${heapSpec.entry_offsets.name_len};
+export const SHARED_HEAP_ENTRY_OFFSET_OFFSET = ${heapSpec.entry_offsets.offset};
+export const SHARED_HEAP_ENTRY_LENGTH_OFFSET = ${heapSpec.entry_offsets.length};
+export const SHARED_HEAP_ENTRY_VERSION_OFFSET = ${heapSpec.entry_offsets.version};
+export const SHARED_HEAP_ENTRY_SEQ_OFFSET = ${heapSpec.entry_offsets.seq};
+export const SHARED_HEAP_ENTRY_NAME_OFFSET = ${heapSpec.entry_offsets.name};
+`;
+
+// Rust module for the change-notification doorbell
+const rustDoorbellModule = `// Generated from shared/shared_doorbell_spec.json. Do not edit by hand.
+pub const SHARED_DOORBELL_MAGIC: u64 = ${doorbellSpec.magic_hex};
+pub const SHARED_DOORBELL_SIZE: usize = ${doorbellSpec.size};
+pub const SHARED_DOORBELL_MAGIC_OFFSET: usize = ${doorbellSpec.offsets.magic};
+pub const SHARED_DOORBELL_SEQUENCE_OFFSET: usize = ${doorbellSpec.offsets.sequence};
+pub const SHARED_DOORBELL_WAITERS_OFFSET: usize = ${doorbellSpec.offsets.waiters};
+`;
+
+// Rust module for shared rings and the RPC frame layout
+const rustRpcModule = `// Generated from shared/shared_rpc_spec.json. Do not edit by hand.
+pub const SHARED_RING_MAGIC: u64 = ${rpcSpec.ring.magic_hex};
+pub const SHARED_RING_HEADER_SIZE: usize = ${rpcSpec.ring.header_size};
+pub const SHARED_RING_MAGIC_OFFSET: usize = ${rpcSpec.ring.offsets.magic};
+pub const SHARED_RING_CAPACITY_OFFSET: usize = ${rpcSpec.ring.offsets.capacity};
+pub const SHARED_RING_HEAD_OFFSET: usize = ${rpcSpec.ring.offsets.head};
+pub const SHARED_RING_TAIL_OFFSET: usize = ${rpcSpec.ring.offsets.tail};
+pub const RPC_FRAME_HEADER_SIZE: usize = ${rpcSpec.frame.header_size};
+pub const RPC_FRAME_LENGTH_OFFSET: usize = ${rpcSpec.frame.offsets.length};
+pub const RPC_FRAME_CORRELATION_OFFSET: usize = ${rpcSpec.frame.offsets.correlation};
+pub const RPC_FRAME_METHOD_OFFSET: usize = ${rpcSpec.frame.offsets.method};
+pub const RPC_FRAME_FLAGS_OFFSET: usize = ${rpcSpec.frame.offsets.flags};
+pub const RPC_FLAG_RESPONSE: u32 = ${rpcSpec.frame.flags.response};
+pub const RPC_FLAG_ERROR: u32 = ${rpcSpec.frame.flags.error};
+`;
+
+// Rust module for the multi-consumer broadcast ring
+const rustBroadcastModule = `// Generated from shared/shared_broadcast_spec.json. Do not edit by hand.
+pub const BROADCAST_MAGIC: u64 = ${broadcastSpec.magic_hex};
+pub const BROADCAST_HEADER_SIZE: usize = ${broadcastSpec.header_size};
+pub const BROADCAST_MAGIC_OFFSET: usize = ${broadcastSpec.offsets.magic};
+pub const BROADCAST_CAPACITY_OFFSET: usize = ${broadcastSpec.offsets.capacity};
+pub const BROADCAST_HEAD_OFFSET: usize = ${broadcastSpec.offsets.head};
+pub const BROADCAST_TAIL_OFFSET: usize = ${broadcastSpec.offsets.tail};
+pub const BROADCAST_SLOTS_OFFSET: usize = ${broadcastSpec.offsets.slots};
+pub const BROADCAST_DATA_OFFSET: usize = ${broadcastSpec.offsets.data};
+pub const BROADCAST_SLOT_SIZE: usize = ${broadcastSpec.slot.size};
+pub const BROADCAST_SLOT_OWNER_OFFSET: usize = ${broadcastSpec.slot.offsets.owner};
+pub const BROADCAST_SLOT_CURSOR_OFFSET: usize = ${broadcastSpec.slot.offsets.cursor};
+pub const BROADCAST_SLOT_HEARTBEAT_OFFSET: usize = ${broadcastSpec.slot.offsets.heartbeat};
+pub const BROADCAST_RECORD_HEADER_SIZE: usize = ${broadcastSpec.record.header_size};
+`;
+
+// TypeScript module for broadcast ring records
+const tsBroadcastModule = `// Generated from shared/shared_broadcast_spec.json. Do not edit by hand.
+export const BROADCAST_RECORD_HEADER_SIZE = ${broadcastSpec.record.header_size};
+`;
+
+// TypeScript module for the RPC frame layout
+const tsRpcModule = `// Generated from shared/shared_rpc_spec.json. Do not edit by hand.
+export const RPC_FRAME_HEADER_SIZE = ${rpcSpec.frame.header_size};
+export const RPC_FRAME_LENGTH_OFFSET = ${rpcSpec.frame.offsets.length};
+export const RPC_FRAME_CORRELATION_OFFSET = ${rpcSpec.frame.offsets.correlation};
+export const RPC_FRAME_METHOD_OFFSET = ${rpcSpec.frame.offsets.method};
+export const RPC_FRAME_FLAGS_OFFSET = ${rpcSpec.frame.offsets.flags};
+export const RPC_FLAG_RESPONSE = ${rpcSpec.frame.flags.response};
+export const RPC_FLAG_ERROR = ${rpcSpec.frame.flags.error};
+`;
+
 // C header for WebKit extension
 const cHeader = `// Generated from shared/shared_state_spec.json. Do not edit by hand.
 // This header ensures the WebKit extension uses the same constants as Rust.
@@ -39,6 +154,53 @@ const cHeader = `// Generated from shared/shared_state_spec.json. Do not edit by
 #define MEMIO_MAGIC_OFFSET ${spec.offsets.magic}
 #define MEMIO_VERSION_OFFSET ${spec.offsets.version}
 #define MEMIO_LENGTH_OFFSET ${spec.offsets.length}
+#define MEMIO_HISTORY_OFFSET ${spec.offsets.history}
+#define MEMIO_ACK_OFFSET ${spec.offsets.ack}
+#define MEMIO_SEQ_OFFSET ${spec.offsets.seq}
+
+// Multi-object heap layout (shared/shared_heap_spec.json)
+#define MEMIO_HEAP_MAGIC ${heapSpec.magic_hex}ULL
+#define MEMIO_HEAP_HEADER_SIZE ${heapSpec.header_size}
+#define MEMIO_HEAP_GENERATION_OFFSET ${heapSpec.offsets.generation}
+#define MEMIO_HEAP_DIR_OFFSET_OFFSET ${heapSpec.offsets.dir_offset}
+#define MEMIO_HEAP_DIR_SLOTS_OFFSET ${heapSpec.offsets.dir_slots}
+#define MEMIO_HEAP_ENTRY_SIZE ${heapSpec.entry_size}
+#define MEMIO_HEAP_ENTRY_STATE_OFFSET ${heapSpec.entry_offsets.state}
+#define MEMIO_HEAP_ENTRY_NAME_LEN_OFFSET ${heapSpec.entry_offsets.name_len}
+#define MEMIO_HEAP_ENTRY_OFFSET_OFFSET ${heapSpec.entry_offsets.offset}
+#define MEMIO_HEAP_ENTRY_LENGTH_OFFSET ${heapSpec.entry_offsets.length}
+#define MEMIO_HEAP_ENTRY_VERSION_OFFSET ${heapSpec.entry_offsets.version}
+#define MEMIO_HEAP_ENTRY_SEQ_OFFSET ${heapSpec.entry_offsets.seq}
+#define MEMIO_HEAP_ENTRY_NAME_OFFSET ${heapSpec.entry_offsets.name}
+#define MEMIO_HEAP_NAME_MAX ${heapSpec.name_max}
+
+// Change-notification doorbell (shared/shared_doorbell_spec.json)
+#define MEMIO_DOORBELL_MAGIC ${doorbellSpec.magic_hex}ULL
+#define MEMIO_DOORBELL_SIZE ${doorbellSpec.size}
+#define MEMIO_DOORBELL_SEQUENCE_OFFSET ${doorbellSpec.offsets.sequence}
+#define MEMIO_DOORBELL_WAITERS_OFFSET ${doorbellSpec.offsets.waiters}
+
+// Shared rings and RPC frames (shared/shared_rpc_spec.json)
+#define MEMIO_RING_MAGIC ${rpcSpec.ring.magic_hex}ULL
+#define MEMIO_RING_HEADER_SIZE ${rpcSpec.ring.header_size}
+#define MEMIO_RING_CAPACITY_OFFSET ${rpcSpec.ring.offsets.capacity}
+#define MEMIO_RING_HEAD_OFFSET ${rpcSpec.ring.offsets.head}
+#define MEMIO_RING_TAIL_OFFSET ${rpcSpec.ring.offsets.tail}
+#define MEMIO_RPC_FRAME_HEADER_SIZE ${rpcSpec.frame.header_size}
+#define MEMIO_RPC_FRAME_LENGTH_OFFSET ${rpcSpec.frame.offsets.length}
+
+// Multi-consumer broadcast rings (shared/shared_broadcast_spec.json)
+#define MEMIO_BCAST_MAGIC ${broadcastSpec.magic_hex}ULL
+#define MEMIO_BCAST_HEADER_SIZE ${broadcastSpec.header_size}
+#define MEMIO_BCAST_CAPACITY_OFFSET ${broadcastSpec.offsets.capacity}
+#define MEMIO_BCAST_HEAD_OFFSET ${broadcastSpec.offsets.head}
+#define MEMIO_BCAST_SLOTS_OFFSET ${broadcastSpec.offsets.slots}
+#define MEMIO_BCAST_DATA_OFFSET ${broadcastSpec.offsets.data}
+#define MEMIO_BCAST_SLOT_SIZE ${broadcastSpec.slot.size}
+#define MEMIO_BCAST_SLOT_OWNER_OFFSET ${broadcastSpec.slot.offsets.owner}
+#define MEMIO_BCAST_SLOT_CURSOR_OFFSET ${broadcastSpec.slot.offsets.cursor}
+#define MEMIO_BCAST_SLOT_HEARTBEAT_OFFSET ${broadcastSpec.slot.offsets.heartbeat}
+#define MEMIO_BCAST_RECORD_HEADER_SIZE ${broadcastSpec.record.header_size}
 
 // Endianness: ${spec.endianness}
 // Multi-byte values are stored in ${spec.endianness}-endian format
@@ -58,6 +220,8 @@ object MemioSpec {
     const val MAGIC_OFFSET: Int = ${spec.offsets.magic}
     const val VERSION_OFFSET: Int = ${spec.offsets.version}
     const val LENGTH_OFFSET: Int = ${spec.offsets.length}
+    const val ACK_OFFSET: Int = ${spec.offsets.ack}
+    const val SEQ_OFFSET: Int = ${spec.offsets.seq}
     const val ENDIANNESS: String = "${spec.endianness}"
 }
 `;
@@ -73,10 +237,38 @@ writeFileSync(
   resolve(root, "crates", "memio-core", "src", "shared_state_spec.rs"),
   rustModule
 );
+writeFileSync(
+  resolve(root, "crates", "memio-core", "src", "shared_heap_spec.rs"),
+  rustHeapModule
+);
+writeFileSync(
+  resolve(root, "crates", "memio-core", "src", "shared_doorbell_spec.rs"),
+  rustDoorbellModule
+);
+writeFileSync(
+  resolve(root, "crates", "memio-core", "src", "shared_rpc_spec.rs"),
+  rustRpcModule
+);
+writeFileSync(
+  resolve(root, "crates", "memio-core", "src", "shared_broadcast_spec.rs"),
+  rustBroadcastModule
+);
 writeFileSync(
   resolve(root, "guest-js", "memio-client", "src", "shared-state-spec.ts"),
   tsModule
 );
+writeFileSync(
+  resolve(root, "guest-js", "memio-client", "src", "shared-heap-spec.ts"),
+  tsHeapModule
+);
+writeFileSync(
+  resolve(root, "guest-js", "memio-client", "src", "shared-rpc-spec.ts"),
+  tsRpcModule
+);
+writeFileSync(
+  resolve(root, "guest-js", "memio-client", "src", "shared-broadcast-spec.ts"),
+  tsBroadcastModule
+);
 writeFileSync(
   resolve(root, "guest-js", "memio-client", "src", "shared-manifest-spec.ts"),
   manifestTsModule
@@ -91,7 +283,14 @@ writeFileSync(
 );
 console.log("✅ Generated shared state spec files:");
 console.log("   - crates/memio-core/src/shared_state_spec.rs");
+console.log("   - crates/memio-core/src/shared_heap_spec.rs");
+console.log("   - crates/memio-core/src/shared_doorbell_spec.rs");
+console.log("   - crates/memio-core/src/shared_rpc_spec.rs");
+console.log("   - crates/memio-core/src/shared_broadcast_spec.rs");
 console.log("   - guest-js/memio-client/src/shared-state-spec.ts");
+console.log("   - guest-js/memio-client/src/shared-heap-spec.ts");
+console.log("   - guest-js/memio-client/src/shared-rpc-spec.ts");
+console.log("   - guest-js/memio-client/src/shared-broadcast-spec.ts");
 console.log("   - guest-js/memio-client/src/shared-manifest-spec.ts");
 console.log("   - extensions/webkit-linux/memio_spec.h");
 console.log("   - android/.../spec/MemioSpec.kt");
@@ -62,9 +62,14 @@ globalThis.__memioSharedDebug = function() {
       // fall through
     }
   }
+  // Linux extension counters (JS evaluations, copies, bytes copied)
+  const stats = globalThis.__memioExtensionStats ? globalThis.__memioExtensionStats() : {};
   return {
     has: !!globalThis.__memioSharedBuffers,
-    keys: globalThis.__memioSharedBuffers ? Object.keys(globalThis.__memioSharedBuffers) : []
+    keys: globalThis.__memioSharedBuffers ? Object.keys(globalThis.__memioSharedBuffers) : [],
+    evaluations: stats.evaluations,
+    copies: stats.copies,
+    bytesCopied: stats.bytesCopied
   };
 };
 
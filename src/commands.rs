@@ -3,12 +3,29 @@
 //! These commands provide a unified API for:
 //! - `memio_upload`: Upload file from URI/path to memio region
 //! - `memio_read`: Read data from memio buffer
+//! - `memio_read_many` / `memio_info_many`: Header-only status of many buffers
+//! - `memio_stream`: Stream buffer contents through an IPC channel
+//! - `memio_rpc_open`: Open a shared-memory RPC channel (Linux)
+//! - `memio_rpc_batch`: Dispatch a batch of binary RPC frames over IPC
+//! - `memio_broadcast_open`: Locate a broadcast ring to attach to (Linux)
 //!
 //! The implementation uses the correct platform-specific method.
 
 use serde::{Deserialize, Serialize};
+use tauri::ipc::{Channel, InvokeResponseBody};
 use tauri::{command, AppHandle, Manager, Runtime};
 
+/// Default chunk size for `memio_stream`.
+const STREAM_CHUNK_SIZE: usize = 1024 * 1024;
+
+/// Lower bound for `memio_stream` chunks; smaller chunks cost more in
+/// per-message overhead than they save in latency.
+const STREAM_MIN_CHUNK_SIZE: usize = 64 * 1024;
+
+/// Default ring size for `memio_rpc_open`, per direction.
+#[cfg_attr(not(target_os = "linux"), allow(dead_code))]
+const RPC_RING_CAPACITY: usize = 1024 * 1024;
+
 #[derive(Serialize, Deserialize)]
 #[serde(rename_all = "camelCase")]
 pub struct UploadResult {
@@ -26,6 +43,53 @@ pub struct ReadResult {
     pub length: usize,
 }
 
+/// Header-only status of one buffer, as returned by `memio_info_many`.
+#[derive(Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+pub struct InfoResult {
+    pub name: String,
+    /// False if no buffer of that name exists (the other fields are 0)
+    pub exists: bool,
+    /// True if `version` is newer than the caller's `lastVersion`
+    pub changed: bool,
+    pub version: i64,
+    pub length: usize,
+    pub capacity: usize,
+}
+
+#[derive(Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+pub struct StreamResult {
+    pub success: bool,
+    pub version: i64,
+    pub length: usize,
+    pub chunks: usize,
+}
+
+#[derive(Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+pub struct RpcOpenResult {
+    pub request_ring: String,
+    pub response_ring: String,
+    pub capacity: usize,
+}
+
+#[derive(Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+pub struct BroadcastOpenResult {
+    pub path: String,
+    pub capacity: usize,
+    pub slots: usize,
+}
+
+/// Open RPC channels, one per webview; reopening replaces (and stops) the
+/// previous channel of that webview, e.g. after a reload.
+#[cfg(target_os = "linux")]
+#[derive(Default)]
+pub(crate) struct RpcChannels(
+    std::sync::Mutex<std::collections::HashMap<String, memio_platform::RpcChannel>>,
+);
+
 /// Upload a file to memio buffer.
 ///
 /// # Arguments
@@ -111,24 +175,322 @@ pub fn memio_read<R: Runtime>(
         .try_state::<std::sync::Arc<MemioManager>>()
         .ok_or("MemioManager not available")?;
 
-    let result = manager
-        .read(&bufferName)
+    // Header only: the frontend reads the payload itself
+    let info = manager
+        .info(&bufferName)
         .map_err(|e| format!("Failed to read from shared memory: {:?}", e))?;
 
+    Ok(read_result(info.version, info.length, lastVersion))
+}
+
+/// `memio_read` answer for a header, honouring `last_version`.
+fn read_result(version: u64, length: usize, last_version: Option<i64>) -> ReadResult {
     // Check if version changed
+    let changed = last_version.is_none_or(|last| version as i64 > last);
+    ReadResult {
+        success: changed,
+        version: version as i64,
+        length: if changed { length } else { 0 },
+    }
+}
+
+/// `lastVersion` for entry `index` of a batch (missing entries mean "none").
+fn last_version_at(last_versions: &Option<Vec<Option<i64>>>, index: usize) -> Option<i64> {
+    last_versions
+        .as_ref()
+        .and_then(|versions| versions.get(index).copied().flatten())
+}
+
+/// `memio_read` for many buffers in one IPC round trip.
+///
+/// Header-only: no payload is copied. Fails if any buffer is missing, like
+/// `memio_read`; use `memio_info_many` to tolerate missing buffers.
+///
+/// # Arguments
+/// - `buffer_names`: Names of the memio buffers
+/// - `last_versions`: Optional - per-name version to compare against
+///
+/// # Returns
+/// One ReadResult per name, in order.
+#[command]
+pub fn memio_read_many<R: Runtime>(
+    app: AppHandle<R>,
+    #[allow(non_snake_case)] bufferNames: Vec<String>,
+    #[allow(non_snake_case)] lastVersions: Option<Vec<Option<i64>>>,
+) -> Result<Vec<ReadResult>, String> {
+    use memio_platform::MemioManager;
+
+    let manager = app
+        .try_state::<std::sync::Arc<MemioManager>>()
+        .ok_or("MemioManager not available")?;
+
+    let infos = manager
+        .info_many(&bufferNames)
+        .map_err(|e| format!("Failed to read from shared memory: {:?}", e))?;
+
+    infos
+        .into_iter()
+        .enumerate()
+        .map(|(index, info)| {
+            let info = info.map_err(|e| format!("Failed to read from shared memory: {:?}", e))?;
+            Ok(read_result(
+                info.version,
+                info.length,
+                last_version_at(&lastVersions, index),
+            ))
+        })
+        .collect()
+}
+
+/// Header-only status of many buffers in one IPC round trip.
+///
+/// Meant for status polling: nothing is copied and missing buffers are
+/// reported with `exists: false` instead of failing the batch.
+///
+/// # Arguments
+/// - `buffer_names`: Names of the memio buffers
+/// - `last_versions`: Optional - per-name version; sets `changed`
+///
+/// # Returns
+/// One InfoResult per name, in order.
+#[command]
+pub fn memio_info_many<R: Runtime>(
+    app: AppHandle<R>,
+    #[allow(non_snake_case)] bufferNames: Vec<String>,
+    #[allow(non_snake_case)] lastVersions: Option<Vec<Option<i64>>>,
+) -> Result<Vec<InfoResult>, String> {
+    use memio_platform::MemioManager;
+
+    let manager = app
+        .try_state::<std::sync::Arc<MemioManager>>()
+        .ok_or("MemioManager not available")?;
+
+    let infos = manager
+        .info_many(&bufferNames)
+        .map_err(|e| format!("Failed to read from shared memory: {:?}", e))?;
+
+    Ok(bufferNames
+        .into_iter()
+        .zip(infos)
+        .enumerate()
+        .map(|(index, (name, info))| match info {
+            Ok(info) => InfoResult {
+                name,
+                exists: true,
+                changed: last_version_at(&lastVersions, index)
+                    .is_none_or(|last| info.version as i64 > last),
+                version: info.version as i64,
+                length: info.length,
+                capacity: info.capacity,
+            },
+            Err(_) => InfoResult {
+                name,
+                exists: false,
+                changed: false,
+                version: 0,
+                length: 0,
+                capacity: 0,
+            },
+        })
+        .collect())
+}
+
+/// Stream memio buffer contents to the frontend through an IPC channel.
+///
+/// Fallback data path for webviews without direct memory access (e.g. the
+/// WebKit extension failed to load). The payload travels as raw binary
+/// channel messages, never as JSON or Base64:
+///
+/// 1. A 64-byte header in the shared-state layout (magic, version, length).
+/// 2. The payload, in order, in chunks of at most `chunk_size` bytes.
+///
+/// The chunks are read from a snapshot, so they always belong to the
+/// version announced in the header even if the writer publishes meanwhile.
+///
+/// # Arguments
+/// - `buffer_name`: Name of the memio buffer
+/// - `last_version`: Optional - send nothing if version hasn't changed
+/// - `chunk_size`: Optional - bytes per message (default 1 MiB)
+/// - `on_chunk`: Channel receiving the header and payload chunks
+#[command]
+pub async fn memio_stream<R: Runtime>(
+    app: AppHandle<R>,
+    #[allow(non_snake_case)] bufferName: String,
+    #[allow(non_snake_case)] lastVersion: Option<i64>,
+    #[allow(non_snake_case)] chunkSize: Option<usize>,
+    #[allow(non_snake_case)] onChunk: Channel<InvokeResponseBody>,
+) -> Result<StreamResult, String> {
+    use memio_core::SHARED_STATE_HEADER_SIZE;
+    use memio_platform::MemioManager;
+
+    let manager = app
+        .try_state::<std::sync::Arc<MemioManager>>()
+        .ok_or("MemioManager not available")?;
+
+    let snapshot = manager
+        .snapshot(&bufferName)
+        .map_err(|e| format!("Failed to read from shared memory: {:?}", e))?;
+    let version = snapshot.version();
+    let length = snapshot.len();
+
     if let Some(last) = lastVersion {
-        if result.version as i64 <= last {
-            return Ok(ReadResult {
+        if version as i64 <= last {
+            return Ok(StreamResult {
                 success: false,
-                version: result.version as i64,
+                version: version as i64,
                 length: 0,
+                chunks: 0,
             });
         }
     }
 
-    Ok(ReadResult {
+    let send = |bytes: Vec<u8>| {
+        onChunk
+            .send(InvokeResponseBody::Raw(bytes))
+            .map_err(|e| format!("Failed to send chunk: {}", e))
+    };
+
+    let mut header = vec![0u8; SHARED_STATE_HEADER_SIZE];
+    memio_core::write_header(&mut header, version, length).map_err(|e| e.to_string())?;
+    send(header)?;
+
+    let chunk_size = chunkSize
+        .unwrap_or(STREAM_CHUNK_SIZE)
+        .max(STREAM_MIN_CHUNK_SIZE);
+    let mut chunks = 0;
+    let mut offset = 0;
+    while offset < length {
+        let n = chunk_size.min(length - offset);
+        let mut chunk = vec![0u8; n];
+        snapshot
+            .read_at(offset, &mut chunk)
+            .map_err(|e| format!("Failed to read from shared memory: {:?}", e))?;
+        send(chunk)?;
+        offset += n;
+        chunks += 1;
+    }
+    // Delivered: lets on-demand writers publish their next version
+    let _ = manager.ack(&bufferName, version);
+
+    Ok(StreamResult {
         success: true,
-        version: result.version as i64,
-        length: result.data.len(),
+        version: version as i64,
+        length,
+        chunks,
     })
 }
+
+/// Open a shared-memory RPC channel for the calling webview (Linux).
+///
+/// Creates a request ring (JS → Rust) and a response ring (Rust → JS) of
+/// `capacity` bytes each, served by the app's `Arc<RpcDispatcher>`. The
+/// frontend writes and reads them through the WebKit extension; the
+/// doorbell signals new frames in both directions.
+///
+/// # Arguments
+/// - `capacity`: Optional - bytes per ring (default 1 MiB)
+#[command]
+pub fn memio_rpc_open<R: Runtime>(
+    app: AppHandle<R>,
+    webview: tauri::Webview<R>,
+    capacity: Option<usize>,
+) -> Result<RpcOpenResult, String> {
+    #[cfg(target_os = "linux")]
+    {
+        use memio_platform::{MemioManager, RpcChannel, RpcDispatcher};
+
+        let dispatcher = app
+            .try_state::<std::sync::Arc<RpcDispatcher>>()
+            .ok_or("RpcDispatcher not available")?;
+        let doorbell = app
+            .try_state::<std::sync::Arc<MemioManager>>()
+            .and_then(|manager| manager.doorbell());
+        let capacity = capacity.unwrap_or(RPC_RING_CAPACITY);
+
+        let channel = RpcChannel::open(dispatcher.inner().clone(), capacity, doorbell)
+            .map_err(|e| format!("Failed to open rpc channel: {:?}", e))?;
+        let result = RpcOpenResult {
+            request_ring: channel.request_path().to_string_lossy().into_owned(),
+            response_ring: channel.response_path().to_string_lossy().into_owned(),
+            capacity,
+        };
+
+        let channels = app
+            .try_state::<RpcChannels>()
+            .ok_or("RPC channels not available")?;
+        let mut channels = channels
+            .0
+            .lock()
+            .map_err(|e| format!("RPC channels lock poisoned: {}", e))?;
+        channels.insert(webview.label().to_string(), channel);
+        Ok(result)
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    {
+        let _ = (app, webview, capacity);
+        Err("memio_rpc_open requires Linux; use memio_rpc_batch".to_string())
+    }
+}
+
+/// Dispatch a batch of binary RPC frames.
+///
+/// Fallback transport for `MemioRpcClient` where the shared rings are not
+/// available. The request body is raw frames (no JSON); the response is
+/// the matching response frames.
+#[command]
+pub fn memio_rpc_batch<R: Runtime>(
+    app: AppHandle<R>,
+    request: tauri::ipc::Request<'_>,
+) -> Result<tauri::ipc::Response, String> {
+    use memio_platform::RpcDispatcher;
+
+    let tauri::ipc::InvokeBody::Raw(frames) = request.body() else {
+        return Err("memio_rpc_batch expects a raw binary body".to_string());
+    };
+    let dispatcher = app
+        .try_state::<std::sync::Arc<RpcDispatcher>>()
+        .ok_or("RpcDispatcher not available")?;
+
+    let mut output = Vec::new();
+    dispatcher
+        .dispatch(frames, &mut output)
+        .map_err(|e| format!("Failed to dispatch rpc frames: {:?}", e))?;
+    Ok(tauri::ipc::Response::new(output))
+}
+
+/// Locate a broadcast ring created with `MemioManager::create_broadcast` (Linux).
+///
+/// The frontend attaches to the returned path through the WebKit extension,
+/// which claims a reader slot; the ring itself never goes through IPC.
+///
+/// # Arguments
+/// - `name`: Name the ring was created under
+#[command]
+pub fn memio_broadcast_open<R: Runtime>(
+    app: AppHandle<R>,
+    name: String,
+) -> Result<BroadcastOpenResult, String> {
+    #[cfg(target_os = "linux")]
+    {
+        use memio_platform::MemioManager;
+
+        let manager = app
+            .try_state::<std::sync::Arc<MemioManager>>()
+            .ok_or("MemioManager not available")?;
+        let ring = manager
+            .broadcast(&name)
+            .map_err(|e| format!("Broadcast '{}' not found: {:?}", name, e))?;
+        Ok(BroadcastOpenResult {
+            path: ring.path().to_string_lossy().into_owned(),
+            capacity: ring.capacity(),
+            slots: ring.slots(),
+        })
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    {
+        let _ = (app, name);
+        Err("memio_broadcast_open requires Linux".to_string())
+    }
+}
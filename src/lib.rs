@@ -6,13 +6,19 @@ use tauri::Runtime;
 pub mod android;
 #[cfg(target_os = "linux")]
 mod linux;
+#[cfg(target_os = "linux")]
+mod protocol;
 #[cfg(target_os = "windows")]
 pub mod windows;
 #[cfg(target_os = "windows")]
 pub mod windows_shared_buffer;
 
 mod commands;
-pub use commands::{memio_read, memio_upload, ReadResult, UploadResult};
+pub use commands::{
+    memio_broadcast_open, memio_info_many, memio_read, memio_read_many, memio_rpc_batch,
+    memio_rpc_open, memio_stream, memio_upload, BroadcastOpenResult, InfoResult, ReadResult,
+    RpcOpenResult, StreamResult, UploadResult,
+};
 
 /// Initializes the Memio plugin.
 pub fn init<R: Runtime>() -> TauriPlugin<R> {
@@ -39,6 +45,7 @@ pub fn init<R: Runtime>() -> TauriPlugin<R> {
             }
             #[cfg(target_os = "linux")]
             {
+                app.manage(commands::RpcChannels::default());
                 if let Err(err) = linux::replace_webview_windows_with_extensions(app) {
                     eprintln!("Memio WebKit extension window update failed: {:?}", err);
                 }
@@ -52,6 +59,12 @@ pub fn init<R: Runtime>() -> TauriPlugin<R> {
         .invoke_handler(tauri::generate_handler![
             commands::memio_upload,
             commands::memio_read,
+            commands::memio_read_many,
+            commands::memio_info_many,
+            commands::memio_stream,
+            commands::memio_rpc_open,
+            commands::memio_rpc_batch,
+            commands::memio_broadcast_open,
             // Windows SharedBuffer API
             #[cfg(target_os = "windows")]
             windows::prepare_upload_buffer,
@@ -72,6 +85,10 @@ pub fn init<R: Runtime>() -> TauriPlugin<R> {
             windows::has_shared_buffer,
         ]);
 
+    // memio:// scheme: ranged reads straight from the region (Linux).
+    #[cfg(target_os = "linux")]
+    let builder = builder.register_uri_scheme_protocol(protocol::MEMIO_SCHEME, protocol::handle);
+
     builder.build()
 }
 
@@ -0,0 +1,253 @@
+//! `memio://` URI scheme for Linux webviews.
+//!
+//! Serves memio regions over the webview's custom-scheme loader, mirroring
+//! the Android `memio://buffer/<name>` protocol:
+//!
+//! - `Range: bytes=a-b` returns `206 Partial Content` with just that slice
+//! - `ETag` is the region version; `If-None-Match` returns `304 Not Modified`
+//! - `X-Memio-Version` / `X-Memio-Length` carry the header fields, so the
+//!   body is the payload only
+//! - `HEAD` returns the headers without a body
+//!
+//! Bytes are copied from a region snapshot, so a response never mixes two
+//! versions, and only the requested range is copied.
+
+use std::ops::Range;
+use std::sync::Arc;
+
+use memio_platform::MemioManager;
+use tauri::http::{header, Method, Request, Response, StatusCode};
+use tauri::{Manager, Runtime, UriSchemeContext};
+
+/// Scheme name registered with the webview.
+pub const MEMIO_SCHEME: &str = "memio";
+
+/// Headers JS may read on a cross-origin `memio://` response.
+const EXPOSED_HEADERS: &str =
+    "X-Memio-Version, X-Memio-Length, ETag, Content-Range, Content-Length, Accept-Ranges";
+
+/// Handles a `memio://buffer/<name>` request.
+pub fn handle<R: Runtime>(
+    ctx: UriSchemeContext<'_, R>,
+    request: Request<Vec<u8>>,
+) -> Response<Vec<u8>> {
+    if request.method() == Method::OPTIONS {
+        return preflight();
+    }
+    if request.method() != Method::GET && request.method() != Method::HEAD {
+        return error(StatusCode::METHOD_NOT_ALLOWED, "Only GET and HEAD are supported");
+    }
+
+    let Some(manager) = ctx.app_handle().try_state::<Arc<MemioManager>>() else {
+        return error(StatusCode::SERVICE_UNAVAILABLE, "MemioManager not available");
+    };
+
+    let Some(name) = buffer_name(request.uri().path()) else {
+        return error(StatusCode::BAD_REQUEST, "Expected memio://buffer/<name>");
+    };
+
+    let snapshot = match manager.snapshot(&name) {
+        Ok(snapshot) => snapshot,
+        Err(e) => return error(StatusCode::NOT_FOUND, &format!("{:?}", e)),
+    };
+    let version = snapshot.version();
+    let length = snapshot.len();
+    let etag = format!("\"{}\"", version);
+
+    let base = || {
+        Response::builder()
+            .header(header::ACCESS_CONTROL_ALLOW_ORIGIN, "*")
+            .header(header::ACCESS_CONTROL_EXPOSE_HEADERS, EXPOSED_HEADERS)
+            .header(header::CACHE_CONTROL, "no-cache")
+            .header(header::ETAG, etag.as_str())
+            .header(header::ACCEPT_RANGES, "bytes")
+            .header("X-Memio-Version", version.to_string())
+            .header("X-Memio-Length", length.to_string())
+    };
+
+    let not_modified = request
+        .headers()
+        .get(header::IF_NONE_MATCH)
+        .and_then(|v| v.to_str().ok())
+        .is_some_and(|v| v.split(',').any(|tag| tag.trim() == etag || tag.trim() == "*"));
+    if not_modified {
+        // The page already holds this version: counts as consumed
+        let _ = manager.ack(&name, version);
+        return base()
+            .status(StatusCode::NOT_MODIFIED)
+            .body(Vec::new())
+            .unwrap_or_default();
+    }
+
+    let range = match request
+        .headers()
+        .get(header::RANGE)
+        .and_then(|v| v.to_str().ok())
+    {
+        None => None,
+        Some(spec) => match parse_range(spec, length) {
+            Some(range) => Some(range),
+            None => {
+                return base()
+                    .status(StatusCode::RANGE_NOT_SATISFIABLE)
+                    .header(header::CONTENT_RANGE, format!("bytes */{}", length))
+                    .body(Vec::new())
+                    .unwrap_or_default();
+            }
+        },
+    };
+
+    let (status, span) = match &range {
+        Some(r) => (StatusCode::PARTIAL_CONTENT, r.clone()),
+        None => (StatusCode::OK, 0..length),
+    };
+
+    let mut response = base()
+        .status(status)
+        .header(header::CONTENT_TYPE, "application/octet-stream")
+        .header(header::CONTENT_LENGTH, span.len().to_string());
+    if range.is_some() {
+        response = response.header(
+            header::CONTENT_RANGE,
+            format!("bytes {}-{}/{}", span.start, span.end - 1, length),
+        );
+    }
+
+    let mut body = Vec::new();
+    if request.method() == Method::GET {
+        body.resize(span.len(), 0);
+        if let Err(e) = snapshot.read_at(span.start, &mut body) {
+            return error(StatusCode::INTERNAL_SERVER_ERROR, &format!("{:?}", e));
+        }
+        // Lets on-demand writers (PublishPolicy::OnDemand) publish again
+        let _ = manager.ack(&name, version);
+    }
+
+    response.body(body).unwrap_or_default()
+}
+
+/// Extracts `<name>` from `/<name>` (`memio://buffer/<name>`), undoing the
+/// percent-encoding JS applies (`encodeURIComponent`), so names holding
+/// `/`, spaces or non-ASCII characters resolve.
+fn buffer_name(path: &str) -> Option<String> {
+    let name = path.trim_matches('/');
+    if name.is_empty() || name.contains('/') {
+        return None;
+    }
+    percent_decode(name)
+}
+
+/// Decodes `%XX` escapes. Returns `None` for a malformed escape or when the
+/// decoded bytes are not UTF-8.
+fn percent_decode(segment: &str) -> Option<String> {
+    let bytes = segment.as_bytes();
+    let mut decoded = Vec::with_capacity(bytes.len());
+    let mut i = 0;
+    while i < bytes.len() {
+        if bytes[i] == b'%' {
+            let hex = bytes.get(i + 1..i + 3)?;
+            if !hex.iter().all(u8::is_ascii_hexdigit) {
+                return None;
+            }
+            let hex = std::str::from_utf8(hex).ok()?;
+            decoded.push(u8::from_str_radix(hex, 16).ok()?);
+            i += 3;
+        } else {
+            decoded.push(bytes[i]);
+            i += 1;
+        }
+    }
+    String::from_utf8(decoded).ok()
+}
+
+/// Parses a single-range `Range` header against a payload of `length` bytes.
+///
+/// Supports `bytes=a-b`, `bytes=a-` and suffix ranges `bytes=-n`. Returns
+/// `None` for unsatisfiable or multi-range requests.
+fn parse_range(spec: &str, length: usize) -> Option<Range<usize>> {
+    let spec = spec.trim().strip_prefix("bytes=")?;
+    if spec.contains(',') {
+        return None;
+    }
+    let (start, end) = spec.split_once('-')?;
+    let (start, end) = (start.trim(), end.trim());
+
+    let range = if start.is_empty() {
+        let suffix: usize = end.parse().ok()?;
+        length.saturating_sub(suffix)..length
+    } else {
+        let start: usize = start.parse().ok()?;
+        let end = if end.is_empty() {
+            length
+        } else {
+            end.parse::<usize>().ok()?.saturating_add(1).min(length)
+        };
+        start..end
+    };
+
+    (range.start < range.end).then_some(range)
+}
+
+fn preflight() -> Response<Vec<u8>> {
+    Response::builder()
+        .status(StatusCode::NO_CONTENT)
+        .header(header::ACCESS_CONTROL_ALLOW_ORIGIN, "*")
+        .header(header::ACCESS_CONTROL_ALLOW_METHODS, "GET, HEAD, OPTIONS")
+        .header(header::ACCESS_CONTROL_ALLOW_HEADERS, "Range, If-None-Match")
+        .body(Vec::new())
+        .unwrap_or_default()
+}
+
+fn error(status: StatusCode, message: &str) -> Response<Vec<u8>> {
+    Response::builder()
+        .status(status)
+        .header(header::ACCESS_CONTROL_ALLOW_ORIGIN, "*")
+        .header(header::CONTENT_TYPE, "text/plain")
+        .body(message.as_bytes().to_vec())
+        .unwrap_or_default()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_buffer_name_decodes_percent_escapes() {
+        assert_eq!(buffer_name("/state").as_deref(), Some("state"));
+        assert_eq!(buffer_name("/state/").as_deref(), Some("state"));
+        // encodeURIComponent("world/1"), ("a b"), ("café")
+        assert_eq!(buffer_name("/world%2F1").as_deref(), Some("world/1"));
+        assert_eq!(buffer_name("/a%20b").as_deref(), Some("a b"));
+        assert_eq!(buffer_name("/caf%C3%A9").as_deref(), Some("café"));
+
+        assert_eq!(buffer_name("/"), None);
+        assert_eq!(buffer_name("/a/b"), None);
+        assert_eq!(buffer_name("/bad%2"), None);
+        assert_eq!(buffer_name("/bad%zz"), None);
+        assert_eq!(buffer_name("/%+1"), None);
+        assert_eq!(buffer_name("/%FF"), None);
+    }
+
+    #[test]
+    fn test_parse_range() {
+        assert_eq!(parse_range("bytes=0-9", 100), Some(0..10));
+        assert_eq!(parse_range(" bytes=10-10 ", 100), Some(10..11));
+        // Open-ended and suffix ranges
+        assert_eq!(parse_range("bytes=90-", 100), Some(90..100));
+        assert_eq!(parse_range("bytes=-10", 100), Some(90..100));
+        assert_eq!(parse_range("bytes=-200", 100), Some(0..100));
+        // An end past the payload is clamped
+        assert_eq!(parse_range("bytes=95-200", 100), Some(95..100));
+
+        // Unsatisfiable
+        assert_eq!(parse_range("bytes=100-", 100), None);
+        assert_eq!(parse_range("bytes=100-200", 100), None);
+        assert_eq!(parse_range("bytes=5-2", 100), None);
+        assert_eq!(parse_range("bytes=-0", 100), None);
+        assert_eq!(parse_range("bytes=0-", 0), None);
+        // Unsupported or malformed
+        assert_eq!(parse_range("bytes=0-1,4-5", 100), None);
+        assert_eq!(parse_range("items=0-9", 100), None);
+        assert_eq!(parse_range("bytes=a-9", 100), None);
+    }
+}